@@ -41,6 +41,8 @@
 #ifndef MCLS_EPETRAHELPERS_HPP
 #define MCLS_EPETRAHELPERS_HPP
 
+#include <algorithm>
+
 #include <MCLS_DBC.hpp>
 
 #include <Teuchos_RCP.hpp>
@@ -214,85 +216,73 @@ class EpetraMatrixHelpers<Epetra_RowMatrix>
     /*
      * \brief Create a reference-counted pointer to a new matrix with a
      * specified number of off-process nearest-neighbor global rows.
+     *
+     * The graph is traversed one level at a time. Only the rows new to each
+     * level are exported to find the next level and the rows already found
+     * are removed with a sorted set difference. All neighbor rows are
+     * exported together once the traversal is complete.
      */
     static Teuchos::RCP<matrix_type> copyNearestNeighbors( 
     	const matrix_type& matrix, const int& num_neighbors )
     { 
 	MCLS_REQUIRE( num_neighbors >= 0 ); 
 
-	// Setup for neighbor construction.
-	Teuchos::RCP<const Epetra_Map> empty_map = Teuchos::rcp(
-	    new Epetra_Map( 0, 0, matrix.Comm() ) );
-	Teuchos::RCP<Epetra_CrsMatrix> neighbor_matrix = 
-	    Teuchos::rcp( new Epetra_CrsMatrix( Copy, *empty_map, 0 ) );
-	MCLS_CHECK_ERROR_CODE(
-	    neighbor_matrix->FillComplete() 
-	    );
+	// The sorted global rows already found. These are the local rows of
+	// the matrix and the neighbor rows.
+	Teuchos::Array<int> found_rows( 
+	    matrix.RowMatrixRowMap().MyGlobalElements(),
+	    matrix.RowMatrixRowMap().MyGlobalElements() + 
+	    matrix.RowMatrixRowMap().NumMyElements() );
+	std::sort( found_rows.begin(), found_rows.end() );
 
-	Teuchos::ArrayView<const int> global_rows;
-	Teuchos::ArrayView<const int>::const_iterator global_rows_it;
-	Teuchos::Array<int>::iterator ghost_global_bound;
+	// The sorted neighbor rows.
+	Teuchos::Array<int> neighbor_rows;
 
-	// Get the initial off proc columns.
-	Teuchos::Array<int> ghost_global_rows = getOffProcColsAsRows( matrix );
+	// Get the initial off proc columns. These are the first level.
+	Teuchos::Array<int> level_rows = getOffProcColsAsRows( matrix );
+	Teuchos::Array<int> work;
+	Teuchos::Array<int>::iterator work_end;
 
 	// Build the neighbors by traversing the graph.
 	for ( int i = 0; i < num_neighbors; ++i )
 	{
-	    // Get rid of the global rows that belong to the original
-	    // matrix. We don't need to store these, just the neighbors.
-	    global_rows = Teuchos::ArrayView<const int>( 
-		matrix.RowMatrixRowMap().MyGlobalElements(),
-		matrix.RowMatrixRowMap().NumMyElements() );
-	    for ( global_rows_it = global_rows.begin();
-		  global_rows_it != global_rows.end();
-		  ++global_rows_it )
-	    {
-		ghost_global_bound = std::remove( ghost_global_rows.begin(), 
-						  ghost_global_rows.end(), 
-						  *global_rows_it );
-		ghost_global_rows.resize( std::distance(ghost_global_rows.begin(),
-							ghost_global_bound) );
-	    }
-
-	    // Get the current set of global rows in the neighbor matrix. 
-	    global_rows = Teuchos::ArrayView<const int>( 
-		neighbor_matrix->RowMatrixRowMap().MyGlobalElements(),
-		neighbor_matrix->RowMatrixRowMap().NumMyElements() );
-
-	    // Append the on proc neighbor columns to the off proc columns.
-	    for ( global_rows_it = global_rows.begin();
-		  global_rows_it != global_rows.end();
-		  ++global_rows_it )
+	    // Get rid of the rows that have already been found. We only need
+	    // the new rows in this level.
+	    std::sort( level_rows.begin(), level_rows.end() );
+	    work.resize( level_rows.size() );
+	    work_end = std::set_difference( level_rows.begin(), 
+					    level_rows.end(),
+					    found_rows.begin(), 
+					    found_rows.end(),
+					    work.begin() );
+	    work_end = std::unique( work.begin(), work_end );
+	    work.resize( std::distance(work.begin(),work_end) );
+	    level_rows.swap( work );
+
+	    // Add the new rows to the found rows and the neighbor rows.
+	    work.resize( found_rows.size() + level_rows.size() );
+	    std::merge( found_rows.begin(), found_rows.end(),
+			level_rows.begin(), level_rows.end(),
+			work.begin() );
+	    found_rows.swap( work );
+	    work.resize( neighbor_rows.size() + level_rows.size() );
+	    std::merge( neighbor_rows.begin(), neighbor_rows.end(),
+			level_rows.begin(), level_rows.end(),
+			work.begin() );
+	    neighbor_rows.swap( work );
+
+	    // Export only the new rows to get the next level in the graph.
+	    if ( i + 1 < num_neighbors )
 	    {
-		ghost_global_rows.push_back( *global_rows_it );
+		level_rows = getOffProcColsAsRows( 
+		    *exportRows(matrix, level_rows()) );
 	    }
-	
-	    // Make a new map of the combined global rows and off proc columns.
-	    Teuchos::RCP<const Epetra_Map> ghost_map = Teuchos::rcp( 
-		new Epetra_Map( -1, 
-				Teuchos::as<int>(ghost_global_rows.size()),
-				ghost_global_rows.getRawPtr(),
-				0,
-				neighbor_matrix->Comm() ) );
-
-	    // Export the neighbor matrix with the new neighbor.
-	    Epetra_Export ghost_exporter( matrix.RowMatrixRowMap(), *ghost_map );
-
-	    neighbor_matrix = Teuchos::rcp( 
-		new Epetra_CrsMatrix( Copy, *ghost_map, 0 ) );
-
-	    MCLS_CHECK_ERROR_CODE(
-		neighbor_matrix->Export( matrix, ghost_exporter, Insert )
-		);
-	    MCLS_CHECK_ERROR_CODE(
-		neighbor_matrix->FillComplete()
-		);
-
-	    // Get the next rows in the graph.
-	    ghost_global_rows = getOffProcColsAsRows( *neighbor_matrix );
 	}
 
+	// Export all of the neighbor rows.
+	Teuchos::RCP<Epetra_CrsMatrix> neighbor_matrix = 
+	    exportRows( matrix, neighbor_rows() );
+
 	MCLS_ENSURE( !neighbor_matrix.is_null() );
 	MCLS_ENSURE( neighbor_matrix->Filled() );
 	return neighbor_matrix;
@@ -367,6 +357,33 @@ class EpetraMatrixHelpers<Epetra_RowMatrix>
 	    );
     }
 
+    /*!
+     * \brief Export a set of global rows of a matrix into a new matrix.
+     */
+    static Teuchos::RCP<Epetra_CrsMatrix>
+    exportRows( const matrix_type& matrix, 
+		const Teuchos::ArrayView<const int>& global_rows )
+    {
+	Epetra_Map row_map( -1, 
+			    Teuchos::as<int>(global_rows.size()),
+			    global_rows.getRawPtr(),
+			    0,
+			    matrix.Comm() );
+	Epetra_Export exporter( matrix.RowMatrixRowMap(), row_map );
+
+	Teuchos::RCP<Epetra_CrsMatrix> row_matrix = 
+	    Teuchos::rcp( new Epetra_CrsMatrix( Copy, row_map, 0 ) );
+	MCLS_CHECK_ERROR_CODE(
+	    row_matrix->Export( matrix, exporter, Insert )
+	    );
+	MCLS_CHECK_ERROR_CODE(
+	    row_matrix->FillComplete()
+	    );
+
+	MCLS_ENSURE( row_matrix->Filled() );
+	return row_matrix;
+    }
+
     /*!
      * \brief Create a copy of a RowMatrix in a CrsMatrix.
      */
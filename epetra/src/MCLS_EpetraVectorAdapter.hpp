@@ -59,6 +59,8 @@
 #include <Epetra_MpiComm.h>
 #endif
 
+#include <cmath>
+
 namespace MCLS
 {
 
@@ -434,6 +436,122 @@ class VectorTraits<Epetra_Vector>
 	    A.Multiply( beta, B, C, alpha )
 	    );
     }
+
+    /*!
+     * \brief Update vector with A = alpha*A + beta*B and return the 2-norm
+     * of the updated vector. The update and norm are computed in a single
+     * pass over the vectors.
+     */
+    static Teuchos::ScalarTraits<scalar_type>::magnitudeType 
+    updateNorm2( vector_type& A, const scalar_type& alpha,
+		 const vector_type& B, const scalar_type& beta )
+    {
+	MCLS_REQUIRE( A.MyLength() == B.MyLength() );
+
+	scalar_type local_norm = 0.0;
+	int local_length = A.MyLength();
+	for ( int i = 0; i < local_length; ++i )
+	{
+	    A[i] = alpha*A[i] + beta*B[i];
+	    local_norm += A[i]*A[i];
+	}
+
+	scalar_type global_norm = 0.0;
+	MCLS_CHECK_ERROR_CODE(
+	    A.Comm().SumAll( &local_norm, &global_norm, 1 )
+	    );
+	return std::sqrt( global_norm );
+    }
+
+    /*!
+     * \brief Update two vectors with A = A + alpha*B and B = B - alpha*C in
+     * a single pass over the vectors.
+     */
+    static void updatePair( vector_type& A, vector_type& B, 
+			    const vector_type& C, const scalar_type& alpha )
+    {
+	MCLS_REQUIRE( A.MyLength() == B.MyLength() );
+	MCLS_REQUIRE( A.MyLength() == C.MyLength() );
+
+	int local_length = A.MyLength();
+	for ( int i = 0; i < local_length; ++i )
+	{
+	    A[i] += alpha*B[i];
+	    B[i] -= alpha*C[i];
+	}
+    }
+
+    /*!
+     * \brief Compute the dot products A \dot B and A \dot C in a single
+     * pass over the vectors with a single global reduction.
+     */
+    static void dotPair( const vector_type& A, 
+			 const vector_type& B, 
+			 const vector_type& C,
+			 scalar_type& A_dot_B, 
+			 scalar_type& A_dot_C )
+    {
+	MCLS_REQUIRE( A.MyLength() == B.MyLength() );
+	MCLS_REQUIRE( A.MyLength() == C.MyLength() );
+
+	scalar_type local_dots[2] = { 0.0, 0.0 };
+	int local_length = A.MyLength();
+	for ( int i = 0; i < local_length; ++i )
+	{
+	    local_dots[0] += A[i]*B[i];
+	    local_dots[1] += A[i]*C[i];
+	}
+
+	scalar_type global_dots[2] = { 0.0, 0.0 };
+	MCLS_CHECK_ERROR_CODE(
+	    A.Comm().SumAll( local_dots, global_dots, 2 )
+	    );
+	A_dot_B = global_dots[0];
+	A_dot_C = global_dots[1];
+    }
+
+    /*!
+     * \brief Compute the squared 2-norm of the local components of the
+     * vector without a global reduction.
+     */
+    static typename Teuchos::ScalarTraits<scalar_type>::magnitudeType 
+    localNorm2Squared( const vector_type& vector )
+    {
+	scalar_type local_norm = 0.0;
+	int local_length = vector.MyLength();
+	for ( int i = 0; i < local_length; ++i )
+	{
+	    local_norm += vector[i]*vector[i];
+	}
+	return local_norm;
+    }
+
+    /*!
+     * \brief Compute the sum of the components of A and the squared 2-norm
+     * of B in a single pass over the vectors with a single global reduction.
+     */
+    static void sumAndNorm2Squared( const vector_type& A, 
+				    const vector_type& B,
+				    scalar_type& A_sum, 
+				    scalar_type& B_norm2_squared )
+    {
+	MCLS_REQUIRE( A.MyLength() == B.MyLength() );
+
+	scalar_type local_sums[2] = { 0.0, 0.0 };
+	int local_length = A.MyLength();
+	for ( int i = 0; i < local_length; ++i )
+	{
+	    local_sums[0] += A[i];
+	    local_sums[1] += B[i]*B[i];
+	}
+
+	scalar_type global_sums[2] = { 0.0, 0.0 };
+	MCLS_CHECK_ERROR_CODE(
+	    A.Comm().SumAll( local_sums, global_sums, 2 )
+	    );
+	A_sum = global_sums[0];
+	B_norm2_squared = global_sums[1];
+    }
 };
 
 //---------------------------------------------------------------------------//
@@ -58,6 +58,9 @@ namespace MCLS
  * \class History
  * \brief Encapsulation of a random walk history's state for adjoint
  * calculations.
+ *
+ * The tally batch of a history is assigned by the tally when the history
+ * enters a domain. It is not packed.
  */
 //---------------------------------------------------------------------------//
 template<class Ordinal>
@@ -73,11 +76,13 @@ class AdjointHistory : public History<Ordinal>
 
     //! Default constructor.
     AdjointHistory()
+	: d_batch( 0 )
     { /* ... */ }
 
     //! State constructor.
     AdjointHistory( Ordinal global_state, int local_state, double weight )
 	: Base( global_state, local_state, weight )
+	, d_batch( 0 )
     { /* ... */ }
 
     // Deserializer constructor.
@@ -86,14 +91,35 @@ class AdjointHistory : public History<Ordinal>
     // Pack the history into a buffer.
     Teuchos::Array<char> pack() const;
 
+    // Pack the history in place into a buffer of the packed history size.
+    void pack( char* buffer ) const;
+
+    // Unpack the history in place from a buffer of the packed history size.
+    void unpack( char* buffer );
+
+    //! Set the tally batch of the history in the current domain.
+    inline void setBatch( const int batch )
+    { d_batch = batch; }
+
+    //! Get the tally batch of the history in the current domain.
+    inline int batch() const
+    { return d_batch; }
+
   public:
 
     // Set the byte size of the packed history state.
-    static void setByteSize();
+    static void setByteSize( const bool compact_states = false,
+			     const bool compact_steps = false,
+			     const bool history_ids = false );
 
     // Get the number of bytes in the packed history state.
     static std::size_t getPackedBytes();
 
+  private:
+
+    // Tally batch in the current domain.
+    int d_batch;
+
   private:
 
     // Packed size of history in bytes.
@@ -131,6 +157,24 @@ class HistoryTraits<AdjointHistory<Ordinal> >
 	return history.pack();
     }
 
+    /*!
+     * \brief Pack the history in place into a buffer of the packed history
+     * size.
+     */
+    static void pack( const history_type& history, char* buffer )
+    {
+	history.pack( buffer );
+    }
+
+    /*!
+     * \brief Unpack a history in place from a buffer of the packed history
+     * size.
+     */
+    static void unpack( history_type& history, char* buffer )
+    {
+	history.unpack( buffer );
+    }
+
     /*!
      * \brief Set the state of a history in global indexing.
      */
@@ -249,9 +293,11 @@ class HistoryTraits<AdjointHistory<Ordinal> >
     /*!
      * \brief Set the byte size of the packed history state.
      */
-    static inline void setByteSize()
+    static inline void setByteSize( const bool compact_states = false,
+				    const bool compact_steps = false,
+				    const bool history_ids = false )
     {
-	history_type::setByteSize();
+	history_type::setByteSize( compact_states, compact_steps, history_ids );
     }
 
     /*!
@@ -277,6 +323,23 @@ class HistoryTraits<AdjointHistory<Ordinal> >
     {
 	return history.numSteps();
     }
+
+    /*!
+     * \brief Set the source-assigned id of the history.
+     */
+    static inline void setHistoryId( history_type& history,
+				     const std::size_t history_id )
+    {
+	history.setHistoryId( history_id );
+    }
+
+    /*!
+     * \brief Get the source-assigned id of the history.
+     */
+    static inline std::size_t historyId( const history_type& history )
+    {
+	return history.historyId();
+    }
 };
 
 //---------------------------------------------------------------------------//
@@ -56,12 +56,10 @@ namespace MCLS
  */
 template<class Ordinal>
 AdjointHistory<Ordinal>::AdjointHistory( const Teuchos::ArrayView<char>& buffer )
+    : d_batch( 0 )
 {
     MCLS_REQUIRE( Teuchos::as<std::size_t>(buffer.size()) == d_packed_bytes );
-    Deserializer ds;
-    ds.setBuffer( buffer );
-    this->unpackHistory( ds );
-    MCLS_ENSURE( ds.getPtr() == ds.end() );
+    unpack( buffer.getRawPtr() );
 }
 
 //---------------------------------------------------------------------------//
@@ -71,14 +69,42 @@ AdjointHistory<Ordinal>::AdjointHistory( const Teuchos::ArrayView<char>& buffer
 template<class Ordinal>
 Teuchos::Array<char> AdjointHistory<Ordinal>::pack() const
 {
-    MCLS_REQUIRE( d_packed_bytes );
     MCLS_REQUIRE( d_packed_bytes > 0 );
     Teuchos::Array<char> buffer( d_packed_bytes );
+    pack( buffer.getRawPtr() );
+    return buffer;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Pack the history in place into a buffer of the packed history
+ * size.
+ */
+template<class Ordinal>
+void AdjointHistory<Ordinal>::pack( char* buffer ) const
+{
+    MCLS_REQUIRE( d_packed_bytes > 0 );
+    MCLS_REQUIRE( buffer );
     Serializer s;
-    s.setBuffer( buffer() );
+    s.setBuffer( d_packed_bytes, buffer );
     this->packHistory( s );
     MCLS_ENSURE( s.getPtr() == s.end() );
-    return buffer;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Unpack the history in place from a buffer of the packed history
+ * size.
+ */
+template<class Ordinal>
+void AdjointHistory<Ordinal>::unpack( char* buffer )
+{
+    MCLS_REQUIRE( d_packed_bytes > 0 );
+    MCLS_REQUIRE( buffer );
+    Deserializer ds;
+    ds.setBuffer( d_packed_bytes, buffer );
+    this->unpackHistory( ds );
+    MCLS_ENSURE( ds.getPtr() == ds.end() );
 }
 
 //---------------------------------------------------------------------------//
@@ -92,9 +118,11 @@ std::size_t AdjointHistory<Ordinal>::d_packed_bytes = 0;
  * \brief Set the byte size of the packed history state.
  */
 template<class Ordinal>
-void AdjointHistory<Ordinal>::setByteSize()
+void AdjointHistory<Ordinal>::setByteSize( const bool compact_states,
+					   const bool compact_steps,
+					   const bool history_ids )
 {
-    Base::setStaticSize();
+    Base::setStaticSize( compact_states, compact_steps, history_ids );
     d_packed_bytes = Base::getStaticSize();
 }
 
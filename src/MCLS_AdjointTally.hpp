@@ -44,11 +44,18 @@
 #include <unordered_map>
 
 #include "MCLS_DBC.hpp"
+#include "MCLS_Estimators.hpp"
+#include "MCLS_Events.hpp"
 #include "MCLS_AdjointHistory.hpp"
 #include "MCLS_VectorTraits.hpp"
+#include "MCLS_VectorExport.hpp"
 #include "MCLS_TallyTraits.hpp"
+#include "MCLS_ThreadTools.hpp"
 
 #include <Teuchos_RCP.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayView.hpp>
+#include <Teuchos_OrdinalTraits.hpp>
 
 namespace MCLS
 {
@@ -58,6 +65,41 @@ namespace MCLS
  * \class AdjointTally
  * \brief Monte Carlo tally for the linear system solution vector for adjoint
  * problems. 
+ *
+ * The master thread tallies directly into the solution vector. All other
+ * transport threads tally into thread-private buffers that are reduced into
+ * the solution vector when the tally is finalized. A thread buffer starts
+ * sparse and is converted to a dense buffer once the fraction of local
+ * states it has tallied exceeds the dense fill ratio.
+ *
+ * The thread buffers are reduced in thread order. Worker threads pull
+ * histories dynamically such that the histories tallied by each thread
+ * depend on thread scheduling. With a single thread the result is bitwise
+ * reproducible. With more than one thread the random walks of reproducible
+ * mode are unchanged and the result is reproducible to round-off.
+ *
+ * By default the collision estimator is used. The expected value estimator
+ * instead tallies, at each state i of a history with weight w, the expected
+ * contribution of the next step, w*h(j,i), into every local state j in row
+ * i of the local adjoint iteration matrix. A history is tallied with the
+ * collision estimator when it enters the domain, both from a source and
+ * from a neighboring domain, such that transitions into boundary states
+ * that are not in the local row data are still accounted for.
+ *
+ * If the domain has overlap states, local states beyond the local length of
+ * the solution vector are tallied into an overlap vector which is export
+ * summed into the solution vector of the owning processes when the tally is
+ * finalized. The export is built once when the overlap states are set.
+ *
+ * Adjoint histories are tallied step by step and may continue in other
+ * domains such that their total scores are never assembled. If variance
+ * batches are set, the variance is instead estimated by batch means. Each
+ * history entering the domain is assigned to the next batch of the calling
+ * thread, in turn, and its contributions are also tallied into that
+ * batch. Each thread owns its own batches. A history that leaves a domain
+ * and later returns to it may be placed in a different batch. Its
+ * contributions to one state are then no longer in a single batch and the
+ * variance is slightly underestimated.
  */
 template<class Vector>
 class AdjointTally
@@ -75,14 +117,38 @@ class AdjointTally
     //@}
 
     // Constructor.
-    AdjointTally( const Teuchos::RCP<Vector>& x );
+    AdjointTally( const Teuchos::RCP<Vector>& x, 
+		  const double dense_fill_ratio = 0.25 );
 
     // Get the vector under the tally.
     Teuchos::RCP<Vector> getVector() const
     { return d_x; }
 
+    // Set the tally to use the expected value estimator.
+    void setExpectedValueEstimator( 
+	const Teuchos::ArrayView<const int>& row_offsets,
+	const Teuchos::ArrayView<const int>& local_columns,
+	const Teuchos::ArrayView<const double>& cdfs,
+	const Teuchos::ArrayView<const int>& signs,
+	const Teuchos::ArrayView<const double>& weights,
+	const int history_length );
+
+    // Set the overlap states of the tally in local state order.
+    void setOverlapStates( const Teuchos::ArrayView<const Ordinal>& states );
+
+    // Get the estimator type.
+    int estimator() const
+    { return d_estimator; }
+
+    // Set the number of batches tallied for the variance estimate.
+    void setVarianceBatches( const int num_batches );
+
+    //! Get the number of variance batches. Zero if no batches are tallied.
+    int numVarianceBatches() const
+    { return d_batch_x.size(); }
+
     // Add a history's contribution to the tally.
-    inline void tallyHistory( const HistoryType& history );
+    inline void tallyHistory( HistoryType& history );
 
     // Normalize base decomposition tally with the number of specified
     // histories.
@@ -91,16 +157,109 @@ class AdjointTally
     // Zero out the tallies.
     void zeroOut();
 
+    // Finalize the tally.
+    void finalize();
+
+    // Estimate the variance of the mean of each state of the last finalized
+    // and normalized tally from the variance batches.
+    void estimateVariance( Vector& variance );
+
   private:
 
+    // Get the number of local states, including overlap states.
+    int numStates() const
+    { return d_x_view.size() + d_x_overlap_view.size(); }
+
+    // Get the master tally value of a local state.
+    inline Scalar& stateValue( const int local_state );
+
+    // Add a contribution to the tally buffer of a thread and to the batch
+    // of the history.
+    inline void addToTally( const int thread_id, const int batch,
+			    const int local_state, const Scalar value );
+
+    // Size the variance batches to the local states.
+    void resizeBatches();
+
+    // Add a contribution to a sparse thread tally buffer.
+    void tallySparse( const int buffer, const int local_state, 
+		      const Scalar weight );
+
     // Solution vector.
     Teuchos::RCP<Vector> d_x;
 
     // View of the solution vector in the tally decomposition.
     Teuchos::ArrayRCP<Scalar> d_x_view;
+
+    // Overlap state tally vector.
+    Teuchos::RCP<Vector> d_x_overlap;
+
+    // View of the overlap state tally vector.
+    Teuchos::ArrayRCP<Scalar> d_x_overlap_view;
+
+    // Overlap-to-solution vector export.
+    Teuchos::RCP<VectorExport<Vector> > d_overlap_export;
    
     // Local iteration matrix global columns in local indexing.
     Teuchos::ArrayRCP<Teuchos::RCP<Teuchos::Array<int> > > d_columns;
+
+    // Number of sparse buffer entries at which a thread buffer is converted
+    // to a dense buffer.
+    int d_dense_threshold;
+
+    // Dense buffer flags for all threads but the master thread.
+    Teuchos::Array<int> d_thread_dense;
+
+    // Dense thread-private tally buffers for all threads but the master
+    // thread.
+    Teuchos::Array<Teuchos::Array<Scalar> > d_thread_x;
+
+    // Sparse thread-private tally buffers for all threads but the master
+    // thread.
+    Teuchos::Array<std::unordered_map<int,Scalar> > d_thread_sparse_x;
+
+    // Estimator type.
+    int d_estimator;
+
+    // History length for the expected value estimator.
+    int d_history_length;
+
+    // Local iteration matrix row offsets for the expected value estimator.
+    Teuchos::ArrayView<const int> d_row_offsets;
+
+    // Local iteration matrix local columns for the expected value estimator.
+    Teuchos::ArrayView<const int> d_local_columns;
+
+    // Local iteration matrix row CDFs for the expected value estimator.
+    Teuchos::ArrayView<const double> d_cdfs;
+
+    // Local iteration matrix entry signs for the expected value estimator.
+    Teuchos::ArrayView<const int> d_signs;
+
+    // Local iteration matrix row weights for the expected value estimator.
+    Teuchos::ArrayView<const double> d_weights;
+
+    // Number of variance batches owned by each thread.
+    int d_thread_batches;
+
+    // Number of histories that have entered the domain on each thread.
+    Teuchos::Array<int> d_thread_entries;
+
+    // Variance batch tallies of the local states, including overlap
+    // states. Batch b is owned by thread b modulo the number of threads.
+    Teuchos::Array<Teuchos::Array<Scalar> > d_batch_x;
+
+    // Number of histories the tally was last normalized with.
+    int d_nh;
+
+    // Batch tally in operator decomposition.
+    Teuchos::RCP<Vector> d_batch_work;
+
+    // Batch tally in the overlap states.
+    Teuchos::RCP<Vector> d_batch_overlap;
+
+    // Batch overlap-to-operator decomposition export.
+    Teuchos::RCP<VectorExport<Vector> > d_batch_export;
 };
 
 //---------------------------------------------------------------------------//
@@ -109,18 +268,102 @@ class AdjointTally
 /*
  * \brief Add a history's contribution to the tally. The collision estimator
  * tally sums the history's current weight into x(i) where the index i is the
- * history's current state.
+ * history's current state. The expected value estimator sums the expected
+ * contribution of the history's next step into the local states in the
+ * history's current row.
  */
 template<class Vector>
-inline void AdjointTally<Vector>::tallyHistory( const HistoryType& history )
+inline void AdjointTally<Vector>::tallyHistory( HistoryType& history )
 {
     MCLS_REQUIRE( history.alive() );
     MCLS_REQUIRE( Teuchos::nonnull(d_x) );
-    MCLS_REQUIRE( VT::isGlobalRow(*d_x, history.globalState()) );
-    MCLS_REQUIRE( VT::isLocalRow(*d_x, history.localState()) );
+    MCLS_REQUIRE( history.localState() >= 0 );
+    MCLS_REQUIRE( history.localState() < numStates() );
 
-    d_x_view[ history.localState() ] += history.weight();
- }
+    int thread_id = ThreadTools::threadId();
+
+    // Assign a history entering the domain to the next batch of the thread.
+    if ( !d_batch_x.empty() && Event::TRANSITION != history.event() )
+    {
+	history.setBatch( thread_id + d_thread_entries.size() *
+			  (d_thread_entries[thread_id] % d_thread_batches) );
+	++d_thread_entries[thread_id];
+    }
+    int batch = history.batch();
+
+    // Collision estimator. With the expected value estimator only histories
+    // entering the domain are tallied this way.
+    if ( Estimator::COLLISION == d_estimator ||
+	 Event::TRANSITION != history.event() )
+    {
+	addToTally( thread_id, batch, history.localState(), history.weight() );
+    }
+
+    // Expected value estimator.
+    if ( Estimator::EXPECTED_VALUE == d_estimator &&
+	 history.numSteps() + 1 < d_history_length )
+    {
+	int local_state = history.localState();
+	double row_weight = history.weight() * d_weights[local_state];
+	double cdf_prev = 0.0;
+	for ( int k = d_row_offsets[local_state];
+	      k < d_row_offsets[local_state+1];
+	      ++k )
+	{
+	    if ( Teuchos::OrdinalTraits<int>::invalid() != d_local_columns[k] )
+	    {
+		addToTally( thread_id, batch, d_local_columns[k], 
+			    row_weight * d_signs[k] * (d_cdfs[k]-cdf_prev) );
+	    }
+	    cdf_prev = d_cdfs[k];
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Get the master tally value of a local state. Overlap states follow
+ * the solution vector states.
+ */
+template<class Vector>
+inline typename AdjointTally<Vector>::Scalar& 
+AdjointTally<Vector>::stateValue( const int local_state )
+{
+    MCLS_REQUIRE( local_state < numStates() );
+    return ( local_state < d_x_view.size() ) ? d_x_view[ local_state ]
+	: d_x_overlap_view[ local_state - d_x_view.size() ];
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Add a contribution to the tally buffer of a thread and to the batch
+ * of the history if variance batches are tallied.
+ */
+template<class Vector>
+inline void AdjointTally<Vector>::addToTally( const int thread_id,
+					      const int batch,
+					      const int local_state,
+					      const Scalar value )
+{
+    if ( !d_batch_x.empty() )
+    {
+	MCLS_CHECK( batch % d_thread_entries.size() == thread_id );
+	d_batch_x[ batch ][ local_state ] += value;
+    }
+
+    if ( 0 == thread_id )
+    {
+	stateValue( local_state ) += value;
+    }
+    else if ( d_thread_dense[thread_id-1] )
+    {
+	d_thread_x[thread_id-1][ local_state ] += value;
+    }
+    else
+    {
+	tallySparse( thread_id-1, local_state, value );
+    }
+}
 
 //---------------------------------------------------------------------------//
 // TallyTraits implementation.
@@ -159,6 +402,32 @@ class TallyTraits<AdjointTally<Vector> >
 	return tally.getVector();
     }
 
+    /*!
+     * \brief Set the tally to use the expected value estimator.
+     */
+    static void setExpectedValueEstimator( 
+	tally_type& tally,
+	const Teuchos::ArrayView<const int>& row_offsets,
+	const Teuchos::ArrayView<const int>& local_columns,
+	const Teuchos::ArrayView<const double>& cdfs,
+	const Teuchos::ArrayView<const int>& signs,
+	const Teuchos::ArrayView<const double>& weights,
+	const int history_length )
+    {
+	tally.setExpectedValueEstimator( row_offsets, local_columns, cdfs,
+					 signs, weights, history_length );
+    }
+
+    /*!
+     * \brief Set the overlap states of the tally.
+     */
+    static void setOverlapStates( 
+	tally_type& tally,
+	const Teuchos::ArrayView<const ordinal_type>& states )
+    {
+	tally.setOverlapStates( states );
+    }
+
     /*!
      * \brief Add a history's contribution to the tally.
      */
@@ -197,7 +466,32 @@ class TallyTraits<AdjointTally<Vector> >
      * \brief Finalize the tally.
      */
     static void finalize( tally_type& tally )
-    { /* ... */ }
+    { 
+	tally.finalize();
+    }
+
+    /*!
+     * \brief Set the number of variance batches.
+     */
+    static void setVarianceBatches( tally_type& tally, const int num_batches )
+    {
+	tally.setVarianceBatches( num_batches );
+    }
+
+    /*!
+     * \brief Estimate the variance of the mean of each state of the last
+     * finalized tally from its variance batches. Return false if no batches
+     * were tallied.
+     */
+    static bool estimateVariance( tally_type& tally, vector_type& variance )
+    {
+	if ( 0 == tally.numVarianceBatches() )
+	{
+	    return false;
+	}
+	tally.estimateVariance( variance );
+	return true;
+    }
 };
 
 //---------------------------------------------------------------------------//
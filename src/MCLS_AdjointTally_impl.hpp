@@ -41,6 +41,8 @@
 #ifndef MCLS_ADJOINTTALLY_IMPL_HPP
 #define MCLS_ADJOINTTALLY_IMPL_HPP
 
+#include <algorithm>
+
 #include <Teuchos_ScalarTraits.hpp>
 #include <Teuchos_OrdinalTraits.hpp>
 #include <Teuchos_ArrayRCP.hpp>
@@ -53,13 +55,111 @@ namespace MCLS
  * \brief Constructor.
  */
 template<class Vector>
-AdjointTally<Vector>::AdjointTally( const Teuchos::RCP<Vector>& x )
+AdjointTally<Vector>::AdjointTally( const Teuchos::RCP<Vector>& x,
+				    const double dense_fill_ratio )
     : d_x( x )
+    , d_thread_dense( ThreadTools::maxThreads() - 1, 0 )
+    , d_thread_x( ThreadTools::maxThreads() - 1 )
+    , d_thread_sparse_x( ThreadTools::maxThreads() - 1 )
+    , d_estimator( Estimator::COLLISION )
+    , d_history_length( 0 )
+    , d_thread_batches( 0 )
+    , d_thread_entries( ThreadTools::maxThreads(), 0 )
+    , d_nh( 1 )
 { 
+    MCLS_REQUIRE( dense_fill_ratio >= 0.0 );
     d_x_view = VT::viewNonConst( *d_x );
+    d_dense_threshold = dense_fill_ratio * d_x_view.size();
     MCLS_ENSURE( Teuchos::nonnull(d_x) );
 }
 
+//---------------------------------------------------------------------------//
+/*
+ * \brief Set the tally to use the expected value estimator. The views are of
+ * the packed local iteration matrix rows of the domain and must remain valid
+ * for the lifetime of the tally.
+ */
+template<class Vector>
+void AdjointTally<Vector>::setExpectedValueEstimator(
+    const Teuchos::ArrayView<const int>& row_offsets,
+    const Teuchos::ArrayView<const int>& local_columns,
+    const Teuchos::ArrayView<const double>& cdfs,
+    const Teuchos::ArrayView<const int>& signs,
+    const Teuchos::ArrayView<const double>& weights,
+    const int history_length )
+{
+    MCLS_REQUIRE( row_offsets.size() == numStates() + 1 );
+    MCLS_REQUIRE( weights.size() == numStates() );
+    MCLS_REQUIRE( local_columns.size() == cdfs.size() );
+    MCLS_REQUIRE( signs.size() == cdfs.size() );
+
+    d_estimator = Estimator::EXPECTED_VALUE;
+    d_history_length = history_length;
+    d_row_offsets = row_offsets;
+    d_local_columns = local_columns;
+    d_cdfs = cdfs;
+    d_signs = signs;
+    d_weights = weights;
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Set the overlap states of the tally in local state order. The
+ * overlap state local ids follow those of the solution vector. This must be
+ * called on all processes of the set.
+ */
+template<class Vector>
+void AdjointTally<Vector>::setOverlapStates(
+    const Teuchos::ArrayView<const Ordinal>& states )
+{
+    d_x_overlap = VT::createFromRows( VT::getComm(*d_x), states );
+    d_x_overlap_view = VT::viewNonConst( *d_x_overlap );
+    d_overlap_export = Teuchos::rcp( 
+	new VectorExport<Vector>(d_x_overlap, d_x) );
+
+    // Resize the dense thread buffers to include the overlap states.
+    for ( int b = 0; b < d_thread_x.size(); ++b )
+    {
+	if ( d_thread_dense[b] )
+	{
+	    d_thread_x[b].resize( numStates(),
+				  Teuchos::ScalarTraits<Scalar>::zero() );
+	}
+    }
+
+    // Resize the variance batches to include the overlap states.
+    d_batch_export = Teuchos::null;
+    resizeBatches();
+
+    MCLS_ENSURE( numStates() == 
+		 VT::getLocalLength(*d_x) + VT::getLocalLength(*d_x_overlap) );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Set the number of batches tallied for the variance estimate. The
+ * number is rounded up to a multiple of the number of threads such that each
+ * thread owns the same number of batches. Fewer than two batches disables
+ * them. The batches are zeroed.
+ */
+template<class Vector>
+void AdjointTally<Vector>::setVarianceBatches( const int num_batches )
+{
+    MCLS_REQUIRE( num_batches >= 0 );
+
+    int num_threads = d_thread_entries.size();
+    int thread_batches = 
+	( num_batches > 1 ) ? (num_batches + num_threads - 1) / num_threads : 0;
+    if ( thread_batches * num_threads != d_batch_x.size() )
+    {
+	d_thread_batches = thread_batches;
+	d_batch_x.resize( thread_batches * num_threads );
+	resizeBatches();
+    }
+
+    MCLS_ENSURE( 1 != d_batch_x.size() );
+}
+
 //---------------------------------------------------------------------------//
 /*
  * \brief Normalize base decomposition tally with the number of specified
@@ -68,6 +168,7 @@ AdjointTally<Vector>::AdjointTally( const Teuchos::RCP<Vector>& x )
 template<class Vector>
 void AdjointTally<Vector>::normalize( const int& nh )
 {
+    d_nh = nh;
     VT::scale( *d_x, 1.0 / Teuchos::as<double>(nh) );
 }
 
@@ -80,6 +181,177 @@ void AdjointTally<Vector>::zeroOut()
 {
     MCLS_REQUIRE( Teuchos::nonnull(d_x) );
     VT::putScalar( *d_x, Teuchos::ScalarTraits<Scalar>::zero() );
+    if ( Teuchos::nonnull(d_x_overlap) )
+    {
+	VT::putScalar( *d_x_overlap, Teuchos::ScalarTraits<Scalar>::zero() );
+    }
+
+    for ( int b = 0; b < d_thread_x.size(); ++b )
+    {
+	std::fill( d_thread_x[b].begin(), d_thread_x[b].end(),
+		   Teuchos::ScalarTraits<Scalar>::zero() );
+	d_thread_sparse_x[b].clear();
+    }
+
+    for ( auto& batch_x : d_batch_x )
+    {
+	std::fill( batch_x.begin(), batch_x.end(),
+		   Teuchos::ScalarTraits<Scalar>::zero() );
+    }
+    std::fill( d_thread_entries.begin(), d_thread_entries.end(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Finalize the tally by reducing the thread tallies into the solution
+ * vector. 
+ *
+ * The thread tallies are reduced in thread order such that each entry of the
+ * solution vector has the same summation order regardless of how the
+ * threads were scheduled. The overlap tallies are then export summed into the
+ * solution vector of their owning processes.
+ */
+template<class Vector>
+void AdjointTally<Vector>::finalize()
+{
+    typename std::unordered_map<int,Scalar>::const_iterator sparse_it;
+    for ( int b = 0; b < d_thread_x.size(); ++b )
+    {
+	if ( d_thread_dense[b] )
+	{
+	    for ( int i = 0; i < d_thread_x[b].size(); ++i )
+	    {
+		stateValue( i ) += d_thread_x[b][i];
+		d_thread_x[b][i] = Teuchos::ScalarTraits<Scalar>::zero();
+	    }
+	}
+	else
+	{
+	    for ( sparse_it = d_thread_sparse_x[b].begin();
+		  sparse_it != d_thread_sparse_x[b].end();
+		  ++sparse_it )
+	    {
+		stateValue( sparse_it->first ) += sparse_it->second;
+	    }
+	    d_thread_sparse_x[b].clear();
+	}
+    }
+
+    // Return the overlap tallies to their owning states.
+    if ( Teuchos::nonnull(d_overlap_export) )
+    {
+	d_overlap_export->doExportAdd();
+	VT::putScalar( *d_x_overlap, Teuchos::ScalarTraits<Scalar>::zero() );
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Estimate the variance of the mean of each state of the last
+ * finalized and normalized tally from the variance batches.
+ *
+ * Each batch is returned to the operator decomposition with its overlap
+ * states, and its square is summed. With B batches of tally Y_b over nh
+ * histories, the batch estimates of a state are B*Y_b/nh. The variance of
+ * their mean, the tally x, is then (B*sum(Y_b^2)/nh^2 - x^2)/(B-1). This
+ * must be called on all processes of the set.
+ */
+template<class Vector>
+void AdjointTally<Vector>::estimateVariance( Vector& variance )
+{
+    MCLS_REQUIRE( d_batch_x.size() > 1 );
+    MCLS_REQUIRE( VT::getLocalLength(variance) == d_x_view.size() );
+
+    // Build the batch work vectors once.
+    if ( Teuchos::is_null(d_batch_work) )
+    {
+	d_batch_work = VT::clone( *d_x );
+    }
+    if ( Teuchos::nonnull(d_x_overlap) && Teuchos::is_null(d_batch_export) )
+    {
+	d_batch_overlap = VT::clone( *d_x_overlap );
+	d_batch_export = Teuchos::rcp( 
+	    new VectorExport<Vector>(d_batch_overlap, d_batch_work) );
+    }
+
+    // Sum the squared batch tallies in the operator decomposition.
+    VT::putScalar( variance, Teuchos::ScalarTraits<Scalar>::zero() );
+    int local_length = d_x_view.size();
+    for ( auto& batch_x : d_batch_x )
+    {
+	Teuchos::ArrayRCP<Scalar> work_view = VT::viewNonConst( *d_batch_work );
+	std::copy( batch_x.begin(), batch_x.begin() + local_length, 
+		   work_view.begin() );
+	if ( Teuchos::nonnull(d_batch_export) )
+	{
+	    Teuchos::ArrayRCP<Scalar> overlap_view = 
+		VT::viewNonConst( *d_batch_overlap );
+	    std::copy( batch_x.begin() + local_length, batch_x.end(),
+		       overlap_view.begin() );
+	    d_batch_export->doExportAdd();
+	}
+	VT::elementWiseMultiply( variance, 1.0, *d_batch_work, *d_batch_work, 
+				 1.0 );
+    }
+
+    // Compute the variance of the mean of each state.
+    double num_batches = d_batch_x.size();
+    double nh = d_nh;
+    double batch_scale = num_batches / (nh * nh);
+    Teuchos::ArrayRCP<const Scalar> x_view = VT::view( *d_x );
+    Teuchos::ArrayRCP<Scalar> var_view = VT::viewNonConst( variance );
+    for ( int i = 0; i < local_length; ++i )
+    {
+	var_view[i] = std::max( 
+	    batch_scale * var_view[i] - x_view[i] * x_view[i], 0.0 ) / 
+		      (num_batches - 1.0);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Add a contribution to a sparse thread tally buffer. If the buffer
+ * has exceeded the dense fill ratio it is converted to a dense buffer.
+ */
+template<class Vector>
+void AdjointTally<Vector>::tallySparse( const int buffer, 
+					const int local_state,
+					const Scalar weight )
+{
+    MCLS_REQUIRE( buffer < d_thread_sparse_x.size() );
+    MCLS_REQUIRE( !d_thread_dense[buffer] );
+
+    std::unordered_map<int,Scalar>& sparse_x = d_thread_sparse_x[buffer];
+    sparse_x[ local_state ] += weight;
+
+    if ( Teuchos::as<int>(sparse_x.size()) > d_dense_threshold )
+    {
+	d_thread_x[buffer].assign( numStates(),
+				   Teuchos::ScalarTraits<Scalar>::zero() );
+	typename std::unordered_map<int,Scalar>::const_iterator sparse_it;
+	for ( sparse_it = sparse_x.begin(); 
+	      sparse_it != sparse_x.end(); 
+	      ++sparse_it )
+	{
+	    d_thread_x[buffer][ sparse_it->first ] = sparse_it->second;
+	}
+	sparse_x.clear();
+	d_thread_dense[buffer] = 1;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Size the variance batches to the local states and zero them.
+ */
+template<class Vector>
+void AdjointTally<Vector>::resizeBatches()
+{
+    for ( auto& batch_x : d_batch_x )
+    {
+	batch_x.assign( numStates(), Teuchos::ScalarTraits<Scalar>::zero() );
+    }
+    std::fill( d_thread_entries.begin(), d_thread_entries.end(), 0 );
 }
 
 //---------------------------------------------------------------------------//
@@ -42,12 +42,13 @@
 #define MCLS_ALMOSTOPTIMALDOMAIN_HPP
 
 #include <stack>
-#include <unordered_map>
+#include <cmath>
 #include <random>
 
 #include "MCLS_DBC.hpp"
 #include "MCLS_DomainTraits.hpp"
 #include "MCLS_SamplingTools.hpp"
+#include "MCLS_StateIndexer.hpp"
 #include "MCLS_Events.hpp"
 #include "MCLS_VectorTraits.hpp"
 #include "MCLS_MatrixTraits.hpp"
@@ -91,6 +92,47 @@ namespace MCLS
  * distribution functions for each local state in the system that can be
  * sampled, and the associated states for those CDFs to which a given initial
  * state in the local system can transition to.
+ *
+ * The local row data is stored in a compressed row layout with a single row
+ * offset array indexing packed column, CDF, and sign arrays such that a
+ * transition touches contiguous memory.
+ *
+ * Transitions are sampled by a binary search of the row CDF by default. With
+ * "Transition Sampler" set to "Alias", rows with at least "Alias Table
+ * Minimum Row Size" entries are instead sampled in constant time from a
+ * Walker/Vose alias table.
+ *
+ * Histories are terminated after "History Length" steps. If a "Weight
+ * Cutoff" is given, histories are also terminated once their weight falls
+ * below that fraction of the source weight. With "Russian Roulette" enabled
+ * a history below the cutoff instead survives with probability |w|/w_c at
+ * weight w_c such that the estimator remains unbiased.
+ *
+ * Uniform random numbers are drawn directly from the generator of the
+ * calling thread without a distribution object such that threads share no
+ * random number state while transporting histories in the domain. Each
+ * transition first keys the generator to the step of the history with
+ * PRNG::beginStep() such that in reproducible mode a history draws the same
+ * numbers whether it is transported alone or in a batch and on whichever
+ * process it reaches the step.
+ *
+ * Global states are mapped to local states and boundary states to their
+ * owning neighbors with a StateIndexer. Transitions carry local states such
+ * that no global lookup is needed in the transport loop; a history that has
+ * transitioned to a boundary state has an invalid local state.
+ *
+ * With an "Overlap Size" of N, the rows of the N nearest neighbor levels of
+ * the local rows are added to the domain after the local rows and the
+ * boundary is the next level. Histories keep walking in the overlap and are
+ * only communicated when they reach the boundary. The tally returns overlap
+ * state tallies to their owning processes.
+ *
+ * The boundary, neighbor ranks, and global-to-local column structure are
+ * built once at construction. If the operator values change but its
+ * sparsity pattern does not, refillValues() rebuilds only the CDFs,
+ * weights, and alias tables against the cached structure. It avoids the
+ * nearest neighbor graph traversal and the distributor neighbor discovery;
+ * overlap rows are imported once from the cached overlap row set.
  */
 template<class Vector, class Matrix, class RNG, class Tally>
 class AlmostOptimalDomain
@@ -111,8 +153,6 @@ class AlmostOptimalDomain
     typedef std::stack<HistoryType>                       BankType;
     typedef RNG                                           rng_type;
     typedef RNGTraits<RNG>                                RNGT;
-    typedef typename RNGT::uniform_real_distribution_type RandomDistribution;
-    typedef RandomDistributionTraits<RandomDistribution>  RDT;
     //@}
 
     // Constructor.
@@ -120,10 +160,19 @@ class AlmostOptimalDomain
 			 const Teuchos::RCP<Vector>& x,
 			 const Teuchos::ParameterList& plist );
 
+    // Refill the operator values using the cached domain structure.
+    void refillValues( const Teuchos::RCP<const Matrix>& A,
+		       const Teuchos::RCP<Vector>& x,
+		       const Teuchos::ParameterList& plist );
+
     // Set the random number generator.
     void setRNG( const Teuchos::RCP<PRNG<RNG> >& rng )
     { d_rng = rng; }
 
+    // Set the source weight against which the weight cutoff is applied.
+    void setSourceWeight( const double source_weight )
+    { d_abs_weight_cutoff = d_weight_cutoff * std::abs(source_weight); }
+
     // Given a history with a global state in the local domain, set the local
     // state of that history.
     inline void setHistoryLocalState( HistoryType& history ) const;
@@ -131,9 +180,19 @@ class AlmostOptimalDomain
     // Process a history through a transition to a new state.
     inline void processTransition( HistoryType& history ) const;
 
+    // Process a batch of histories through a transition to new states.
+    inline void processTransitions( 
+	const Teuchos::ArrayView<const std::size_t>& history_ids,
+	const Teuchos::ArrayView<const int>& steps,
+	const Teuchos::ArrayView<int>& local_states,
+	const Teuchos::ArrayView<Ordinal>& global_states,
+	const Teuchos::ArrayView<double>& weights,
+	const Teuchos::ArrayView<double>& work ) const;
+
     // Determine if we should terminate the history.
     inline bool terminateHistory( const HistoryType& history ) const
-    { return (HT::numSteps(history) >= d_history_length); }
+    { return (HT::numSteps(history) >= d_history_length) ||
+	    (HT::weightAbs(history) < d_abs_weight_cutoff); }
 
     // Get the domain tally.
     Teuchos::RCP<Tally> domainTally() const
@@ -145,6 +204,10 @@ class AlmostOptimalDomain
     // Determine if a given state is on the boundary.
     inline bool isBoundaryState( const Ordinal& state ) const;
 
+    //! Determine if a local state is in the local domain.
+    bool isLocalState( const int local_state ) const
+    { return Teuchos::OrdinalTraits<int>::invalid() != local_state; }
+
     //! Get the number of neighboring domains from which we will receive.
     int numReceiveNeighbors() const
     { return d_receive_ranks.size(); }
@@ -165,11 +228,26 @@ class AlmostOptimalDomain
     // Get the local states in the domain.
     Teuchos::Array<Ordinal> localStates() const;
 
+    // Get the largest global state in the local domain.
+    Ordinal maxLocalState() const;
+
+    //! Get the maximum number of steps a history may take.
+    int historyLength() const
+    { return d_history_length; }
+
     // Compute the spectral radius of H and H*.
     Teuchos::Array<double> computeConvergenceCriteria() const;
 
   private:
 
+    // Sample the row of a local state and return the packed transition index.
+    inline int sampleTransition( const int in_state, 
+				 const double random ) const;
+
+    // Play Russian roulette with a weight below the cutoff.
+    inline double playRussianRoulette( const double weight, 
+				       const double random ) const;
+
     // Build the domain.
     void buildDomain( const Teuchos::RCP<const Matrix>& A,
 		      const Teuchos::ParameterList& plist );
@@ -181,6 +259,15 @@ class AlmostOptimalDomain
     // Build boundary data.
     void buildBoundary( const Teuchos::RCP<const Matrix>& A );
 
+    // Build the packed local columns from the packed global columns.
+    void buildLocalColumns();
+
+    // Set the tally estimator.
+    void setEstimator( const Teuchos::ParameterList& plist );
+
+    // Set the overlap states with the tally.
+    void setTallyOverlap();
+
     // Given a crs matrix, compute its spectral radius.
     double computeSpectralRadius( 
 	const Teuchos::RCP<Tpetra::CrsMatrix<double,int,Ordinal> >& matrix ) const;
@@ -190,32 +277,59 @@ class AlmostOptimalDomain
     // Random number generator.
     Teuchos::RCP<PRNG<RNG> > d_rng;
 
-    // Random number distribution.
-    Teuchos::RCP<RandomDistribution> d_rng_dist;
-
     // History length.
     int d_history_length;
 
+    // Weight cutoff relative to the source weight.
+    double d_weight_cutoff;
+
+    // Absolute weight cutoff.
+    double d_abs_weight_cutoff;
+
+    // Russian roulette flag.
+    int d_russian_roulette;
+
     // Domain tally.
     Teuchos::RCP<Tally> d_tally;
 
+    // Number of nearest neighbor levels in the overlap.
+    int d_overlap_size;
+
+    // Global states of the local rows in local order. Overlap rows follow
+    // the rows of the operator.
+    Teuchos::Array<Ordinal> d_local_rows;
+
     // Global-to-local row indexer.
-    std::unordered_map<Ordinal,int> d_g2l_row_indexer;
+    StateIndexer<Ordinal> d_g2l_row_indexer;
+
+    // Local row offsets into the packed row data. Row i occupies
+    // [d_row_offsets[i],d_row_offsets[i+1]) in the packed arrays.
+    Teuchos::Array<int> d_row_offsets;
+
+    // Packed local CDF columns in global indexing.
+    Teuchos::Array<Ordinal> d_global_columns;
 
-    // Local CDF columns in global indexing.
-    Teuchos::ArrayRCP<Teuchos::RCP<Teuchos::Array<Ordinal> > > d_global_columns;
+    // Packed local CDF columns in local indexing.
+    Teuchos::Array<int> d_local_columns;
 
-    // Local CDF columns in local indexing.
-    Teuchos::ArrayRCP<Teuchos::RCP<Teuchos::Array<int> > > d_local_columns;
+    // Packed local CDF values.
+    Teuchos::Array<double> d_cdfs;
 
-    // Local CDF values.
-    Teuchos::ArrayRCP<Teuchos::Array<double> > d_cdfs;
+    // Packed signs of the local iteration matrix values.
+    Teuchos::Array<int> d_signs;
 
-    // Local iteration matrix values.
-    Teuchos::ArrayRCP<Teuchos::ArrayRCP<double> > d_h;
+    // Local row weights.
+    Teuchos::Array<double> d_weights;
 
-    // Local weights.
-    Teuchos::ArrayRCP<double> d_weights;
+    // Minimum row size for which transitions are sampled from an alias
+    // table instead of the CDF.
+    int d_alias_min_row_size;
+
+    // Packed alias table probabilities. Only valid for alias-sampled rows.
+    Teuchos::Array<double> d_alias_probabilities;
+
+    // Packed alias table aliases. Only valid for alias-sampled rows.
+    Teuchos::Array<int> d_aliases;
 
     // Neighboring domain process ranks from which we will receive.
     Teuchos::Array<int> d_receive_ranks;
@@ -224,7 +338,7 @@ class AlmostOptimalDomain
     Teuchos::Array<int> d_send_ranks;
 
     // Boundary state to owning neighbor local id table.
-    std::unordered_map<Ordinal,int> d_bnd_to_neighbor;
+    StateIndexer<Ordinal> d_bnd_to_neighbor;
 
     // Parallel communicator.
     Teuchos::RCP<const Teuchos::Comm<int> > d_comm;
@@ -242,9 +356,8 @@ inline void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::setHistoryLocalState(
     HistoryType& history ) const
 {
     MCLS_REQUIRE( isGlobalState(HT::globalState(history)) );
-    MCLS_REQUIRE( d_g2l_row_indexer.count(HT::globalState(history)) );
     HT::setLocalState( 
-	history, d_g2l_row_indexer.find(HT::globalState(history))->second );
+	history, d_g2l_row_indexer.find(HT::globalState(history)) );
 }
 
 //---------------------------------------------------------------------------//
@@ -260,29 +373,122 @@ inline void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::processTransition(
     MCLS_REQUIRE( Event::TRANSITION == HT::event(history) );
     MCLS_REQUIRE( isGlobalState(HT::globalState(history)) );
 
-    // Get the incoming state.
-    int in_state = history.localState();
+    // Key the random numbers of this step of the history.
+    d_rng->beginStep( HT::historyId(history), HT::numSteps(history) );
 
-    // Sample the row CDF to get a new outgoing state.
-    int out_state = 
-	SamplingTools::sampleDiscreteCDF( d_cdfs[in_state].getRawPtr(),
-					  d_cdfs[in_state].size(),
-					  d_rng->random(*d_rng_dist) );
+    // Sample the outgoing state from the row of the incoming state.
+    int in_state = history.localState();
+    int out_state = sampleTransition( in_state, d_rng->uniform() );
 
     // Set the new local state with the history.
-    HT::setLocalState( history, (*d_local_columns[in_state])[out_state] );
+    HT::setLocalState( history, d_local_columns[out_state] );
 
     // Set the new global state with the history.
-    HT::setGlobalState( history, (*d_global_columns[in_state])[out_state] );
+    HT::setGlobalState( history, d_global_columns[out_state] );
 
     // Update the history weight with the transition weight.
-    int transition_sign = ( d_h[in_state][out_state] > 0.0 ) ? 1 : -1;
-    HT::multiplyWeight( history, d_weights[in_state]*transition_sign );
+    HT::multiplyWeight( history, d_weights[in_state]*d_signs[out_state] );
+
+    // Play Russian roulette if the history has fallen below the cutoff.
+    if ( d_russian_roulette && 
+	 HT::weightAbs(history) < d_abs_weight_cutoff )
+    {
+	HT::setWeight( history, playRussianRoulette(HT::weight(history),
+						    d_rng->uniform()) );
+    }
 
     // Increment the history step count.
     HT::addStep( history );
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Process a batch of histories through a transition to new states.
+ *
+ * The batch is given as arrays of the history ids, step counts, local
+ * states, global states, and weights of which the states and weights are
+ * updated in place. The work array is filled with a block of random numbers
+ * which are then replaced by the transition weights such that the weight
+ * update is a contiguous element-wise multiply. In reproducible mode each
+ * random number is instead drawn from the step of its history such that the
+ * batch draws the same numbers as processTransition(). Step counts are not
+ * updated.
+ */
+template<class Vector, class Matrix, class RNG, class Tally>
+inline void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::processTransitions( 
+    const Teuchos::ArrayView<const std::size_t>& history_ids,
+    const Teuchos::ArrayView<const int>& steps,
+    const Teuchos::ArrayView<int>& local_states,
+    const Teuchos::ArrayView<Ordinal>& global_states,
+    const Teuchos::ArrayView<double>& weights,
+    const Teuchos::ArrayView<double>& work ) const
+{
+    MCLS_REQUIRE( Teuchos::nonnull(d_rng) );
+    MCLS_REQUIRE( global_states.size() == local_states.size() );
+    MCLS_REQUIRE( weights.size() == local_states.size() );
+    MCLS_REQUIRE( work.size() == local_states.size() );
+    MCLS_REQUIRE( history_ids.size() == local_states.size() );
+    MCLS_REQUIRE( steps.size() == local_states.size() );
+
+    int num_histories = local_states.size();
+    bool reproducible = d_rng->reproducible();
+
+    // Generate a block of random numbers for the batch.
+    if ( reproducible )
+    {
+	for ( int i = 0; i < num_histories; ++i )
+	{
+	    d_rng->beginStep( history_ids[i], steps[i] );
+	    work[i] = d_rng->uniform();
+	}
+    }
+    else
+    {
+	d_rng->fill( work.getRawPtr(), num_histories );
+    }
+
+    // Sample the outgoing states and store the transition weights.
+    int in_state = 0;
+    int out_state = 0;
+    for ( int i = 0; i < num_histories; ++i )
+    {
+	in_state = local_states[i];
+	out_state = sampleTransition( in_state, work[i] );
+	local_states[i] = d_local_columns[out_state];
+	global_states[i] = d_global_columns[out_state];
+	work[i] = d_weights[in_state] * d_signs[out_state];
+    }
+
+    // Update the history weights with the transition weights.
+    double* weight_ptr = weights.getRawPtr();
+    const double* work_ptr = work.getRawPtr();
+    for ( int i = 0; i < num_histories; ++i )
+    {
+	weight_ptr[i] *= work_ptr[i];
+    }
+
+    // Play Russian roulette with the histories that have fallen below the
+    // cutoff.
+    if ( d_russian_roulette )
+    {
+	for ( int i = 0; i < num_histories; ++i )
+	{
+ 	    if ( std::abs(weight_ptr[i]) < d_abs_weight_cutoff )
+	    {
+		// The roulette number follows the transition number of the
+		// step.
+		if ( reproducible )
+		{
+		    d_rng->beginStep( history_ids[i], steps[i] );
+		    d_rng->uniform();
+		}
+		weight_ptr[i] = 
+		    playRussianRoulette( weight_ptr[i], d_rng->uniform() );
+	    }
+	}
+    }
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * \brief Determine if a given global state is in the local domain.
@@ -291,7 +497,7 @@ template<class Vector, class Matrix, class RNG, class Tally>
 inline bool AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::isGlobalState( 
     const Ordinal& state ) const
 {
-    return d_g2l_row_indexer.count( state );
+    return d_g2l_row_indexer.contains( state );
 }
 
 //---------------------------------------------------------------------------//
@@ -302,7 +508,52 @@ template<class Vector, class Matrix, class RNG, class Tally>
 inline bool AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::isBoundaryState( 
     const Ordinal& state ) const
 {
-    return d_bnd_to_neighbor.count( state );
+    return d_bnd_to_neighbor.contains( state );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Sample the row of a local state with a random number and return the
+ * packed index of the outgoing transition.
+ */
+template<class Vector, class Matrix, class RNG, class Tally>
+inline int AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::sampleTransition( 
+    const int in_state, const double random ) const
+{
+    int row_begin = d_row_offsets[in_state];
+    int row_size = d_row_offsets[in_state+1] - row_begin;
+
+    // Sample the row alias table or CDF to get a new outgoing state.
+    if ( row_size >= d_alias_min_row_size )
+    {
+	return row_begin + SamplingTools::sampleAliasTable( 
+	    d_alias_probabilities.getRawPtr() + row_begin,
+	    d_aliases.getRawPtr() + row_begin,
+	    row_size,
+	    random );
+    }
+
+    return row_begin + SamplingTools::sampleDiscreteCDF( 
+	d_cdfs.getRawPtr() + row_begin, row_size, random );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Play Russian roulette with a weight below the cutoff and a uniform
+ * random number in [0,1). The history survives at the cutoff weight with
+ * probability |w|/w_c and otherwise has its weight set to zero.
+ */
+template<class Vector, class Matrix, class RNG, class Tally>
+inline double 
+AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::playRussianRoulette( 
+    const double weight, const double random ) const
+{
+    MCLS_REQUIRE( std::abs(weight) < d_abs_weight_cutoff );
+    if ( random * d_abs_weight_cutoff < std::abs(weight) )
+    {
+	return (weight < 0.0) ? -d_abs_weight_cutoff : d_abs_weight_cutoff;
+    }
+    return 0.0;
 }
 
 //---------------------------------------------------------------------------//
@@ -336,6 +587,16 @@ class DomainTraits<AlmostOptimalDomain<Vector,Matrix,RNG,Tally> >
 	domain.setRNG( rng );
     }
 
+    /*!
+     * \brief Set the source weight against which the weight cutoff is
+     * applied.
+     */
+    static void setSourceWeight( domain_type& domain, 
+				 const double source_weight )
+    {
+	domain.setSourceWeight( source_weight );
+    }
+
     /*!
      * \brief Given a history with a global state in the local domain, set the
      * local state of that history.
@@ -356,6 +617,23 @@ class DomainTraits<AlmostOptimalDomain<Vector,Matrix,RNG,Tally> >
 	domain.processTransition( history );
     }
 
+    /*!
+     * \brief Process a batch of histories through a transition in the local
+     * domain to new states.
+     */
+    static inline void processTransitions( 
+	const domain_type& domain,
+	const Teuchos::ArrayView<const std::size_t>& history_ids,
+	const Teuchos::ArrayView<const int>& steps,
+	const Teuchos::ArrayView<int>& local_states,
+	const Teuchos::ArrayView<ordinal_type>& global_states,
+	const Teuchos::ArrayView<double>& weights,
+	const Teuchos::ArrayView<double>& work )
+    { 
+	domain.processTransitions( history_ids, steps, local_states, 
+				   global_states, weights, work );
+    }
+
     /*!
      * \brief Deterimine if a history should be terminated.
      */
@@ -391,6 +669,32 @@ class DomainTraits<AlmostOptimalDomain<Vector,Matrix,RNG,Tally> >
 	return domain.isBoundaryState( state );
     }
 
+    /*!
+     * \brief Determine if a local state is in the local domain.
+     */
+    static inline bool isLocalState( const domain_type& domain, 
+				     const int local_state )
+    { 
+	return domain.isLocalState( local_state );
+    }
+
+    /*!
+     * \brief Get the largest global state in the local domain.
+     */
+    static inline ordinal_type maxLocalState( const domain_type& domain )
+    { 
+	return domain.maxLocalState();
+    }
+
+    /*!
+     * \brief Get the maximum number of steps a history may take in the
+     * domain.
+     */
+    static inline int historyLength( const domain_type& domain )
+    { 
+	return domain.historyLength();
+    }
+
     /*!
      * \brief Get the number of neighbors from which this domain will
      * receive. 
@@ -72,8 +72,12 @@ AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::AlmostOptimalDomain(
     const Teuchos::RCP<const Matrix>& A,
     const Teuchos::RCP<Vector>& x,
     const Teuchos::ParameterList& plist )
-    : d_rng_dist( RDT::create(0.0, 1.0) )
-    , d_history_length( 10 )
+    : d_history_length( 10 )
+    , d_weight_cutoff( 0.0 )
+    , d_abs_weight_cutoff( 0.0 )
+    , d_russian_roulette( 0 )
+    , d_overlap_size( 0 )
+    , d_alias_min_row_size( std::numeric_limits<int>::max() )
 {
     MCLS_REQUIRE( Teuchos::nonnull(A) );
     MCLS_REQUIRE( Teuchos::nonnull(x) );
@@ -83,6 +87,10 @@ AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::AlmostOptimalDomain(
 
     // Create the tally.
     d_tally = TT::create( x );
+    if ( d_overlap_size > 0 )
+    {
+	setTallyOverlap();
+    }
 
     // Get the history length.
     if ( plist.isParameter("History Length") )
@@ -90,6 +98,24 @@ AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::AlmostOptimalDomain(
 	d_history_length = plist.get<int>("History Length");
     }
 
+    // Get the relative weight cutoff. The absolute cutoff is set when the
+    // source weight is known.
+    if ( plist.isParameter("Weight Cutoff") )
+    {
+	d_weight_cutoff = plist.get<double>("Weight Cutoff");
+    }
+    MCLS_INSIST( d_weight_cutoff >= 0.0 && d_weight_cutoff < 1.0,
+		 "Weight Cutoff must be in [0,1)" );
+
+    // Determine if Russian roulette is played below the weight cutoff.
+    if ( plist.isParameter("Russian Roulette") )
+    {
+	d_russian_roulette = plist.get<bool>("Russian Roulette");
+    }
+
+    // Set the tally estimator.
+    setEstimator( plist );
+
     // Compute the necessary and sufficient Monte Carlo convergence condition
     // if requested.
     if ( plist.isParameter("Compute Convergence Criteria") )
@@ -127,17 +153,11 @@ void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::buildDomain(
 {
     MCLS_REQUIRE( Teuchos::nonnull(A) );
 
-    // Get the total number of local rows.
+    // Reserve space in the local row data arrays.
     int num_rows = MT::getLocalNumRows( *A );
-
-    // Allocate space in local row data arrays.
-    d_global_columns = 
-	Teuchos::ArrayRCP<Teuchos::RCP<Teuchos::Array<Ordinal> > >( num_rows );
-    d_local_columns = 
-	Teuchos::ArrayRCP<Teuchos::RCP<Teuchos::Array<int> > >( num_rows );
-    d_cdfs = Teuchos::ArrayRCP<Teuchos::Array<double> >( num_rows );
-    d_weights = Teuchos::ArrayRCP<double>( num_rows );
-    d_h = Teuchos::ArrayRCP<Teuchos::ArrayRCP<double> >( num_rows );
+    d_row_offsets.reserve( num_rows + 1 );
+    d_weights.reserve( num_rows );
+    d_row_offsets.push_back( 0 );
 
     // Build the local CDFs and weights.
     double relaxation = 1.0;
@@ -146,41 +166,50 @@ void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::buildDomain(
 	relaxation = plist.get<double>("Neumann Relaxation");
     }
     MCLS_CHECK( 0.0 < relaxation );
-    addMatrixToDomain( A, relaxation );
-
-    // Get the boundary states and their owning process ranks.
-    buildBoundary( A );
 
-    // Make the set of local columns. If the local column is not a global row
-    // then make it invalid to indicate that we have left the domain.
-    typename Teuchos::ArrayRCP<
-	Teuchos::RCP<Teuchos::Array<Ordinal> > >::const_iterator global_it;
-    typename Teuchos::Array<Ordinal>::const_iterator gcol_it;
-    Teuchos::ArrayRCP<
-	Teuchos::RCP<Teuchos::Array<int> > >::iterator local_it;
-    Teuchos::Array<int>::iterator lcol_it;
-    for ( global_it = d_global_columns.begin(),
-	   local_it = d_local_columns.begin();
-	  global_it != d_global_columns.end();
-	  ++global_it, ++local_it )
+    // Determine which rows will be sampled with alias tables.
+    if ( plist.isParameter("Transition Sampler") )
     {
-	*local_it = Teuchos::rcp(
-	    new Teuchos::Array<int>((*global_it)->size()) );
-	for ( gcol_it = (*global_it)->begin(),
-	      lcol_it = (*local_it)->begin();
-	      gcol_it != (*global_it)->end();
-	      ++gcol_it, ++lcol_it )
+	if ( "Alias" == plist.get<std::string>("Transition Sampler") )
 	{
-	    if ( d_g2l_row_indexer.count(*gcol_it) )
+	    d_alias_min_row_size = 16;
+	    if ( plist.isParameter("Alias Table Minimum Row Size") )
 	    {
-		*lcol_it = d_g2l_row_indexer.find( *gcol_it )->second;
-	    }
-	    else
-	    {
-		*lcol_it = Teuchos::OrdinalTraits<int>::invalid();
+		d_alias_min_row_size = 
+		    plist.get<int>("Alias Table Minimum Row Size");
 	    }
 	}
     }
+    MCLS_CHECK( 0 < d_alias_min_row_size );
+
+    // Get the number of overlap levels.
+    if ( plist.isParameter("Overlap Size") )
+    {
+	d_overlap_size = plist.get<int>("Overlap Size");
+    }
+    MCLS_INSIST( d_overlap_size >= 0, "Overlap Size must be non-negative" );
+
+    // Add the local rows and then the overlap rows.
+    addMatrixToDomain( A, relaxation );
+    if ( d_overlap_size > 0 )
+    {
+	addMatrixToDomain( MT::copyNearestNeighbors(*A,d_overlap_size), 
+			   relaxation );
+    }
+
+    // Build the global-to-local row indexer.
+    Teuchos::Array<int> local_rows( d_local_rows.size() );
+    for ( int i = 0; i < local_rows.size(); ++i )
+    {
+	local_rows[i] = i;
+    }
+    d_g2l_row_indexer.build( d_local_rows(), local_rows() );
+
+    // Get the boundary states and their owning process ranks.
+    buildBoundary( A );
+
+    // Make the set of local columns.
+    buildLocalColumns();
 
     // By building the boundary data, now we know where we are sending
     // data. Find out who we are receiving from.
@@ -190,6 +219,94 @@ void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::buildDomain(
     d_receive_ranks = distributor.getImagesFrom();
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Refill the operator values using the cached domain structure.
+ *
+ * The operator must have the same local rows as the operator the domain was
+ * built with and every non-zero of its iteration matrix must be a local or a
+ * cached boundary state. The boundary, the neighbor ranks, and the
+ * global-to-local row indexer are reused; only the packed row data is
+ * rebuilt. The overlap rows are cached in the domain rows so their new
+ * values are imported from their owners directly without traversing the
+ * nearest neighbor graph again. The tally is rebuilt only if the solution
+ * vector has changed.
+ */
+template<class Vector, class Matrix, class RNG, class Tally>
+void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::refillValues(
+    const Teuchos::RCP<const Matrix>& A,
+    const Teuchos::RCP<Vector>& x,
+    const Teuchos::ParameterList& plist )
+{
+    MCLS_REQUIRE( Teuchos::nonnull(A) );
+    MCLS_REQUIRE( Teuchos::nonnull(x) );
+
+    // Keep the cached local rows to check the new operator against.
+    Teuchos::Array<Ordinal> cached_rows;
+    cached_rows.swap( d_local_rows );
+    d_local_rows.reserve( cached_rows.size() );
+
+    // Clear the packed row data. The arrays keep their capacity.
+    d_row_offsets.clear();
+    d_row_offsets.push_back( 0 );
+    d_global_columns.clear();
+    d_cdfs.clear();
+    d_signs.clear();
+    d_weights.clear();
+    d_alias_probabilities.clear();
+    d_aliases.clear();
+
+    // Rebuild the local CDFs and weights.
+    double relaxation = 1.0;
+    if ( plist.isParameter("Neumann Relaxation") )
+    {
+	relaxation = plist.get<double>("Neumann Relaxation");
+    }
+    MCLS_CHECK( 0.0 < relaxation );
+    addMatrixToDomain( A, relaxation );
+    if ( d_overlap_size > 0 )
+    {
+	int num_rows = MT::getLocalNumRows( *A );
+	MCLS_INSIST( num_rows <= cached_rows.size(),
+		     "Refilled operator must have the same local rows" );
+	Teuchos::ArrayView<const Ordinal> overlap_rows = 
+	    cached_rows( num_rows, cached_rows.size() - num_rows );
+	addMatrixToDomain( MT::exportFromRows(*A,overlap_rows), relaxation );
+    }
+    MCLS_INSIST( cached_rows == d_local_rows,
+		 "Refilled operator must have the same local rows" );
+
+    // A transition out of the cached domain and boundary means the sparsity
+    // pattern has changed and the domain must be rebuilt.
+    typename Teuchos::Array<Ordinal>::const_iterator gcol_it;
+    for ( gcol_it = d_global_columns.begin();
+	  gcol_it != d_global_columns.end();
+	  ++gcol_it )
+    {
+	MCLS_INSIST( isGlobalState(*gcol_it) || isBoundaryState(*gcol_it),
+		     "Refilled operator has a new boundary state" );
+    }
+
+    // Make the set of local columns.
+    buildLocalColumns();
+
+    // Rebuild the tally if the solution vector has changed.
+    if ( TT::getVector(*d_tally).getRawPtr() != x.getRawPtr() )
+    {
+	d_tally = TT::create( x );
+	if ( d_overlap_size > 0 )
+	{
+	    setTallyOverlap();
+	}
+    }
+
+    // Reset the tally estimator as the packed row data may have moved.
+    setEstimator( plist );
+
+    MCLS_ENSURE( d_local_columns.size() == d_global_columns.size() );
+    MCLS_ENSURE( Teuchos::nonnull(d_tally) );
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * \brief Get the neighbor domain process rank from which we will receive.
@@ -223,31 +340,32 @@ template<class Vector, class Matrix, class RNG, class Tally>
 int AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::owningNeighbor(
     const Ordinal& state ) const
 {
-    typename std::unordered_map<Ordinal,int>::const_iterator neighbor = 
-	d_bnd_to_neighbor.find( state );
-    MCLS_REQUIRE( neighbor != d_bnd_to_neighbor.end() );
-    return neighbor->second;
+    MCLS_REQUIRE( isBoundaryState(state) );
+    return d_bnd_to_neighbor.find( state );
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Get the local states owned by this domain.
+ * \brief Get the local states owned by this domain in local state order.
  */
 template<class Vector, class Matrix, class RNG, class Tally>
 Teuchos::Array<typename AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::Ordinal>
 AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::localStates() const
 {
-    Teuchos::Array<Ordinal> states( d_g2l_row_indexer.size() );
-    typename Teuchos::Array<Ordinal>::iterator state_it;
-    typename std::unordered_map<Ordinal,int>::const_iterator map_it;
-    for ( map_it = d_g2l_row_indexer.begin(), state_it = states.begin();
-          map_it != d_g2l_row_indexer.end();
-          ++map_it, ++state_it )
-    {
-        *state_it = map_it->first;
-    }
+    return d_local_rows;
+}
 
-    return states;
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the largest global state in the local domain. Zero is returned
+ * for an empty domain.
+ */
+template<class Vector, class Matrix, class RNG, class Tally>
+typename AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::Ordinal
+AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::maxLocalState() const
+{
+    return d_local_rows.empty() ? Teuchos::as<Ordinal>(0) :
+	*std::max_element( d_local_rows.begin(), d_local_rows.end() );
 }
 
 //---------------------------------------------------------------------------//
@@ -263,106 +381,99 @@ void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::addMatrixToDomain(
 
     Ordinal local_num_rows = MT::getLocalNumRows( *A );
     Ordinal global_row = 0;
-    int offset = d_g2l_row_indexer.size();
-    int ipoffset = 0;
     int max_entries = MT::getGlobalMaxNumRowEntries( *A );
     std::size_t num_entries = 0;
+    int row_begin = 0;
+    int row_size = 0;
+    double h_value = 0.0;
+    double row_sum = 0.0;
     Teuchos::Array<double>::iterator cdf_iterator;
 
+    // Allocate row work space once for all rows.
+    Teuchos::Array<Ordinal> row_columns( max_entries );
+    Teuchos::Array<double> row_values( max_entries );
+
     // Add row-by-row.
     for ( Ordinal i = 0; i < local_num_rows; ++i )
     {
-	// Get the offset row index.
-	ipoffset = i+offset;
-
-	// Add the global row id and local row id to the indexer.
+	// Add the global row id. Its local row id is its position in the
+	// local rows.
 	global_row = MT::getGlobalRow(*A, i);
-	d_g2l_row_indexer[global_row] = ipoffset;
-
-	// Allocate column and CDF memory for this row.
-        d_global_columns[ipoffset] = 
-            Teuchos::rcp( new Teuchos::Array<Ordinal>(max_entries) );
-	d_cdfs[ipoffset].resize( max_entries );
+	d_local_rows.push_back( global_row );
 
-	// Add the columns and base PDF values for this row.
+	// Get the columns and base PDF values for this row.
 	MT::getGlobalRowCopy( *A, 
 			      global_row,
-			      (*d_global_columns[ipoffset])(), 
-			      d_cdfs[ipoffset](),
+			      row_columns(), 
+			      row_values(),
 			      num_entries );
 
 	// Check for degeneracy.
 	MCLS_CHECK( num_entries > 0 );
 
-	// Resize local column and CDF arrays for this row.
-	d_global_columns[ipoffset]->resize( num_entries );
-	d_cdfs[ipoffset].resize( num_entries );
-
-	// Create the iteration matrix.
+	// Create the iteration matrix and append the non-zero entries to the
+	// packed row data. Zero entries are dropped.
+	row_begin = d_row_offsets.back();
 	for ( std::size_t j = 0; j < num_entries; ++j )
 	{
 	    // Subtract the operator from the identity matrix.
-	    d_cdfs[ipoffset][j] = 
-		( (*d_global_columns[ipoffset])[j] == global_row ) ?
-		1.0 - relaxation*d_cdfs[ipoffset][j] : 
-		-relaxation*d_cdfs[ipoffset][j];
-
-	    // Mark any zero entries.
-	    if ( std::abs(d_cdfs[ipoffset][j]) < 
-		 std::numeric_limits<double>::epsilon() )
+	    h_value = ( row_columns[j] == global_row ) ?
+		      1.0 - relaxation*row_values[j] : 
+		      -relaxation*row_values[j];
+
+	    if ( std::abs(h_value) >= std::numeric_limits<double>::epsilon() )
 	    {
-		d_cdfs[ipoffset][j] = std::numeric_limits<double>::max();
-		(*d_global_columns[ipoffset])[j] = 
-		    Teuchos::OrdinalTraits<Ordinal>::invalid();
+		d_global_columns.push_back( row_columns[j] );
+		d_signs.push_back( (h_value > 0.0) ? 1 : -1 );
+		d_cdfs.push_back( std::abs(h_value) );
 	    }
 	}
+	row_size = d_cdfs.size() - row_begin;
+	MCLS_CHECK( row_size > 0 );
+	d_row_offsets.push_back( d_cdfs.size() );
 
-	// Extract any zero entries from the iteration matrix.
-	Teuchos::Array<double>::iterator cdf_remove_it;
-	cdf_remove_it = std::remove( d_cdfs[ipoffset].begin(), 
-				     d_cdfs[ipoffset].end(),
-				     std::numeric_limits<double>::max() );
-	d_cdfs[ipoffset].resize( 
-	    std::distance(d_cdfs[ipoffset].begin(), cdf_remove_it) );
-
-	typename Teuchos::Array<Ordinal>::iterator col_remove_it;
-	col_remove_it = std::remove( d_global_columns[ipoffset]->begin(), 
-				     d_global_columns[ipoffset]->end(),
-				     Teuchos::OrdinalTraits<Ordinal>::invalid() );
-	d_global_columns[ipoffset]->resize( 
-	    std::distance(d_global_columns[ipoffset]->begin(), col_remove_it) );
-
-        // Save the current cdf state as the iteration matrix.
-        d_h[ipoffset] = Teuchos::ArrayRCP<double>( d_cdfs[ipoffset].size() );
-        std::copy( d_cdfs[ipoffset].begin(), d_cdfs[ipoffset].end(),
-                   d_h[ipoffset].begin() );
+	// Build the alias table for wide rows from the absolute values.
+	if ( row_size >= d_alias_min_row_size )
+	{
+	    d_alias_probabilities.resize( d_cdfs.size() );
+	    d_aliases.resize( d_cdfs.size() );
+	    SamplingTools::buildAliasTable( 
+		d_cdfs.getRawPtr() + row_begin,
+		row_size,
+		d_alias_probabilities.getRawPtr() + row_begin,
+		d_aliases.getRawPtr() + row_begin );
+	}
 
 	// Accumulate the absolute value of the PDF values to get a
 	// non-normalized CDF for the row.
-	d_cdfs[ipoffset].front() = std::abs( d_cdfs[ipoffset].front() );
-	for ( cdf_iterator = d_cdfs[ipoffset].begin()+1;
-	      cdf_iterator != d_cdfs[ipoffset].end();
+	for ( cdf_iterator = d_cdfs.begin()+row_begin+1;
+	      cdf_iterator != d_cdfs.end();
 	      ++cdf_iterator )
 	{
-	    *cdf_iterator = std::abs( *cdf_iterator ) + *(cdf_iterator-1);
+	    *cdf_iterator += *(cdf_iterator-1);
 	}
 
 	// The final value in the non-normalized CDF is the absolute value of
 	// the weight for this row. This is the absolute value row sum of the
 	// iteration matrix.
-	d_weights[ipoffset] = d_cdfs[ipoffset].back();
-	MCLS_CHECK( d_weights[ipoffset] > 0.0 );
+	row_sum = d_cdfs.back();
+	MCLS_CHECK( row_sum > 0.0 );
+	d_weights.push_back( row_sum );
 
 	// Normalize the CDF for the row.
-	for ( cdf_iterator = d_cdfs[ipoffset].begin();
-	      cdf_iterator != d_cdfs[ipoffset].end();
+	for ( cdf_iterator = d_cdfs.begin()+row_begin;
+	      cdf_iterator != d_cdfs.end();
 	      ++cdf_iterator )
 	{
-	    *cdf_iterator /= d_weights[ipoffset];
+	    *cdf_iterator /= row_sum;
 	    MCLS_CHECK( *cdf_iterator >= 0.0 );
 	}
-	MCLS_CHECK( 1.0 == d_cdfs[ipoffset].back() );
+	MCLS_CHECK( 1.0 == d_cdfs.back() );
     }
+
+    MCLS_ENSURE( d_row_offsets.size() == d_weights.size() + 1 );
+    MCLS_ENSURE( d_global_columns.size() == d_cdfs.size() );
+    MCLS_ENSURE( d_signs.size() == d_cdfs.size() );
 }
 
 //---------------------------------------------------------------------------//
@@ -375,9 +486,11 @@ void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::buildBoundary(
 {
     MCLS_REQUIRE( Teuchos::nonnull(A) );
 
-    // Get the next set of off-process rows. This is the boundary. If we
-    // transition to these then we have left the local domain.
-    Teuchos::RCP<Matrix> A_boundary = MT::copyNearestNeighbors( *A, 1 );
+    // Get the next set of off-process rows beyond the overlap. This is the
+    // boundary. If we transition to these then we have left the local
+    // domain.
+    Teuchos::RCP<Matrix> A_boundary = 
+	MT::copyNearestNeighbors( *A, d_overlap_size+1 );
 
     // Get the boundary rows.
     Ordinal global_row = 0;
@@ -396,13 +509,16 @@ void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::buildBoundary(
     MT::getGlobalRowRanks( *A, boundary_rows(), boundary_ranks() );
 
     // Process the boundary data.
+    Teuchos::Array<int> boundary_neighbors( boundary_rows.size() );
+    Teuchos::Array<int>::iterator bnd_neighbor_it = 
+	boundary_neighbors.begin();
     Teuchos::Array<int>::const_iterator send_rank_it;
     Teuchos::Array<int>::const_iterator bnd_rank_it;
     typename Teuchos::Array<Ordinal>::const_iterator bnd_row_it;
     for ( bnd_row_it = boundary_rows.begin(), 
 	 bnd_rank_it = boundary_ranks.begin();
 	  bnd_row_it != boundary_rows.end();
-	  ++bnd_row_it, ++bnd_rank_it )
+	  ++bnd_row_it, ++bnd_rank_it, ++bnd_neighbor_it )
     {
 	MCLS_CHECK( *bnd_rank_it != -1 );
 
@@ -415,21 +531,93 @@ void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::buildBoundary(
 	if ( send_rank_it == d_send_ranks.end() )
 	{
 	    d_send_ranks.push_back( *bnd_rank_it );
-	    d_bnd_to_neighbor[*bnd_row_it] = d_send_ranks.size()-1;
+	    *bnd_neighbor_it = d_send_ranks.size()-1;
 	}
 
 	// Otherwise, just add it to the boundary state to local id table.
 	else
 	{
-	    d_bnd_to_neighbor[*bnd_row_it] =
+	    *bnd_neighbor_it =
 		std::distance( 
 		    Teuchos::as<Teuchos::Array<int>::const_iterator>(
 			d_send_ranks.begin()), send_rank_it);
 	}
     }
 
-    MCLS_ENSURE( d_bnd_to_neighbor.size() == 
-		 Teuchos::as<std::size_t>(boundary_rows.size()) );
+    // Build the boundary state to neighbor indexer.
+    d_bnd_to_neighbor.build( boundary_rows(), boundary_neighbors() );
+
+    MCLS_ENSURE( d_bnd_to_neighbor.size() == boundary_rows.size() );
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Build the packed local columns from the packed global columns. If
+ * the column is not a global row then the indexer makes it invalid to
+ * indicate that we have left the domain.
+ */
+template<class Vector, class Matrix, class RNG, class Tally>
+void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::buildLocalColumns()
+{
+    d_local_columns.resize( d_global_columns.size() );
+    typename Teuchos::Array<Ordinal>::const_iterator gcol_it;
+    Teuchos::Array<int>::iterator lcol_it;
+    for ( gcol_it = d_global_columns.begin(),
+	  lcol_it = d_local_columns.begin();
+	  gcol_it != d_global_columns.end();
+	  ++gcol_it, ++lcol_it )
+    {
+	*lcol_it = d_g2l_row_indexer.find( *gcol_it );
+	MCLS_CHECK( isLocalState(*lcol_it) || isBoundaryState(*gcol_it) );
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Set the tally estimator. The expected value estimator shares the
+ * packed row data of the domain.
+ */
+template<class Vector, class Matrix, class RNG, class Tally>
+void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::setEstimator(
+    const Teuchos::ParameterList& plist )
+{
+    MCLS_REQUIRE( Teuchos::nonnull(d_tally) );
+
+    if ( plist.isParameter("Estimator Type") )
+    {
+	if ( "Expected Value" == plist.get<std::string>("Estimator Type") )
+	{
+	    TT::setExpectedValueEstimator( *d_tally,
+					   d_row_offsets(),
+					   d_local_columns(),
+					   d_cdfs(),
+					   d_signs(),
+					   d_weights(),
+					   d_history_length );
+	}
+	else
+	{
+	    MCLS_INSIST( "Collision" == plist.get<std::string>("Estimator Type"),
+			 "Estimator Type must be Collision or Expected Value" );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Set the overlap states with the tally. The overlap states are the
+ * local rows beyond the local rows of the tally vector.
+ */
+template<class Vector, class Matrix, class RNG, class Tally>
+void AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::setTallyOverlap()
+{
+    MCLS_REQUIRE( Teuchos::nonnull(d_tally) );
+
+    int num_base_rows = VT::getLocalLength( *TT::getVector(*d_tally) );
+    MCLS_CHECK( num_base_rows <= d_local_rows.size() );
+    TT::setOverlapStates( *d_tally, 
+			  d_local_rows(num_base_rows,
+				       d_local_rows.size()-num_base_rows) );
 }
 
 //---------------------------------------------------------------------------//
@@ -448,27 +636,42 @@ AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::computeConvergenceCriteria() const
     // Find the convergence criteria.
     Teuchos::Array<double> evals(3);
 
-    // Spectral radius of H.
-    double max_entries = 0;
+    // Allocate a work array for a single row.
+    int max_row_size = 0;
+    for ( int i = 0; i < num_rows; ++i )
+    {
+	max_row_size = std::max( max_row_size,
+				 d_row_offsets[i+1] - d_row_offsets[i] );
+    }
+    Teuchos::Array<double> values( max_row_size );
+    int row_begin = 0;
+    int row_size = 0;
+
+    // Spectral radius of H. The iteration matrix values are recovered from
+    // the row weight, the CDF, and the transition sign.
     {
 	Teuchos::RCP<Tpetra::CrsMatrix<double,int,Ordinal> > H =
 	    Tpetra::createCrsMatrix<double,int,Ordinal>( map );
 	for ( int i = 0; i < num_rows; ++i )
 	{
+	    row_begin = d_row_offsets[i];
+	    row_size = d_row_offsets[i+1] - row_begin;
+	    for ( int j = 0; j < row_size; ++j )
+	    {
+		values[j] = d_signs[row_begin+j] * d_weights[i] *
+			    ( d_cdfs[row_begin+j] - 
+			      ((j > 0) ? d_cdfs[row_begin+j-1] : 0.0) );
+	    }
+
 	    H->insertGlobalValues(
 		local_rows[i],
-		(*d_global_columns[i])(),
-		d_h[i]() );
+		d_global_columns(row_begin,row_size),
+		values(0,row_size) );
 	}
 	H->fillComplete();
-	max_entries = H->getGlobalMaxNumRowEntries();
 	evals[0] = computeSpectralRadius( H );
     }
 
-    // Allocate a work array.
-    Teuchos::Array<double> values( max_entries );
-    int row_size = 0;
-
     // Spectral radius of H+.
     {
 	Teuchos::RCP<Tpetra::CrsMatrix<double,int,Ordinal> > H_plus =
@@ -479,16 +682,19 @@ AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::computeConvergenceCriteria() const
 	for ( int i = 0; i < num_rows; ++i )
 	{
 	    row_sum = 0.0;
-	    row_size = d_global_columns[i]->size();
+	    row_begin = d_row_offsets[i];
+	    row_size = d_row_offsets[i+1] - row_begin;
 	    for ( int j = 0; j < row_size; ++j )
 	    {
-		values[j] = std::abs(d_h[i][j]);
+		values[j] = d_weights[i] *
+			    ( d_cdfs[row_begin+j] - 
+			      ((j > 0) ? d_cdfs[row_begin+j-1] : 0.0) );
 		row_sum += values[j];
 	    }
 
 	    H_plus->insertGlobalValues(
 		local_rows[i],
-		(*d_global_columns[i])(),
+		d_global_columns(row_begin,row_size),
 		values(0,row_size) );
 
 	    max_row_sum = std::max( max_row_sum, row_sum );
@@ -559,19 +765,20 @@ AlmostOptimalDomain<Vector,Matrix,RNG,Tally>::computeConvergenceCriteria() const
     {
 	Teuchos::RCP<Tpetra::CrsMatrix<double,int,Ordinal> > H_star =
 	    Tpetra::createCrsMatrix<double,int,Ordinal>( map );
-	int h_sign = 0;
 	for ( int i = 0; i < num_rows; ++i )
 	{
-	    row_size = d_global_columns[i]->size();
+	    row_begin = d_row_offsets[i];
+	    row_size = d_row_offsets[i+1] - row_begin;
 	    for ( int j = 0; j < row_size; ++j )
 	    {
-		h_sign = ( d_h[i][j] > 0.0 ) ? 1 : -1;
-		values[j] = d_h[i][j] * h_sign * d_weights[i];
+		values[j] = d_weights[i] * d_weights[i] *
+			    ( d_cdfs[row_begin+j] - 
+			      ((j > 0) ? d_cdfs[row_begin+j-1] : 0.0) );
 	    }
 
 	    H_star->insertGlobalValues(
 		local_rows[i],
-		(*d_global_columns[i])(),
+		d_global_columns(row_begin,row_size),
 		values(0,row_size) );
 	}
 	H_star->fillComplete();
@@ -0,0 +1,203 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2012, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the University of Wisconsin - Madison nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file MCLS_BulkSynchronousTransporter.hpp
+ * \author Stuart R. Slattery
+ * \brief BulkSynchronousTransporter class declaration.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef MCLS_BULKSYNCHRONOUSTRANSPORTER_HPP
+#define MCLS_BULKSYNCHRONOUSTRANSPORTER_HPP
+
+#include "MCLS_GlobalTransporter.hpp"
+#include "MCLS_SourceTraits.hpp"
+#include "MCLS_DomainTraits.hpp"
+#include "MCLS_DomainTransporter.hpp"
+
+#include <Teuchos_RCP.hpp>
+#include <Teuchos_Comm.hpp>
+#include <Teuchos_ParameterList.hpp>
+#include <Teuchos_Array.hpp>
+
+namespace MCLS
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class BulkSynchronousTransporter 
+ * \brief Monte Carlo transporter for domain decomposed problems with
+ * domain-to-domain communication in bulk synchronous rounds.
+ *
+ * In each round all local histories are transported through the local
+ * domain until they are cut off or hit the boundary. All boundary histories
+ * are then exchanged with the neighboring domains in a single neighborhood
+ * all-to-all. Rounds continue until a global reduction finds that no
+ * histories remain in the set. All communication operations occur within a
+ * set. Multiple set problems will create multiple instances of this class.
+ *
+ * In the local transport of a round the worker threads pull batches of
+ * "History Batch Size" histories from the source and the bank and transport
+ * them with their own random number streams and tally buffers. The boundary
+ * histories of all threads are exchanged by the master thread.
+ */
+//---------------------------------------------------------------------------//
+template<class Source>
+class BulkSynchronousTransporter : public GlobalTransporter<Source>
+{
+  public:
+
+    //@{
+    //! Typedefs.
+    typedef Source                                    source_type;
+    typedef SourceTraits<Source>                      ST;
+    typedef typename ST::domain_type                  Domain;
+    typedef DomainTraits<Domain>                      DT;
+    typedef typename DT::history_type                 HistoryType;
+    typedef HistoryTraits<HistoryType>                HT;
+    typedef typename DT::bank_type                    BankType;
+    typedef DomainTransporter<Domain>                 DomainTransporterType;
+    typedef Teuchos::Comm<int>                        Comm;
+    //@}
+
+    // Constructor.
+    BulkSynchronousTransporter( const Teuchos::RCP<const Comm>& comm,
+				const Teuchos::RCP<Domain>& domain, 
+				const Teuchos::ParameterList& plist );
+
+    // Assign the source.
+    void assignSource( const Teuchos::RCP<Source>& source );
+
+    // Transport the source histories and all subsequent histories through the
+    // domain to completion.
+    void transport();
+
+    // Reset the state of the transporter.
+    void reset();
+
+    //! Get the number of histories completed on this process in the last
+    //! transport.
+    long numCompletedHistories() const
+    { return d_domain_transporter.numCompletedHistories(); }
+
+    //! Get the total number of steps of the histories completed on this
+    //! process in the last transport.
+    long numCompletedSteps() const
+    { return d_domain_transporter.numCompletedSteps(); }
+
+    //! Get the current history buffer size of each send neighbor of this
+    //! process. Histories are exchanged without fixed size buffers.
+    Teuchos::Array<int> sendBufferSizes() const
+    { return Teuchos::Array<int>(); }
+
+    //! Get the number of communication rounds in the last transport.
+    int numRounds() const
+    { return d_num_rounds; }
+
+  private:
+
+    // Transport the local source and bank histories through the local
+    // domain.
+    void localTransport( BankType& bank );
+
+    // Transport a batch of histories through the local domain on the
+    // calling thread and collect those that hit the boundary.
+    void transportBatch( Teuchos::Array<HistoryType>& batch,
+			 Teuchos::Array<HistoryType>& outgoing );
+
+    // Exchange the boundary histories with the neighbors and add the
+    // received histories to the bank.
+    void exchange( BankType& bank );
+
+  private:
+
+    // Parallel communicator for this set.
+    Teuchos::RCP<const Comm> d_comm;
+
+    // Neighborhood communicator over the domain send and receive ranks.
+    Teuchos::RCP<const Comm> d_neighbor_comm;
+
+    // Local domain.
+    Teuchos::RCP<Domain> d_domain;
+
+    // Domain transporter.
+    DomainTransporterType d_domain_transporter;
+
+    // Source.
+    Teuchos::RCP<Source> d_source;
+
+    // Number of histories transported together as a batch.
+    int d_batch_size;
+
+    // History batch of each worker thread.
+    Teuchos::Array<Teuchos::Array<HistoryType> > d_thread_batches;
+
+    // Boundary histories of each worker thread in the current round.
+    Teuchos::Array<Teuchos::Array<HistoryType> > d_thread_outgoing;
+
+    // Boundary histories to send to each send neighbor.
+    Teuchos::Array<Teuchos::Array<HistoryType> > d_outgoing;
+
+    // Packed histories to send to the send neighbors.
+    Teuchos::Array<char> d_send_buffer;
+
+    // Packed history bytes to send to each send neighbor.
+    Teuchos::Array<int> d_send_sizes;
+
+    // Packed histories received from the receive neighbors.
+    Teuchos::Array<char> d_receive_buffer;
+
+    // Packed history bytes received from each receive neighbor.
+    Teuchos::Array<int> d_receive_sizes;
+
+    // Number of communication rounds in the last transport.
+    int d_num_rounds;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace MCLS
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "MCLS_BulkSynchronousTransporter_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end MCLS_BULKSYNCHRONOUSTRANSPORTER_HPP
+
+//---------------------------------------------------------------------------//
+// end MCLS_BulkSynchronousTransporter.hpp
+//---------------------------------------------------------------------------//
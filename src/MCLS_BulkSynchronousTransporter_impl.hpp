@@ -0,0 +1,356 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2012, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the University of Wisconsin - Madison nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file MCLS_BulkSynchronousTransporter_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief BulkSynchronousTransporter class implementation.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef MCLS_BULKSYNCHRONOUSTRANSPORTER_IMPL_HPP
+#define MCLS_BULKSYNCHRONOUSTRANSPORTER_IMPL_HPP
+
+#include "MCLS_config.hpp"
+#include "MCLS_DBC.hpp"
+#include "MCLS_CommTools.hpp"
+#include "MCLS_Events.hpp"
+#include "MCLS_ThreadTools.hpp"
+
+#include <Teuchos_CommHelpers.hpp>
+#include <Teuchos_as.hpp>
+
+namespace MCLS
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Constructor.
+ */
+template<class Source>
+BulkSynchronousTransporter<Source>::BulkSynchronousTransporter( 
+    const Teuchos::RCP<const Comm>& comm,
+    const Teuchos::RCP<Domain>& domain, 
+    const Teuchos::ParameterList& plist )
+    : d_comm( comm )
+    , d_domain( domain )
+    , d_domain_transporter( d_domain )
+    , d_batch_size( 1 )
+    , d_outgoing( DT::numSendNeighbors(*d_domain) )
+    , d_send_sizes( DT::numSendNeighbors(*d_domain), 0 )
+    , d_receive_sizes( DT::numReceiveNeighbors(*d_domain), 0 )
+    , d_num_rounds( 0 )
+{
+    MCLS_REQUIRE( Teuchos::nonnull(d_comm) );
+    MCLS_REQUIRE( Teuchos::nonnull(d_domain) );
+    MCLS_INSIST( HT::getPackedBytes(), "Packed history size not set." );
+
+    // Set the number of histories to transport together. Default to 1.
+    if ( plist.isParameter("History Batch Size") )
+    {
+	d_batch_size = plist.get<int>("History Batch Size");
+    }
+
+    // Create the worker thread batches.
+    int num_threads = ThreadTools::maxThreads();
+    d_thread_batches.resize( num_threads );
+    d_thread_outgoing.resize( num_threads );
+    for ( int t = 0; t < num_threads; ++t )
+    {
+	d_thread_batches[t].reserve( d_batch_size );
+    }
+
+    // Build the neighborhood communicator.
+    Teuchos::Array<int> receive_ranks( DT::numReceiveNeighbors(*d_domain) );
+    for ( int n = 0; n < receive_ranks.size(); ++n )
+    {
+	receive_ranks[n] = DT::receiveNeighborRank( *d_domain, n );
+    }
+    Teuchos::Array<int> send_ranks( DT::numSendNeighbors(*d_domain) );
+    for ( int n = 0; n < send_ranks.size(); ++n )
+    {
+	send_ranks[n] = DT::sendNeighborRank( *d_domain, n );
+    }
+    d_neighbor_comm = CommTools::createNeighborComm( 
+	d_comm, receive_ranks(), send_ranks() );
+
+    MCLS_ENSURE( d_batch_size > 0 );
+    MCLS_ENSURE( Teuchos::nonnull(d_neighbor_comm) );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+* \brief Assign the source.
+*/
+template<class Source>
+void BulkSynchronousTransporter<Source>::assignSource(
+    const Teuchos::RCP<Source>& source )
+{
+    MCLS_REQUIRE( Teuchos::nonnull(source) );
+    MCLS_REQUIRE( Teuchos::nonnull(d_domain) );
+    d_source = source;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Transport the source histories and all subsequent histories through
+ * the domain to completion.
+ */
+template<class Source>
+void BulkSynchronousTransporter<Source>::transport()
+{
+    MCLS_REQUIRE( Teuchos::nonnull(d_source) );
+
+    // Barrier before transport.
+    d_comm->barrier();
+
+    // Create a history bank.
+    BankType bank;
+    MCLS_CHECK( bank.empty() );
+
+    // Transport in rounds until no histories remain in the set.
+    d_num_rounds = 0;
+    long global_num_remaining = 1;
+    while ( global_num_remaining > 0 )
+    {
+	// Transport all local histories to the boundary or cutoff.
+	localTransport( bank );
+	MCLS_CHECK( ST::empty(*d_source) );
+	MCLS_CHECK( bank.empty() );
+
+	// Exchange the boundary histories with the neighbors.
+	exchange( bank );
+	++d_num_rounds;
+
+	// Count the histories remaining in the set.
+	long local_num_remaining = bank.size();
+	Teuchos::reduceAll<int,long>( *d_comm, Teuchos::REDUCE_SUM,
+				      local_num_remaining, 
+				      Teuchos::outArg(global_num_remaining) );
+    }
+
+    // Barrier before continuing.
+    d_comm->barrier();
+
+    MCLS_ENSURE( ST::empty(*d_source) );
+    MCLS_ENSURE( bank.empty() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Reset the state of the transporter. The domain tally is rebound
+ * such that a domain with refilled values may be transported again.
+ */
+template<class Source>
+void BulkSynchronousTransporter<Source>::reset()
+{
+    d_num_rounds = 0;
+    d_domain_transporter.resetStatistics();
+    d_domain_transporter.updateTally();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Transport the local source and bank histories through the local
+ * domain. Source histories are used first.
+ *
+ * Each worker thread pulls batches of histories until the source and the
+ * bank are empty. The source and the bank are only accessed inside a
+ * critical section. The boundary histories are then sorted by owning
+ * neighbor in thread order.
+ */
+template<class Source>
+void BulkSynchronousTransporter<Source>::localTransport( BankType& bank )
+{
+    int num_threads = d_thread_batches.size();
+
+#if HAVE_MCLS_OPENMP
+#pragma omp parallel num_threads(num_threads)
+#endif
+    {
+	int thread_id = ThreadTools::threadId();
+	Teuchos::Array<HistoryType>& batch = d_thread_batches[thread_id];
+	Teuchos::Array<HistoryType>& outgoing = d_thread_outgoing[thread_id];
+
+	do
+	{
+	    // Fill the batch.
+	    batch.clear();
+#if HAVE_MCLS_OPENMP
+#pragma omp critical(MCLS_BulkSynchronousTransporter_pull)
+#endif
+	    {
+		while ( !ST::empty(*d_source) && batch.size() < d_batch_size )
+		{
+		    batch.push_back( ST::getHistory(*d_source) );
+		}
+		while ( !bank.empty() && batch.size() < d_batch_size )
+		{
+		    batch.push_back( bank.top() );
+		    bank.pop();
+		}
+	    }
+
+	    // Transport the batch.
+	    if ( !batch.empty() )
+	    {
+		transportBatch( batch, outgoing );
+	    }
+	} while ( !batch.empty() );
+    }
+
+    // Collect the boundary histories by owning neighbor.
+    for ( int t = 0; t < num_threads; ++t )
+    {
+	typename Teuchos::Array<HistoryType>::iterator history_it;
+	for ( history_it = d_thread_outgoing[t].begin(); 
+	      history_it != d_thread_outgoing[t].end(); 
+	      ++history_it )
+	{
+	    d_outgoing[ DT::owningNeighbor(
+		    *d_domain, HT::globalState(*history_it)) ].push_back( 
+			*history_it );
+	}
+	d_thread_outgoing[t].clear();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Transport a batch of histories through the local domain on the
+ * calling thread and collect those that hit the boundary.
+ */
+template<class Source>
+void BulkSynchronousTransporter<Source>::transportBatch( 
+    Teuchos::Array<HistoryType>& batch,
+    Teuchos::Array<HistoryType>& outgoing )
+{
+    // Set the histories alive for transport.
+    typename Teuchos::Array<HistoryType>::iterator history_it;
+    for ( history_it = batch.begin(); 
+	  history_it != batch.end(); 
+	  ++history_it )
+    {
+	HT::live( *history_it );
+    }
+
+    // Do local transport.
+    if ( 1 == batch.size() )
+    {
+	d_domain_transporter.transport( batch.front() );
+    }
+    else
+    {
+	d_domain_transporter.transport( batch() );
+    }
+
+    // Collect the histories that left the local domain.
+    for ( history_it = batch.begin(); 
+	  history_it != batch.end(); 
+	  ++history_it )
+    {
+	MCLS_CHECK( !HT::alive(*history_it) );
+
+	if ( Event::BOUNDARY == HT::event(*history_it) )
+	{
+	    outgoing.push_back( *history_it );
+	}
+	else
+	{
+	    MCLS_CHECK( Event::CUTOFF == HT::event(*history_it) );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Exchange the boundary histories with the neighbors and add the
+ * received histories to the bank.
+ */
+template<class Source>
+void BulkSynchronousTransporter<Source>::exchange( BankType& bank )
+{
+    std::size_t packed_bytes = HT::getPackedBytes();
+
+    // Pack the outgoing histories in send neighbor order.
+    int num_send_bytes = 0;
+    for ( int n = 0; n < d_outgoing.size(); ++n )
+    {
+	d_send_sizes[n] = d_outgoing[n].size() * packed_bytes;
+	num_send_bytes += d_send_sizes[n];
+    }
+    d_send_buffer.resize( num_send_bytes );
+    char* buffer_ptr = d_send_buffer.getRawPtr();
+    typename Teuchos::Array<HistoryType>::const_iterator history_it;
+    for ( int n = 0; n < d_outgoing.size(); ++n )
+    {
+	for ( history_it = d_outgoing[n].begin();
+	      history_it != d_outgoing[n].end();
+	      ++history_it )
+	{
+	    HT::pack( *history_it, buffer_ptr );
+	    buffer_ptr += packed_bytes;
+	}
+	d_outgoing[n].clear();
+    }
+    MCLS_CHECK( d_send_buffer.getRawPtr() + num_send_bytes == buffer_ptr );
+
+    // Exchange with all neighbors.
+    CommTools::neighborAlltoallv( d_neighbor_comm, 
+				  d_send_sizes(), 
+				  d_send_buffer(),
+				  d_receive_sizes(), 
+				  d_receive_buffer );
+    MCLS_CHECK( 0 == d_receive_buffer.size() % packed_bytes );
+
+    // Unpack the received histories into the bank.
+    int num_received = d_receive_buffer.size() / packed_bytes;
+    buffer_ptr = d_receive_buffer.getRawPtr();
+    for ( int i = 0; i < num_received; ++i )
+    {
+	bank.emplace();
+	HT::unpack( bank.top(), buffer_ptr );
+	buffer_ptr += packed_bytes;
+    }
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace MCLS
+
+//---------------------------------------------------------------------------//
+
+#endif // end MCLS_BULKSYNCHRONOUSTRANSPORTER_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end MCLS_BulkSynchronousTransporter_impl.hpp
+//---------------------------------------------------------------------------//
@@ -122,7 +122,8 @@ bool ReceiveHistoryBuffer<History>::check()
 // SendHistoryBuffer functions.
 //---------------------------------------------------------------------------//
 /*!
- * \brief Post non-blocking send.
+ * \brief Post non-blocking send. Only the used portion of the buffer is
+ * sent.
  */
 template<class History>
 void SendHistoryBuffer<History>::post( int rank )
@@ -132,7 +133,8 @@ void SendHistoryBuffer<History>::post( int rank )
 
     Root::writeNumToBuffer();
     Base::d_handle = Teuchos::isend<int,char>( 
-	Teuchos::arcpFromArray(Root::d_buffer),
+	Teuchos::arcpFromArray(Root::d_buffer).persistingView(
+	    0, Root::messageSize() ),
 	rank,
 	Base::d_nonblocking_tag,
 	*Base::d_comm );
@@ -38,11 +38,14 @@
  */
 //---------------------------------------------------------------------------//
 
+#include <algorithm>
+
 #include "MCLS_CommTools.hpp"
 #include "MCLS_DBC.hpp"
 
 #ifdef HAVE_MPI
 #include <Teuchos_DefaultMpiComm.hpp>
+#include <Teuchos_OpaqueWrapper.hpp>
 #endif
 
 namespace MCLS
@@ -75,6 +78,67 @@ CommTools::isRequestComplete( Teuchos::RCP<Teuchos::CommRequest<int> >& handle )
     return is_complete;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Wait for a comm request to complete. A null request is complete. The
+ * handle is null on return.
+ */
+void CommTools::waitRequest( Teuchos::RCP<Teuchos::CommRequest<int> >& handle )
+{
+#ifdef HAVE_MPI
+    if ( Teuchos::nonnull(handle) )
+    {
+	Teuchos::RCP<Teuchos::MpiCommRequestBase<int> > handle_base =
+	    Teuchos::rcp_dynamic_cast<Teuchos::MpiCommRequestBase<int> >(handle);
+	MCLS_CHECK( Teuchos::nonnull(handle_base) );
+	MPI_Request raw_request = handle_base->releaseRawMpiRequest();
+	MPI_Status raw_status;
+	const int error = MPI_Wait( &raw_request, &raw_status );
+	MCLS_INSIST( MPI_SUCCESS == error, "Request wait failed" );
+    }
+#endif
+
+    handle = Teuchos::null;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Start a non-blocking all-reduce sum for a given buffer. Neither
+ * buffer may be accessed until the returned request has completed. Serial
+ * communicators complete the reduction immediately and return a null
+ * request.
+ */
+Teuchos::RCP<Teuchos::CommRequest<int> >
+CommTools::iallReduceSum( const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+			  const int count,
+			  const double send_buffer[],
+			  double global_reducts[] )
+{
+#ifdef HAVE_MPI
+    const Teuchos::RCP<const Teuchos::MpiComm<int> > mpi_comm =
+	Teuchos::rcp_dynamic_cast<const Teuchos::MpiComm<int> >( comm );
+    if ( Teuchos::nonnull(mpi_comm) )
+    {
+	MPI_Comm raw_mpi_comm = *( mpi_comm->getRawMpiComm() );
+	MPI_Request raw_request;
+	const int error = MPI_Iallreduce( 
+	    const_cast<double*>(send_buffer),
+	    global_reducts,
+	    count,
+	    MPI_DOUBLE,
+	    MPI_SUM,
+	    raw_mpi_comm,
+	    &raw_request );
+	MCLS_INSIST( MPI_SUCCESS == error, "Non-blocking reduce sum failed" );
+	return Teuchos::rcp( 
+	    new Teuchos::MpiCommRequestBase<int>(raw_request) );
+    }
+#endif
+
+    std::copy( send_buffer, send_buffer+count, global_reducts );
+    return Teuchos::null;
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * \brief Do a reduce sum for a given buffer.
@@ -139,6 +203,116 @@ void CommTools::reduceSum<double>(
 #endif
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Create a communicator for neighborhood collectives over the given
+ * receive and send neighbor ranks. Neighbors in the neighborhood collectives
+ * are ordered as given here.
+ */
+Teuchos::RCP<const Teuchos::Comm<int> >
+CommTools::createNeighborComm( 
+    const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+    const Teuchos::ArrayView<const int>& receive_ranks,
+    const Teuchos::ArrayView<const int>& send_ranks )
+{
+#ifdef HAVE_MPI
+    const Teuchos::RCP<const Teuchos::MpiComm<int> > mpi_comm =
+	Teuchos::rcp_dynamic_cast<const Teuchos::MpiComm<int> >( comm );
+    if ( Teuchos::nonnull(mpi_comm) )
+    {
+	MPI_Comm raw_mpi_comm = *( mpi_comm->getRawMpiComm() );
+	MPI_Comm raw_neighbor_comm;
+	const int error = MPI_Dist_graph_create_adjacent(
+	    raw_mpi_comm,
+	    receive_ranks.size(),
+	    const_cast<int*>(receive_ranks.getRawPtr()),
+	    MPI_UNWEIGHTED,
+	    send_ranks.size(),
+	    const_cast<int*>(send_ranks.getRawPtr()),
+	    MPI_UNWEIGHTED,
+	    MPI_INFO_NULL,
+	    0,
+	    &raw_neighbor_comm );
+	MCLS_INSIST( MPI_SUCCESS == error, "Neighbor comm creation failed" );
+	return Teuchos::createMpiComm<int>( 
+	    Teuchos::opaqueWrapper(raw_neighbor_comm, MPI_Comm_free) );
+    }
+#endif
+
+    MCLS_REQUIRE( receive_ranks.empty() );
+    MCLS_REQUIRE( send_ranks.empty() );
+    return comm;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Exchange variable size byte messages with all neighbors of a
+ * neighborhood communicator. 
+ *
+ * The send buffer holds the message for each send neighbor in order. The
+ * message sizes are exchanged first and the receive buffer is sized to hold
+ * the message from each receive neighbor in order.
+ */
+void CommTools::neighborAlltoallv( 
+    const Teuchos::RCP<const Teuchos::Comm<int> >& neighbor_comm,
+    const Teuchos::ArrayView<const int>& send_sizes,
+    const Teuchos::ArrayView<const char>& send_buffer,
+    const Teuchos::ArrayView<int>& receive_sizes,
+    Teuchos::Array<char>& receive_buffer )
+{
+#ifdef HAVE_MPI
+    const Teuchos::RCP<const Teuchos::MpiComm<int> > mpi_comm =
+	Teuchos::rcp_dynamic_cast<const Teuchos::MpiComm<int> >( 
+	    neighbor_comm );
+    if ( Teuchos::nonnull(mpi_comm) )
+    {
+	MPI_Comm raw_mpi_comm = *( mpi_comm->getRawMpiComm() );
+
+	// Exchange the message sizes.
+	int error = MPI_Neighbor_alltoall( 
+	    const_cast<int*>(send_sizes.getRawPtr()), 1, MPI_INT,
+	    receive_sizes.getRawPtr(), 1, MPI_INT,
+	    raw_mpi_comm );
+	MCLS_INSIST( MPI_SUCCESS == error, "Neighbor size exchange failed" );
+
+	// Compute the message displacements.
+	Teuchos::Array<int> send_displs( send_sizes.size(), 0 );
+	for ( int n = 1; n < send_sizes.size(); ++n )
+	{
+	    send_displs[n] = send_displs[n-1] + send_sizes[n-1];
+	}
+	MCLS_CHECK( send_sizes.empty() || 
+		    send_displs.back() + send_sizes.back() ==
+		    send_buffer.size() );
+	Teuchos::Array<int> receive_displs( receive_sizes.size(), 0 );
+	for ( int n = 1; n < receive_sizes.size(); ++n )
+	{
+	    receive_displs[n] = receive_displs[n-1] + receive_sizes[n-1];
+	}
+	receive_buffer.resize( receive_sizes.empty() ? 0 :
+			       receive_displs.back() + receive_sizes.back() );
+
+	// Exchange the messages.
+	error = MPI_Neighbor_alltoallv(
+	    const_cast<char*>(send_buffer.getRawPtr()), 
+	    const_cast<int*>(send_sizes.getRawPtr()),
+	    send_displs.getRawPtr(),
+	    MPI_CHAR,
+	    receive_buffer.getRawPtr(),
+	    receive_sizes.getRawPtr(),
+	    receive_displs.getRawPtr(),
+	    MPI_CHAR,
+	    raw_mpi_comm );
+	MCLS_INSIST( MPI_SUCCESS == error, "Neighbor message exchange failed" );
+	return;
+    }
+#endif
+
+    MCLS_REQUIRE( send_sizes.empty() );
+    MCLS_REQUIRE( receive_sizes.empty() );
+    receive_buffer.clear();
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace MCLS
@@ -43,6 +43,8 @@
 
 #include <Teuchos_RCP.hpp>
 #include <Teuchos_Comm.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayView.hpp>
 
 namespace MCLS
 {
@@ -60,6 +62,17 @@ class CommTools
     static bool 
     isRequestComplete( Teuchos::RCP<Teuchos::CommRequest<int> >& handle );
 
+    // Wait for a comm request to complete.
+    static void 
+    waitRequest( Teuchos::RCP<Teuchos::CommRequest<int> >& handle );
+
+    // Start a non-blocking all-reduce sum for a given buffer.
+    static Teuchos::RCP<Teuchos::CommRequest<int> >
+    iallReduceSum( const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+		   const int count,
+		   const double send_buffer[],
+		   double global_reducts[] );
+
     // Do a reduce sum for a given buffer.
     template<class Scalar>
     static void reduceSum( const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
@@ -67,6 +80,22 @@ class CommTools
                            const int count,
                            const Scalar send_buffer[],
                            Scalar global_reducts[] );
+
+    // Create a communicator for neighborhood collectives over the given
+    // receive and send neighbor ranks.
+    static Teuchos::RCP<const Teuchos::Comm<int> >
+    createNeighborComm( const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+			const Teuchos::ArrayView<const int>& receive_ranks,
+			const Teuchos::ArrayView<const int>& send_ranks );
+
+    // Exchange variable size byte messages with all neighbors of a
+    // neighborhood communicator.
+    static void neighborAlltoallv( 
+	const Teuchos::RCP<const Teuchos::Comm<int> >& neighbor_comm,
+	const Teuchos::ArrayView<const int>& send_sizes,
+	const Teuchos::ArrayView<const char>& send_buffer,
+	const Teuchos::ArrayView<int>& receive_sizes,
+	Teuchos::Array<char>& receive_buffer );
 };
 
 //---------------------------------------------------------------------------//
@@ -59,6 +59,20 @@ namespace MCLS
  * \brief Structure for communicating histories amongst domains in a set. 
  *
  * Tom Evans is responsible for the design of this class.
+ *
+ * Each send neighbor has a pool of "MC Send Buffers Per Neighbor" send
+ * buffers (2 by default). Histories are packed into the active buffer of a
+ * neighbor while previously posted buffers are in flight. When the active
+ * buffer is sent, the next buffer in the pool becomes active. That buffer
+ * is the oldest posted buffer; it is reclaimed with a check if its send has
+ * completed and only waited on otherwise.
+ *
+ * Each send neighbor also has its own buffer size that adapts to the traffic
+ * to that neighbor between "MC Min Buffer Size" and "MC Max Buffer Size"
+ * (both default to "MC Buffer Size", as does a bound of zero). The size of a
+ * neighbor is doubled when its buffer fills and halved when its buffer is
+ * sent less than half full because the process ran out of work. Buffers are
+ * allocated for the maximum size.
  */
 //---------------------------------------------------------------------------//
 template<class Domain>
@@ -124,12 +138,28 @@ class DomainCommunicator
     std::size_t maxBufferSize() const
     { return HistoryBufferType::maxNum(); }
 
+    //! Get the minimum adaptive history buffer size.
+    int minBufferSize() const
+    { return d_min_buffer_size; }
+
+    //! Get the current history buffer size of a send neighbor by local id.
+    int bufferSize( int n ) const
+    { return d_buffer_sizes[n]; }
+
+    //! Get the current history buffer sizes of all send neighbors.
+    const Teuchos::Array<int>& bufferSizes() const
+    { return d_buffer_sizes; }
+
     // Number of histories in all buffers.
     std::size_t sendBufferSize() const;
 
-    // Get a send buffer by local id.
+    // Get the active send buffer of a neighbor by local id.
     const SendBuffer& sendBuffer( int n ) const
-    { return d_sends[n]; }
+    { return d_sends[n][d_active_sends[n]]; }
+
+    //! Get the number of send buffers per neighbor.
+    int numSendBuffersPerNeighbor() const
+    { return d_num_send_buffers; }
 
     // Get a receive buffer by local id.
     const ReceiveBuffer& receiveBuffer( int n ) const
@@ -137,6 +167,10 @@ class DomainCommunicator
 
   private:
 
+    // Post the active send buffer of a neighbor and make the next buffer in
+    // its pool active.
+    void postActiveSend( const int n );
+
     // Local domain.
     Teuchos::RCP<Domain> d_domain;
 
@@ -146,8 +180,20 @@ class DomainCommunicator
     // Communicator rank.
     int d_rank;
 
-    // Send buffers.
-    Teuchos::Array<SendBuffer> d_sends;
+    // Number of send buffers per neighbor.
+    int d_num_send_buffers;
+
+    // Send buffer pools for each neighbor.
+    Teuchos::Array<Teuchos::Array<SendBuffer> > d_sends;
+
+    // Active send buffer in the pool of each neighbor.
+    Teuchos::Array<int> d_active_sends;
+
+    // Minimum adaptive history buffer size.
+    int d_min_buffer_size;
+
+    // Current history buffer size of each send neighbor.
+    Teuchos::Array<int> d_buffer_sizes;
 
     // Receive buffers.
     Teuchos::Array<ReceiveBuffer> d_receives;
@@ -41,6 +41,8 @@
 #ifndef MCLS_DOMAINCOMMUNICATOR_IMPL_HPP
 #define MCLS_DOMAINCOMMUNICATOR_IMPL_HPP
 
+#include <algorithm>
+
 #include "MCLS_DBC.hpp"
 #include "MCLS_Events.hpp"
 
@@ -61,7 +63,10 @@ DomainCommunicator<Domain>::DomainCommunicator(
     : d_domain( domain )
     , d_size( comm->getSize() )
     , d_rank( comm->getRank() )
+    , d_num_send_buffers( 2 )
     , d_sends( DT::numSendNeighbors(*d_domain) )
+    , d_active_sends( DT::numSendNeighbors(*d_domain), 0 )
+    , d_min_buffer_size( 0 )
     , d_receives( DT::numReceiveNeighbors(*d_domain) )
     , d_num_send_neighbors( DT::numSendNeighbors(*d_domain) )
     , d_num_receive_neighbors( DT::numReceiveNeighbors(*d_domain) )
@@ -74,18 +79,54 @@ DomainCommunicator<Domain>::DomainCommunicator(
     MCLS_INSIST( HT::getPackedBytes(), "Packed history size not set." );
     HistoryBufferType::setSizePackedHistory( HT::getPackedBytes() );
 
-    // Get the max number of histories that will be stored in each buffer.
+    // Get the initial number of histories that will be stored in each
+    // buffer.
+    int buffer_size = HistoryBufferType::maxNum();
     if ( plist.isParameter("MC Buffer Size") )
     {
-	HistoryBufferType::setMaxNumHistories( 
-	    plist.get<int>("MC Buffer Size") );
+	buffer_size = plist.get<int>("MC Buffer Size");
+    }
+
+    // Get the bounds on the adaptive buffer sizes. A bound of zero is unset
+    // and defaults to the initial buffer size. Buffers are allocated for the
+    // maximum size.
+    d_min_buffer_size = buffer_size;
+    if ( plist.isParameter("MC Min Buffer Size") &&
+	 plist.get<int>("MC Min Buffer Size") > 0 )
+    {
+	d_min_buffer_size = plist.get<int>("MC Min Buffer Size");
+    }
+    int max_buffer_size = buffer_size;
+    if ( plist.isParameter("MC Max Buffer Size") &&
+	 plist.get<int>("MC Max Buffer Size") > 0 )
+    {
+	max_buffer_size = plist.get<int>("MC Max Buffer Size");
+    }
+    MCLS_INSIST( 0 < d_min_buffer_size && 
+		 d_min_buffer_size <= buffer_size &&
+		 buffer_size <= max_buffer_size,
+		 "MC Buffer Size must be within the min and max buffer sizes" );
+    HistoryBufferType::setMaxNumHistories( max_buffer_size );
+    d_buffer_sizes.assign( d_num_send_neighbors, buffer_size );
+
+    // Get the number of send buffers for each neighbor.
+    if ( plist.isParameter("MC Send Buffers Per Neighbor") )
+    {
+	d_num_send_buffers = plist.get<int>("MC Send Buffers Per Neighbor");
     }
+    MCLS_INSIST( d_num_send_buffers > 0, 
+		 "MC Send Buffers Per Neighbor must be positive" );
 
     // Allocate the send buffers and set their communicators.
     for ( int n = 0; n < d_num_send_neighbors; ++n )
     {
-	d_sends[n].setComm( comm );
-	d_sends[n].allocate();
+	d_sends[n].resize( d_num_send_buffers );
+	for ( int b = 0; b < d_num_send_buffers; ++b )
+	{
+	    d_sends[n][b].setComm( comm );
+	    d_sends[n][b].allocate();
+	    d_sends[n][b].setCapacity( d_buffer_sizes[n] );
+	}
     }
 
     // Allocate the receive buffers and set their communicators.
@@ -112,26 +153,26 @@ DomainCommunicator<Domain>::communicate(
     d_result.sent = false;
     d_result.destination = 0;
 
-    // Add the history to the appropriate buffer.
+    // Add the history to the active buffer of the owning neighbor.
     int neighbor_id = DT::owningNeighbor( *d_domain, HT::globalState(history) );
-    d_sends[neighbor_id].bufferHistory( history );
+    SendBuffer& buffer = d_sends[neighbor_id][d_active_sends[neighbor_id]];
+    buffer.bufferHistory( history );
 
     // Update the result destination.
     d_result.destination = DT::sendNeighborRank( *d_domain, neighbor_id );
     MCLS_CHECK( d_result.destination < d_size );
 
-    // If the buffer is full send it.
-    if ( d_sends[neighbor_id].isFull() )
+    // If the buffer is full send it. Transport continues with the next
+    // buffer in the pool while this one is in flight. A full buffer means
+    // the neighbor is busy so it gets a larger buffer.
+    if ( buffer.isFull() )
     {
-	MCLS_CHECK( d_sends[neighbor_id].numHistories() == 
-	       Teuchos::as<int>(maxBufferSize()) );
+	MCLS_CHECK( buffer.numHistories() == d_buffer_sizes[neighbor_id] );
 
-	d_sends[neighbor_id].post( d_result.destination );
-	d_sends[neighbor_id].wait();
-
-	MCLS_CHECK( d_sends[neighbor_id].isEmpty() );
-	MCLS_CHECK( d_sends[neighbor_id].allocatedSize() > 0 );
-	MCLS_CHECK( !d_sends[neighbor_id].status() );
+	d_buffer_sizes[neighbor_id] = 
+	    std::min( 2*d_buffer_sizes[neighbor_id],
+		      Teuchos::as<int>(maxBufferSize()) );
+	postActiveSend( neighbor_id );
 
 	d_result.sent = true;
     }
@@ -142,7 +183,11 @@ DomainCommunicator<Domain>::communicate(
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Send all buffers that are not empty.
+ * \brief Send all buffers that are not empty. The sends are not waited on.
+ *
+ * This is called when the process is out of work. A buffer sent less than
+ * half full means the neighbor was waiting on a buffer that was too large so
+ * it gets a smaller buffer.
  */
 template<class Domain>
 int DomainCommunicator<Domain>::send()
@@ -151,23 +196,23 @@ int DomainCommunicator<Domain>::send()
 
     for ( int n = 0; n < d_num_send_neighbors; ++n )
     {
-	MCLS_CHECK( d_sends[n].allocatedSize() > 0 );
 	MCLS_CHECK( DT::sendNeighborRank(*d_domain,n) < d_size );
 
-	if( !d_sends[n].isEmpty() )
+	if( !d_sends[n][d_active_sends[n]].isEmpty() )
 	{
-	    MCLS_CHECK( d_sends[n].numHistories() > 0 );
-
-	    num_sent += d_sends[n].numHistories();
-	    d_sends[n].post( DT::sendNeighborRank(*d_domain,n) );
-	    d_sends[n].wait();
-
+	    num_sent += d_sends[n][d_active_sends[n]].numHistories();
+	    if ( 2*d_sends[n][d_active_sends[n]].numHistories() < 
+		 d_buffer_sizes[n] )
+	    {
+		d_buffer_sizes[n] = 
+		    std::max( d_buffer_sizes[n] / 2, d_min_buffer_size );
+	    }
+	    postActiveSend( n );
 	    MCLS_CHECK( num_sent > 0 );
 	}
 
-	MCLS_ENSURE( d_sends[n].isEmpty() );
-	MCLS_ENSURE( d_sends[n].allocatedSize() > 0 );
-	MCLS_ENSURE( !d_sends[n].status() );
+	MCLS_ENSURE( d_sends[n][d_active_sends[n]].isEmpty() );
+	MCLS_ENSURE( !d_sends[n][d_active_sends[n]].status() );
     }
 
     return num_sent;
@@ -175,7 +220,8 @@ int DomainCommunicator<Domain>::send()
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Send all buffers whether they are empty or not.
+ * \brief Send all buffers whether they are empty or not and wait on all
+ * outstanding sends to complete.
  */
 template<class Domain>
 int DomainCommunicator<Domain>::flush()
@@ -184,16 +230,22 @@ int DomainCommunicator<Domain>::flush()
 
     for ( int n = 0; n < d_num_send_neighbors; ++n )
     {
-	MCLS_CHECK( d_sends[n].allocatedSize() > 0 );
 	MCLS_CHECK( DT::sendNeighborRank(*d_domain,n) < d_size );
 
-	num_sent += d_sends[n].numHistories();
-	d_sends[n].post( DT::sendNeighborRank(*d_domain,n) );
-	d_sends[n].wait();
+	num_sent += d_sends[n][d_active_sends[n]].numHistories();
+	postActiveSend( n );
 
-	MCLS_ENSURE( d_sends[n].isEmpty() );
-	MCLS_ENSURE( d_sends[n].allocatedSize() > 0 );
-	MCLS_ENSURE( !d_sends[n].status() );
+	for ( int b = 0; b < d_num_send_buffers; ++b )
+	{
+	    if ( d_sends[n][b].status() )
+	    {
+		d_sends[n][b].wait();
+	    }
+
+	    MCLS_ENSURE( d_sends[n][b].isEmpty() );
+	    MCLS_ENSURE( d_sends[n][b].allocatedSize() > 0 );
+	    MCLS_ENSURE( !d_sends[n][b].status() );
+	}
     }
 
     return num_sent;
@@ -278,18 +330,24 @@ int DomainCommunicator<Domain>::checkAndPost( BankType& bank )
 /*!
  * \brief Status of send buffers.
  *
- * Return true only if all send buffers are on.
+ * Return true only if all send neighbors have a send buffer on.
  */
 template<class Domain>
 bool DomainCommunicator<Domain>::sendStatus()
 {
     if ( d_num_send_neighbors == 0 ) return false;
       
+    bool neighbor_status = false;
     for ( int n = 0; n < d_num_send_neighbors; ++n )
     {
-	MCLS_CHECK( d_sends[n].allocatedSize() > 0 );
+	neighbor_status = false;
+	for ( int b = 0; b < d_num_send_buffers; ++b )
+	{
+	    MCLS_CHECK( d_sends[n][b].allocatedSize() > 0 );
+	    neighbor_status = neighbor_status || d_sends[n][b].status();
+	}
 
-	if ( !d_sends[n].status() ) 
+	if ( !neighbor_status ) 
 	{
 	    return false;
 	}
@@ -361,14 +419,46 @@ std::size_t DomainCommunicator<Domain>::sendBufferSize() const
 
     for ( int n = 0; n < d_num_send_neighbors; ++n )
     {
-	MCLS_CHECK( d_sends[n].allocatedSize() > 0 );
+	MCLS_CHECK( d_sends[n][d_active_sends[n]].allocatedSize() > 0 );
 
-	send_num += d_sends[n].numHistories();
+	send_num += d_sends[n][d_active_sends[n]].numHistories();
     }
 
     return send_num;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Post the active send buffer of a neighbor and make the next buffer
+ * in its pool active.
+ *
+ * Buffers are posted in pool order so the next buffer is the oldest one
+ * posted. If its send has completed it is reclaimed, otherwise we wait on it.
+ * The next buffer gets the current buffer size of the neighbor.
+ */
+template<class Domain>
+void DomainCommunicator<Domain>::postActiveSend( const int n )
+{
+    MCLS_REQUIRE( n < d_num_send_neighbors );
+    MCLS_REQUIRE( !d_sends[n][d_active_sends[n]].status() );
+
+    d_sends[n][d_active_sends[n]].post( DT::sendNeighborRank(*d_domain,n) );
+
+    d_active_sends[n] = (d_active_sends[n] + 1) % d_num_send_buffers;
+    SendBuffer& buffer = d_sends[n][d_active_sends[n]];
+    if ( buffer.status() && !buffer.check() )
+    {
+	buffer.wait();
+    }
+
+    buffer.setCapacity( d_buffer_sizes[n] );
+
+    MCLS_ENSURE( buffer.isEmpty() );
+    MCLS_ENSURE( buffer.allocatedSize() > 0 );
+    MCLS_ENSURE( !buffer.status() );
+    MCLS_ENSURE( buffer.capacity() == d_buffer_sizes[n] );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace MCLS
@@ -99,6 +99,15 @@ class DomainTraits
 	UndefinedDomainTraits<Domain>::notDefined(); 
     }
 
+    /*!
+     * \brief Set the source weight against which the weight cutoff is
+     * applied.
+     */
+    static void setSourceWeight( Domain& domain, const double source_weight )
+    {
+	UndefinedDomainTraits<Domain>::notDefined(); 
+    }
+
     /*!
      * \brief Given a history with a global state in the local domain, set the
      * local state of that history.
@@ -119,6 +128,25 @@ class DomainTraits
 	UndefinedDomainTraits<Domain>::notDefined(); 
     }
 
+    /*!
+     * \brief Process a batch of histories through a transition in the local
+     * domain to new states. The history ids and step counts of the batch key
+     * the random numbers of each history. The local states, global states,
+     * and weights of the batch are updated in place. The work array is of
+     * the batch size and its contents are overwritten.
+     */
+    static inline void processTransitions( 
+	const Domain& domain,
+	const Teuchos::ArrayView<const std::size_t>& history_ids,
+	const Teuchos::ArrayView<const int>& steps,
+	const Teuchos::ArrayView<int>& local_states,
+	const Teuchos::ArrayView<ordinal_type>& global_states,
+	const Teuchos::ArrayView<double>& weights,
+	const Teuchos::ArrayView<double>& work )
+    { 
+	UndefinedDomainTraits<Domain>::notDefined(); 
+    }
+
     /*!
      * \brief Deterimine if a history should be terminated.
      */
@@ -156,6 +184,37 @@ class DomainTraits
 	return false;
     }
 
+    /*!
+     * \brief Determine if a local state is in the local domain. A history
+     * that has transitioned out of the local domain has an invalid local
+     * state.
+     */
+    static inline bool isLocalState( const Domain& domain, 
+				     const int local_state )
+    { 
+	UndefinedDomainTraits<Domain>::notDefined(); 
+	return false;
+    }
+
+    /*!
+     * \brief Get the largest global state in the local domain.
+     */
+    static inline ordinal_type maxLocalState( const Domain& domain )
+    { 
+	UndefinedDomainTraits<Domain>::notDefined(); 
+	return 0;
+    }
+
+    /*!
+     * \brief Get the maximum number of steps a history may take in the
+     * domain.
+     */
+    static inline int historyLength( const Domain& domain )
+    { 
+	UndefinedDomainTraits<Domain>::notDefined(); 
+	return 0;
+    }
+
     /*!
      * \brief Get the number of neighbors from which this domain will
      * receive. 
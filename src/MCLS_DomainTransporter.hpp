@@ -46,6 +46,8 @@
 #include <MCLS_HistoryTraits.hpp>
 
 #include <Teuchos_RCP.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayView.hpp>
 
 namespace MCLS
 {
@@ -55,7 +57,17 @@ namespace MCLS
  * \class DomainTransporter
  * \brief Local domain transport kernel.
  *
- * This class does no communication.
+ * This class does no communication. Histories may be transported one at a
+ * time or as a batch. A batch is advanced in lockstep with its transition
+ * data held as a struct of arrays such that random numbers are generated in
+ * blocks and the weight update is a contiguous element-wise operation. The
+ * history ids and step counts of the batch are carried with the transition
+ * data such that the domain may key the random numbers of each history.
+ *
+ * Histories and batches are transported on the calling thread. The global
+ * transporters run this kernel concurrently from worker threads that pull
+ * histories from the source and the bank. Each thread has its own batch
+ * work arrays, random number stream, tally buffer, and completion counts.
  */
 template<class Domain>
 class DomainTransporter
@@ -66,6 +78,7 @@ class DomainTransporter
     //! Typedefs.
     typedef Domain                                    domain_type;
     typedef DomainTraits<Domain>                      DT;
+    typedef typename DT::ordinal_type                 Ordinal;
     typedef typename DT::history_type                 HistoryType;
     typedef HistoryTraits<HistoryType>                HT;
     typedef typename DT::tally_type                   TallyType;
@@ -78,13 +91,60 @@ class DomainTransporter
     // Transport a history through the domain.
     void transport( HistoryType& history );
 
+    // Transport a batch of histories through the domain.
+    void transport( const Teuchos::ArrayView<HistoryType>& histories );
+
+    // Reset the transport statistics.
+    void resetStatistics();
+
+    // Rebind the domain tally.
+    void updateTally();
+
+    // Get the number of histories completed in this domain.
+    long numCompletedHistories() const;
+
+    // Get the total number of steps of the histories completed in this
+    // domain.
+    long numCompletedSteps() const;
+
   private:
 
+    // Transport a batch of histories on a single thread.
+    void transportBatch( const Teuchos::ArrayView<HistoryType>& histories,
+			 const int thread_id );
+
     // Local domain.
     Teuchos::RCP<Domain> d_domain;
 
     // Domain tally.
     Teuchos::RCP<TallyType> d_tally;
+
+    // Batch indices of the active histories for each thread.
+    Teuchos::Array<Teuchos::Array<int> > d_batch_ids;
+
+    // Source-assigned history ids of the active histories for each thread.
+    Teuchos::Array<Teuchos::Array<std::size_t> > d_batch_history_ids;
+
+    // Step counts of the active histories for each thread.
+    Teuchos::Array<Teuchos::Array<int> > d_batch_steps;
+
+    // Batch local states of the active histories for each thread.
+    Teuchos::Array<Teuchos::Array<int> > d_batch_local_states;
+
+    // Batch global states of the active histories for each thread.
+    Teuchos::Array<Teuchos::Array<Ordinal> > d_batch_global_states;
+
+    // Batch weights of the active histories for each thread.
+    Teuchos::Array<Teuchos::Array<double> > d_batch_weights;
+
+    // Batch work array for each thread.
+    Teuchos::Array<Teuchos::Array<double> > d_batch_work;
+
+    // Number of histories completed by each thread.
+    Teuchos::Array<long> d_num_completed;
+
+    // Total number of steps of the histories completed by each thread.
+    Teuchos::Array<long> d_num_completed_steps;
 };
 
 //---------------------------------------------------------------------------//
@@ -42,9 +42,13 @@
 #define MCLS_DOMAINTRANSPORTER_IMPL_HPP
 
 #include <limits>
+#include <algorithm>
+#include <numeric>
 
+#include "MCLS_config.hpp"
 #include "MCLS_DBC.hpp"
 #include "MCLS_Events.hpp"
+#include "MCLS_ThreadTools.hpp"
 
 namespace MCLS
 {
@@ -58,6 +62,15 @@ DomainTransporter<Domain>::DomainTransporter(
     const Teuchos::RCP<Domain>& domain )
     : d_domain( domain )
     , d_tally( DT::domainTally(*d_domain) )
+    , d_batch_ids( ThreadTools::maxThreads() )
+    , d_batch_history_ids( ThreadTools::maxThreads() )
+    , d_batch_steps( ThreadTools::maxThreads() )
+    , d_batch_local_states( ThreadTools::maxThreads() )
+    , d_batch_global_states( ThreadTools::maxThreads() )
+    , d_batch_weights( ThreadTools::maxThreads() )
+    , d_batch_work( ThreadTools::maxThreads() )
+    , d_num_completed( ThreadTools::maxThreads(), 0 )
+    , d_num_completed_steps( ThreadTools::maxThreads(), 0 )
 {
     MCLS_REQUIRE( Teuchos::nonnull(d_domain) );
     MCLS_REQUIRE( Teuchos::nonnull(d_tally) );
@@ -65,20 +78,26 @@ DomainTransporter<Domain>::DomainTransporter(
 
 //---------------------------------------------------------------------------//
 /*
- * \brief Transport a history through the domain.
+ * \brief Transport a history through the domain on the calling thread.
  */
 template<class Domain>
 void DomainTransporter<Domain>::transport( HistoryType& history )
 {
+    int thread_id = ThreadTools::threadId();
+    MCLS_REQUIRE( thread_id < d_num_completed.size() );
     MCLS_REQUIRE( HT::alive(history) );
     MCLS_CHECK( DT::isGlobalState(*d_domain, HT::globalState(history)) );
 
-    // Set the history to transition.
-    HT::setEvent( history, Event::TRANSITION );
-
     // Set the local state of the history.
     DT::setHistoryLocalState( *d_domain, history );
 
+    // Tally the history as it enters the domain. The history event still
+    // indicates where it came from.
+    TT::tallyHistory( *d_tally, history );
+
+    // Set the history to transition.
+    HT::setEvent( history, Event::TRANSITION );
+
     // While the history is alive inside of this domain, transport it. If the
     // history leaves this domain, it is not alive with respect to this
     // domain. 
@@ -89,9 +108,6 @@ void DomainTransporter<Domain>::transport( HistoryType& history )
 	MCLS_CHECK( HT::weightAbs(history) < std::numeric_limits<double>::max() );
 	MCLS_CHECK( DT::isGlobalState(*d_domain, HT::globalState(history)) );
 
-	// Tally the history.
-	TT::tallyHistory( *d_tally, history );
-
 	// Transition the history one step.
 	DT::processTransition( *d_domain, history );
 
@@ -103,21 +119,205 @@ void DomainTransporter<Domain>::transport( HistoryType& history )
 	    HT::setEvent( history, Event::CUTOFF );
 	    HT::kill( history );
 	    TT::postProcessHistory( *d_tally, history );
+	    ++d_num_completed[thread_id];
+	    d_num_completed_steps[thread_id] += HT::numSteps( history );
 	}
 
 	// If the history has left the domain, kill it. The history will
 	// continue in a different domain.
-	else if ( DT::isBoundaryState(*d_domain,HT::globalState(history)) )
+	else if ( !DT::isLocalState(*d_domain,HT::localState(history)) )
 	{
+	    MCLS_CHECK( DT::isBoundaryState(*d_domain,HT::globalState(history)) );
             HT::setEvent( history, Event::BOUNDARY );
             HT::kill( history );
 	}
+
+	// Otherwise tally the history in its new state.
+	else
+	{
+	    TT::tallyHistory( *d_tally, history );
+	}
     }
 
     MCLS_ENSURE( !HT::alive(history) );
     MCLS_ENSURE( Event::TRANSITION != HT::event(history) );
 }
 
+//---------------------------------------------------------------------------//
+/*
+ * \brief Transport a batch of histories through the domain on the calling
+ * thread.
+ *
+ * The histories are advanced in lockstep and produce the same estimator as
+ * transporting them one at a time.
+ */
+template<class Domain>
+void DomainTransporter<Domain>::transport( 
+    const Teuchos::ArrayView<HistoryType>& histories )
+{
+    transportBatch( histories, ThreadTools::threadId() );
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Transport a batch of histories on a single thread.
+ *
+ * Histories that are killed are compacted out of the thread's batch work
+ * arrays at the end of each step.
+ */
+template<class Domain>
+void DomainTransporter<Domain>::transportBatch( 
+    const Teuchos::ArrayView<HistoryType>& histories,
+    const int thread_id )
+{
+    MCLS_REQUIRE( thread_id < d_batch_ids.size() );
+
+    Teuchos::Array<int>& batch_ids = d_batch_ids[thread_id];
+    Teuchos::Array<std::size_t>& batch_history_ids = 
+	d_batch_history_ids[thread_id];
+    Teuchos::Array<int>& batch_steps = d_batch_steps[thread_id];
+    Teuchos::Array<int>& batch_local_states = 
+	d_batch_local_states[thread_id];
+    Teuchos::Array<Ordinal>& batch_global_states = 
+	d_batch_global_states[thread_id];
+    Teuchos::Array<double>& batch_weights = d_batch_weights[thread_id];
+    Teuchos::Array<double>& batch_work = d_batch_work[thread_id];
+
+    int num_active = histories.size();
+
+    // Size the batch work arrays.
+    batch_ids.resize( num_active );
+    batch_history_ids.resize( num_active );
+    batch_steps.resize( num_active );
+    batch_local_states.resize( num_active );
+    batch_global_states.resize( num_active );
+    batch_weights.resize( num_active );
+    batch_work.resize( num_active );
+
+    // Gather the histories into the batch and tally them as they enter the
+    // domain.
+    for ( int i = 0; i < num_active; ++i )
+    {
+	MCLS_REQUIRE( HT::alive(histories[i]) );
+	MCLS_CHECK( DT::isGlobalState(*d_domain, 
+				      HT::globalState(histories[i])) );
+
+	DT::setHistoryLocalState( *d_domain, histories[i] );
+	TT::tallyHistory( *d_tally, histories[i] );
+	HT::setEvent( histories[i], Event::TRANSITION );
+
+	batch_ids[i] = i;
+	batch_history_ids[i] = HT::historyId( histories[i] );
+	batch_steps[i] = HT::numSteps( histories[i] );
+	batch_local_states[i] = HT::localState( histories[i] );
+	batch_global_states[i] = HT::globalState( histories[i] );
+	batch_weights[i] = HT::weight( histories[i] );
+    }
+
+    // Transport the batch until all histories have been killed.
+    int num_alive = 0;
+    while ( num_active > 0 )
+    {
+	// Transition the histories one step.
+	DT::processTransitions( *d_domain,
+				batch_history_ids(0,num_active).getConst(),
+				batch_steps(0,num_active).getConst(),
+				batch_local_states(0,num_active),
+				batch_global_states(0,num_active),
+				batch_weights(0,num_active),
+				batch_work(0,num_active) );
+
+	// Update the histories with the new transition data. Kill those that
+	// have met the termination condition or left the domain and compact
+	// the remaining histories to the front of the batch and tally them.
+	num_alive = 0;
+	for ( int i = 0; i < num_active; ++i )
+	{
+	    HistoryType& history = histories[ batch_ids[i] ];
+	    HT::setLocalState( history, batch_local_states[i] );
+	    HT::setGlobalState( history, batch_global_states[i] );
+	    HT::setWeight( history, batch_weights[i] );
+	    HT::addStep( history );
+	    batch_steps[i] = HT::numSteps( history );
+
+	    if ( DT::terminateHistory(*d_domain,history) )
+	    {
+		HT::setEvent( history, Event::CUTOFF );
+		HT::kill( history );
+		TT::postProcessHistory( *d_tally, history );
+		++d_num_completed[thread_id];
+		d_num_completed_steps[thread_id] += HT::numSteps( history );
+	    }
+	    else if ( !DT::isLocalState(*d_domain,batch_local_states[i]) )
+	    {
+		MCLS_CHECK( DT::isBoundaryState(*d_domain,
+						HT::globalState(history)) );
+		HT::setEvent( history, Event::BOUNDARY );
+		HT::kill( history );
+	    }
+	    else
+	    {
+		MCLS_CHECK( Event::TRANSITION == HT::event(history) );
+		TT::tallyHistory( *d_tally, history );
+		batch_ids[num_alive] = batch_ids[i];
+		batch_history_ids[num_alive] = batch_history_ids[i];
+		batch_steps[num_alive] = batch_steps[i];
+		batch_local_states[num_alive] = batch_local_states[i];
+		batch_global_states[num_alive] = batch_global_states[i];
+		batch_weights[num_alive] = batch_weights[i];
+		++num_alive;
+	    }
+	}
+	num_active = num_alive;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Reset the transport statistics.
+ */
+template<class Domain>
+void DomainTransporter<Domain>::resetStatistics()
+{
+    std::fill( d_num_completed.begin(), d_num_completed.end(), 0 );
+    std::fill( d_num_completed_steps.begin(), d_num_completed_steps.end(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Rebind the domain tally. A domain whose values were refilled may
+ * have rebuilt its tally for a new solution vector.
+ */
+template<class Domain>
+void DomainTransporter<Domain>::updateTally()
+{
+    d_tally = DT::domainTally( *d_domain );
+    MCLS_ENSURE( Teuchos::nonnull(d_tally) );
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Get the number of histories completed in this domain.
+ */
+template<class Domain>
+long DomainTransporter<Domain>::numCompletedHistories() const
+{
+    return std::accumulate( d_num_completed.begin(), 
+			    d_num_completed.end(), 0L );
+}
+
+//---------------------------------------------------------------------------//
+/*
+ * \brief Get the total number of steps of the histories completed in this
+ * domain. 
+ */
+template<class Domain>
+long DomainTransporter<Domain>::numCompletedSteps() const
+{
+    return std::accumulate( d_num_completed_steps.begin(), 
+			    d_num_completed_steps.end(), 0L );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace MCLS
@@ -118,6 +118,11 @@ class FixedPointSolverManager : public SolverManager<Vector,Matrix>
     bool getConvergedStatus() const 
     { return Teuchos::as<bool>(d_converged_status); }
 
+  private:
+
+    // Build the work vectors.
+    void buildWorkVectors();
+
   private:
 
     // Linear problem
@@ -129,6 +134,12 @@ class FixedPointSolverManager : public SolverManager<Vector,Matrix>
     // Fixed point iteration.
     Teuchos::RCP<FixedPointType> d_fixed_point;
 
+    // Preconditioned source work vector.
+    Teuchos::RCP<Vector> d_source_work;
+
+    // Right preconditioner work vector.
+    Teuchos::RCP<Vector> d_work;
+
     // Number of iterations from last solve.
     int d_num_iters;
 
@@ -97,6 +97,8 @@ FixedPointSolverManager<Vector,Matrix>::FixedPointSolverManager(
     d_fixed_point = 
         fp_factory.create( iteration_name, d_plist );
     d_fixed_point->setProblem( d_problem );   
+
+    buildWorkVectors();
 }
 
 //---------------------------------------------------------------------------//
@@ -142,9 +144,8 @@ FixedPointSolverManager<Vector,Matrix>::achievedTol() const
     typename Teuchos::ScalarTraits<Scalar>::magnitudeType source_norm = 0;
     if ( d_problem->isLeftPrec() )
     {
-        Teuchos::RCP<Vector> tmp = VT::clone( *d_problem->getRHS() );
-        d_problem->applyLeftPrec( *d_problem->getRHS(), *tmp );
-        source_norm = VT::normInf( *tmp );
+        d_problem->applyLeftPrec( *d_problem->getRHS(), *d_source_work );
+        source_norm = VT::normInf( *d_source_work );
     }
     else
     {
@@ -184,6 +185,8 @@ void FixedPointSolverManager<Vector,Matrix>::setProblem(
         fp_factory.create( iteration_name, d_plist );
 
     d_fixed_point->setProblem( d_problem );
+
+    buildWorkVectors();
 }
 
 //---------------------------------------------------------------------------//
@@ -228,9 +231,8 @@ bool FixedPointSolverManager<Vector,Matrix>::solve()
     // Compute the source norm preconditioned if necessary.
     if ( d_problem->isLeftPrec() )
     {
-        Teuchos::RCP<Vector> tmp = VT::clone( *d_problem->getRHS() );
-        d_problem->applyLeftPrec( *d_problem->getRHS(), *tmp );
-        source_norm = VT::normInf( *tmp );
+        d_problem->applyLeftPrec( *d_problem->getRHS(), *d_source_work );
+        source_norm = VT::normInf( *d_source_work );
     }
     else
     {
@@ -302,12 +304,11 @@ bool FixedPointSolverManager<Vector,Matrix>::solve()
     // Recover the original solution if right preconditioned.
     if ( d_problem->isRightPrec() )
     {
-            Teuchos::RCP<Vector> temp = VT::clone(*d_problem->getLHS());
 	    d_problem->applyRightPrec( *d_problem->getLHS(),
-                                       *temp );
+                                       *d_work );
             VT::update( *d_problem->getLHS(),
                         Teuchos::ScalarTraits<Scalar>::zero(),
-                        *temp,
+                        *d_work,
                         Teuchos::ScalarTraits<Scalar>::one() );
     }
 
@@ -320,6 +321,23 @@ bool FixedPointSolverManager<Vector,Matrix>::solve()
     return Teuchos::as<bool>(d_converged_status);
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Build the work vectors. These are rebuilt only when the linear
+ * problem is set.
+ */
+template<class Vector, class Matrix>
+void FixedPointSolverManager<Vector,Matrix>::buildWorkVectors()
+{
+    MCLS_REQUIRE( Teuchos::nonnull(d_problem) );
+
+    d_source_work = VT::clone( *d_problem->getRHS() );
+    d_work = VT::clone( *d_problem->getLHS() );
+
+    MCLS_ENSURE( Teuchos::nonnull(d_source_work) );
+    MCLS_ENSURE( Teuchos::nonnull(d_work) );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace MCLS
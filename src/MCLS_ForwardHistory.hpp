@@ -90,6 +90,12 @@ class ForwardHistory : public History<Ordinal>
     // Pack the history into a buffer.
     Teuchos::Array<char> pack() const;
 
+    // Pack the history in place into a buffer of the packed history size.
+    void pack( char* buffer ) const;
+
+    // Unpack the history in place from a buffer of the packed history size.
+    void unpack( char* buffer );
+
     //! Set the history starting state in global indexing.
     inline void setStartingState( const Ordinal starting_state )
     { d_starting_state = starting_state; }
@@ -109,7 +115,9 @@ class ForwardHistory : public History<Ordinal>
   public:
 
     // Set the byte size of the packed history state.
-    static void setByteSize();
+    static void setByteSize( const bool compact_states = false,
+			     const bool compact_steps = false,
+			     const bool history_ids = false );
 
     // Get the number of bytes in the packed history state.
     static std::size_t getPackedBytes();
@@ -159,6 +167,24 @@ class HistoryTraits<ForwardHistory<Ordinal> >
 	return history.pack();
     }
 
+    /*!
+     * \brief Pack the history in place into a buffer of the packed history
+     * size.
+     */
+    static void pack( const history_type& history, char* buffer )
+    {
+	history.pack( buffer );
+    }
+
+    /*!
+     * \brief Unpack a history in place from a buffer of the packed history
+     * size.
+     */
+    static void unpack( history_type& history, char* buffer )
+    {
+	history.unpack( buffer );
+    }
+
     /*!
      * \brief Set the state of a history in global indexing.
      */
@@ -277,9 +303,11 @@ class HistoryTraits<ForwardHistory<Ordinal> >
     /*!
      * \brief Set the byte size of the packed history state.
      */
-    static inline void setByteSize()
+    static inline void setByteSize( const bool compact_states = false,
+				    const bool compact_steps = false,
+				    const bool history_ids = false )
     {
-	history_type::setByteSize();
+	history_type::setByteSize( compact_states, compact_steps, history_ids );
     }
 
     /*!
@@ -305,6 +333,23 @@ class HistoryTraits<ForwardHistory<Ordinal> >
     {
 	return history.numSteps();
     }
+
+    /*!
+     * \brief Set the source-assigned id of the history.
+     */
+    static inline void setHistoryId( history_type& history,
+				     const std::size_t history_id )
+    {
+	history.setHistoryId( history_id );
+    }
+
+    /*!
+     * \brief Get the source-assigned id of the history.
+     */
+    static inline std::size_t historyId( const history_type& history )
+    {
+	return history.historyId();
+    }
 };
 
 //---------------------------------------------------------------------------//
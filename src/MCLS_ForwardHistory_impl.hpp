@@ -59,11 +59,7 @@ ForwardHistory<Ordinal>::ForwardHistory(
     const Teuchos::ArrayView<char>& buffer )
 {
     MCLS_REQUIRE( Teuchos::as<std::size_t>(buffer.size()) == d_packed_bytes );
-    Deserializer ds;
-    ds.setBuffer( buffer );
-    this->unpackHistory( ds );
-    ds >> d_starting_state >> d_history_tally;
-    MCLS_ENSURE( ds.getPtr() == ds.end() );
+    unpack( buffer.getRawPtr() );
 }
 
 //---------------------------------------------------------------------------//
@@ -73,15 +69,46 @@ ForwardHistory<Ordinal>::ForwardHistory(
 template<class Ordinal>
 Teuchos::Array<char> ForwardHistory<Ordinal>::pack() const
 {
-    MCLS_REQUIRE( d_packed_bytes );
     MCLS_REQUIRE( d_packed_bytes > 0 );
     Teuchos::Array<char> buffer( d_packed_bytes );
+    pack( buffer.getRawPtr() );
+    return buffer;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Pack the history in place into a buffer of the packed history
+ * size.
+ */
+template<class Ordinal>
+void ForwardHistory<Ordinal>::pack( char* buffer ) const
+{
+    MCLS_REQUIRE( d_packed_bytes > 0 );
+    MCLS_REQUIRE( buffer );
     Serializer s;
-    s.setBuffer( buffer() );
+    s.setBuffer( d_packed_bytes, buffer );
     this->packHistory( s );
-    s << d_starting_state << d_history_tally;
+    Base::packState( s, d_starting_state );
+    s << d_history_tally;
     MCLS_ENSURE( s.getPtr() == s.end() );
-    return buffer;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Unpack the history in place from a buffer of the packed history
+ * size.
+ */
+template<class Ordinal>
+void ForwardHistory<Ordinal>::unpack( char* buffer )
+{
+    MCLS_REQUIRE( d_packed_bytes > 0 );
+    MCLS_REQUIRE( buffer );
+    Deserializer ds;
+    ds.setBuffer( d_packed_bytes, buffer );
+    this->unpackHistory( ds );
+    Base::unpackState( ds, d_starting_state );
+    ds >> d_history_tally;
+    MCLS_ENSURE( ds.getPtr() == ds.end() );
 }
 
 //---------------------------------------------------------------------------//
@@ -95,10 +122,13 @@ std::size_t ForwardHistory<Ordinal>::d_packed_bytes = 0;
  * \brief Set the byte size of the packed history state.
  */
 template<class Ordinal>
-void ForwardHistory<Ordinal>::setByteSize()
+void ForwardHistory<Ordinal>::setByteSize( const bool compact_states,
+					   const bool compact_steps,
+					   const bool history_ids )
 {
-    Base::setStaticSize();
-    d_packed_bytes = Base::getStaticSize() + sizeof(Ordinal) + sizeof(double);
+    Base::setStaticSize( compact_states, compact_steps, history_ids );
+    d_packed_bytes = 
+	Base::getStaticSize() + Base::packedStateBytes() + sizeof(double);
 }
 
 //---------------------------------------------------------------------------//
@@ -46,9 +46,13 @@
 #include "MCLS_DBC.hpp"
 #include "MCLS_ForwardHistory.hpp"
 #include "MCLS_VectorTraits.hpp"
+#include "MCLS_VectorExport.hpp"
 #include "MCLS_TallyTraits.hpp"
+#include "MCLS_ThreadTools.hpp"
 
 #include <Teuchos_RCP.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayView.hpp>
 
 namespace MCLS
 {
@@ -58,6 +62,19 @@ namespace MCLS
  * \class ForwardTally
  * \brief Monte Carlo tally for the linear system solution vector for forward
  * problems. 
+ *
+ * If the domain has overlap states, the source is imported into the overlap
+ * states with an export built once when the overlap states are set such that
+ * histories walking in the overlap are tallied with the owner's source.
+ *
+ * Each history carries its complete score to its starting state such that
+ * the sum of the squared scores is also tallied and the variance of the mean
+ * of each state can be estimated from the histories of the last finalized
+ * tally.
+ *
+ * The set of tallied starting states only grows over repeated solves. The
+ * vector over these states and its exports to the operator decomposition are
+ * built once and only rebuilt when a process tallies a new starting state.
  */
 template<class Vector>
 class ForwardTally
@@ -83,6 +100,9 @@ class ForwardTally
     // Assign the source vector to the tally.
     void setSource( const Teuchos::RCP<Vector>& b );
 
+    // Set the overlap states of the tally in local state order.
+    void setOverlapStates( const Teuchos::ArrayView<const Ordinal>& states );
+
     // Add a history's contribution to the tally.
     inline void tallyHistory( HistoryType& history );
 
@@ -99,6 +119,33 @@ class ForwardTally
     // Finalize the tally.
     void finalize();
 
+    // Estimate the variance of the mean of each state of the last finalized
+    // tally.
+    void estimateVariance( Vector& variance );
+
+  private:
+
+    // Score moments of the histories starting in a state.
+    struct StateMoments
+    {
+	// Sum of the history scores.
+	Scalar sum;
+
+	// Sum of the squared history scores.
+	Scalar sum_squares;
+
+	// Number of histories.
+	int count;
+    };
+
+    // Zero the score moments while keeping the tally states.
+    static void zeroMoments( 
+	std::unordered_map<Ordinal,StateMoments>& state_moments );
+
+    // Rebuild the tally state vector and its exports if any process in the
+    // set has tallied a new starting state.
+    void updateTallyStates();
+
   private:
 
     // Solution vector in operator decomposition.
@@ -107,11 +154,49 @@ class ForwardTally
     // Source vector in operator decomposition.
     Teuchos::RCP<Vector> d_b;
 
-    // View of the local source.
+    // View of the local source, including overlap states.
     Teuchos::ArrayRCP<const Scalar> d_b_view;
 
-    // Tally states, values, and counts.
-    std::unordered_map<Ordinal,std::pair<Scalar,int> > d_states_values_counts;
+    // Source vector in operator decomposition for the overlap import.
+    Teuchos::RCP<Vector> d_b_base;
+
+    // Source vector in the overlap states.
+    Teuchos::RCP<Vector> d_b_overlap;
+
+    // Base-to-overlap source export.
+    Teuchos::RCP<VectorExport<Vector> > d_overlap_import;
+
+    // Local source storage, including overlap states.
+    Teuchos::ArrayRCP<Scalar> d_b_combined;
+
+    // Tally states and score moments.
+    std::unordered_map<Ordinal,StateMoments> d_state_moments;
+
+    // Thread-private tally states and score moments for all threads but the
+    // master thread.
+    Teuchos::Array<std::unordered_map<Ordinal,StateMoments> >
+    d_thread_state_moments;
+
+    // Tally states of the last finalized tally.
+    Teuchos::Array<Ordinal> d_tally_states;
+
+    // History counts in operator decomposition of the last finalized tally.
+    Teuchos::RCP<Vector> d_counts;
+
+    // Sum of the squared history scores in operator decomposition.
+    Teuchos::RCP<Vector> d_squares;
+
+    // Vector over the tally states.
+    Teuchos::RCP<Vector> d_state_tally;
+
+    // Tally state to solution vector export.
+    Teuchos::RCP<VectorExport<Vector> > d_x_export;
+
+    // Tally state to history count export.
+    Teuchos::RCP<VectorExport<Vector> > d_count_export;
+
+    // Tally state to squared score export.
+    Teuchos::RCP<VectorExport<Vector> > d_squares_export;
 };
 
 //---------------------------------------------------------------------------//
@@ -125,7 +210,8 @@ inline void ForwardTally<Vector>::tallyHistory( HistoryType& history )
 {
     MCLS_REQUIRE( history.alive() );
     MCLS_REQUIRE( Teuchos::nonnull(d_b) );
-    MCLS_REQUIRE( VT::isLocalRow(*d_b,history.localState()) );
+    MCLS_REQUIRE( history.localState() >= 0 );
+    MCLS_REQUIRE( history.localState() < d_b_view.size() );
 
     history.addToHistoryTally( 
 	history.weight() * d_b_view[history.localState()] );
@@ -168,6 +254,33 @@ class TallyTraits<ForwardTally<Vector> >
 	return tally.getVector();
     }
 
+    /*!
+     * \brief Set the tally to use the expected value estimator. Forward
+     * tallies only support the collision estimator.
+     */
+    static void setExpectedValueEstimator( 
+	tally_type& tally,
+	const Teuchos::ArrayView<const int>& row_offsets,
+	const Teuchos::ArrayView<const int>& local_columns,
+	const Teuchos::ArrayView<const double>& cdfs,
+	const Teuchos::ArrayView<const int>& signs,
+	const Teuchos::ArrayView<const double>& weights,
+	const int history_length )
+    {
+	MCLS_INSIST( false, 
+		     "Expected value estimator not available for forward tallies" );
+    }
+
+    /*!
+     * \brief Set the overlap states of the tally.
+     */
+    static void setOverlapStates( 
+	tally_type& tally,
+	const Teuchos::ArrayView<const ordinal_type>& states )
+    {
+	tally.setOverlapStates( states );
+    }
+
     /*!
      * \brief Add a history's contribution to the tally.
      */
@@ -209,6 +322,23 @@ class TallyTraits<ForwardTally<Vector> >
     {
 	tally.finalize();
     }
+
+    /*!
+     * \brief Set the number of variance batches. Forward tallies estimate
+     * their variance from complete history scores and keep no batches.
+     */
+    static void setVarianceBatches( tally_type& tally, const int num_batches )
+    { /* ... */ }
+
+    /*!
+     * \brief Estimate the variance of the mean of each state of the last
+     * finalized tally.
+     */
+    static bool estimateVariance( tally_type& tally, vector_type& variance )
+    {
+	tally.estimateVariance( variance );
+	return true;
+    }
 };
 
 //---------------------------------------------------------------------------//
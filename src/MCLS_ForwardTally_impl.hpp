@@ -48,6 +48,9 @@
 
 #include <Teuchos_Array.hpp>
 #include <Teuchos_ArrayRCP.hpp>
+#include <Teuchos_ScalarTraits.hpp>
+#include <Teuchos_CommHelpers.hpp>
+#include <Teuchos_as.hpp>
 
 namespace MCLS
 {
@@ -59,21 +62,68 @@ namespace MCLS
 template<class Vector>
 ForwardTally<Vector>::ForwardTally( const Teuchos::RCP<Vector>& x )
     : d_x( x )
+    , d_thread_state_moments( ThreadTools::maxThreads() - 1 )
+    , d_counts( VT::clone(*x) )
+    , d_squares( VT::clone(*x) )
 { 
     MCLS_ENSURE( Teuchos::nonnull(d_x) );
+    MCLS_ENSURE( Teuchos::nonnull(d_counts) );
+    MCLS_ENSURE( Teuchos::nonnull(d_squares) );
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Assign the source vector to the tally. This vector should contain
- * both the base and overlap rows.
+ * \brief Assign the source vector to the tally. This vector is in the
+ * operator decomposition; overlap states are imported.
  */
 template<class Vector>
 void ForwardTally<Vector>::setSource( const Teuchos::RCP<Vector>& b )
 {
     MCLS_REQUIRE( Teuchos::nonnull(b) );
     d_b = b;
-    d_b_view = VT::view( *d_b );
+
+    // Without overlap the source can be viewed directly.
+    if ( Teuchos::is_null(d_overlap_import) )
+    {
+	d_b_view = VT::view( *d_b );
+    }
+
+    // Otherwise import the source into the overlap states and append them to
+    // the local source.
+    else
+    {
+	VT::update( *d_b_base, Teuchos::ScalarTraits<Scalar>::zero(), 
+		    *d_b, Teuchos::ScalarTraits<Scalar>::one() );
+	d_overlap_import->doExportInsert();
+
+	Teuchos::ArrayRCP<const Scalar> base_view = VT::view( *d_b );
+	Teuchos::ArrayRCP<const Scalar> overlap_view = VT::view( *d_b_overlap );
+	MCLS_CHECK( d_b_combined.size() == 
+		    base_view.size() + overlap_view.size() );
+	std::copy( base_view.begin(), base_view.end(), d_b_combined.begin() );
+	std::copy( overlap_view.begin(), overlap_view.end(), 
+		   d_b_combined.begin() + base_view.size() );
+	d_b_view = d_b_combined.getConst();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Set the overlap states of the tally in local state order. The
+ * overlap state local ids follow those of the solution vector. This must be
+ * called on all processes of the set before the source is set.
+ */
+template<class Vector>
+void ForwardTally<Vector>::setOverlapStates(
+    const Teuchos::ArrayView<const Ordinal>& states )
+{
+    d_b_base = VT::clone( *d_x );
+    d_b_overlap = VT::createFromRows( VT::getComm(*d_x), states );
+    d_overlap_import = Teuchos::rcp( 
+	new VectorExport<Vector>(d_b_base, d_b_overlap) );
+    d_b_combined = Teuchos::arcp<Scalar>( 
+	VT::getLocalLength(*d_x) + states.size() );
+    MCLS_ENSURE( Teuchos::nonnull(d_overlap_import) );
 }
 
 //---------------------------------------------------------------------------//
@@ -87,22 +137,29 @@ void ForwardTally<Vector>::postProcessHistory( const HistoryType& history )
     MCLS_REQUIRE( !history.alive() );
     MCLS_REQUIRE( Event::CUTOFF == history.event() );
 
+    // Get the tally of the calling thread.
+    int thread_id = ThreadTools::threadId();
+    std::unordered_map<Ordinal,StateMoments>& state_moments =
+	( 0 == thread_id ) ? d_state_moments 
+	: d_thread_state_moments[thread_id-1];
+
     // If the history starting state has already been tallied, add the history
-    // tally sum to the local sum and increment the tally count for the
-    // starting state.
-    if ( d_states_values_counts.count(history.startingState()) )
+    // tally and its square to the local sums and increment the tally count
+    // for the starting state.
+    Scalar score = history.historyTally();
+    auto state_it = state_moments.find( history.startingState() );
+    if ( state_it != state_moments.end() )
     {
-	auto state_val_count =
-	    d_states_values_counts.find( history.startingState() );
-	state_val_count->second.first += history.historyTally();
-	state_val_count->second.second += 1;
+	state_it->second.sum += score;
+	state_it->second.sum_squares += score * score;
+	state_it->second.count += 1;
     }
 
-    // Otherwise add the history state to the local states, sum, and count.
+    // Otherwise add the history state to the local states, sums, and count.
     else
     {
-	d_states_values_counts.emplace(
-	    history.startingState(), std::make_pair(history.historyTally(),1) );
+	StateMoments moments = { score, score * score, 1 };
+	state_moments.emplace( history.startingState(), moments );
     }
 }
     
@@ -119,14 +176,18 @@ void ForwardTally<Vector>::normalize( const int& nh )
 
 //---------------------------------------------------------------------------//
 /*
- * \brief Zero out tally data.
+ * \brief Zero out tally data. The tally states are kept.
  */
 template<class Vector>
 void ForwardTally<Vector>::zeroOut()
 {
     MCLS_REQUIRE( Teuchos::nonnull(d_x) );
     VT::putScalar( *d_x, 0.0 );
-    d_states_values_counts.clear();
+    zeroMoments( d_state_moments );
+    for ( auto& thread_moments : d_thread_state_moments )
+    {
+	zeroMoments( thread_moments );
+    }
 }
 
 //---------------------------------------------------------------------------//
@@ -137,56 +198,51 @@ void ForwardTally<Vector>::zeroOut()
 template<class Vector>
 void ForwardTally<Vector>::finalize()
 {
-    // Extract the tally states.
-    Teuchos::Array<Ordinal> tally_states( d_states_values_counts.size() );
-    typename Teuchos::Array<Ordinal>::iterator state_it;
-    typename std::unordered_map<Ordinal,std::pair<Scalar,int> >::const_iterator
-	svc_it;
-    for ( state_it = tally_states.begin(),
-	    svc_it = d_states_values_counts.begin();
-	  state_it != tally_states.end();
-	  ++state_it, ++svc_it )
+    // Combine the thread tallies with the master thread tally in thread
+    // order.
+    for ( auto& thread_moments : d_thread_state_moments )
     {
-	*state_it = svc_it->first;
+	for ( auto sm : thread_moments )
+	{
+	    auto state_it = d_state_moments.find( sm.first );
+	    if ( state_it != d_state_moments.end() )
+	    {
+		state_it->second.sum += sm.second.sum;
+		state_it->second.sum_squares += sm.second.sum_squares;
+		state_it->second.count += sm.second.count;
+	    }
+	    else
+	    {
+		d_state_moments.emplace( sm.first, sm.second );
+	    }
+	}
+	zeroMoments( thread_moments );
     }
-    
-    // Build a vector from the dead history states.
-    Teuchos::RCP<Vector> x_tally = 
-	VT::createFromRows( VT::getComm(*d_x), tally_states() );
 
-    // Copy the tally data into the vector.
-    for ( auto svc : d_states_values_counts )
-    {
-	VT::sumIntoGlobalValue( *x_tally, svc.first, svc.second.first );
-    }
+    // Update the vector over the dead history states.
+    updateTallyStates();
+    Teuchos::ArrayRCP<Scalar> state_view = VT::viewNonConst( *d_state_tally );
+    MCLS_CHECK( state_view.size() == d_tally_states.size() );
 
-    // Export the local history vector to the base vector.
+    // Copy the tally data into the vector and export add it to the base
+    // vector.
+    for ( int i = 0; i < d_tally_states.size(); ++i )
     {
-        VectorExport<Vector> tally_exporter( x_tally, d_x );
-        tally_exporter.doExportAdd();
+	state_view[i] = d_state_moments.find( d_tally_states[i] )->second.sum;
     }
+    d_x_export->doExportAdd();
 
-    // Build a vector from the dead history states.
-    Teuchos::RCP<Vector> count_tally = 
-	VT::createFromRows( VT::getComm(*d_x), tally_states() );
- 
-    // Copy the tally counts into the vector.
-    for ( auto svc : d_states_values_counts )
+    // Copy the tally counts into the vector and export add them to the base
+    // vector.
+    for ( int i = 0; i < d_tally_states.size(); ++i )
     {
-	VT::sumIntoGlobalValue( *count_tally, svc.first, svc.second.second );
-    }
-
-    // Build a vector from the base states.
-    Teuchos::RCP<Vector> count_base = VT::clone( *d_x );
-
-    // Export add the local history vector to the base vector.
-    {
-        VectorExport<Vector> count_exporter( count_tally, count_base );
-        count_exporter.doExportAdd();
+	state_view[i] = d_state_moments.find( d_tally_states[i] )->second.count;
     }
+    VT::putScalar( *d_counts, 0.0 );
+    d_count_export->doExportAdd();
    
     // Normalize each state in the local tally vector by the count.
-    Teuchos::ArrayRCP<const Scalar> count_view = VT::view( *count_base );
+    Teuchos::ArrayRCP<const Scalar> count_view = VT::view( *d_counts );
     Teuchos::ArrayRCP<Scalar> x_view = VT::viewNonConst( *d_x );
     typename Teuchos::ArrayRCP<const Scalar>::const_iterator norm_it;
     typename Teuchos::ArrayRCP<Scalar>::iterator x_it;
@@ -208,6 +264,115 @@ void ForwardTally<Vector>::finalize()
     }
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Estimate the variance of the mean of each state of the last
+ * finalized tally.
+ *
+ * The squared history scores are export summed to the states in the
+ * operator decomposition and combined with the normalized tally such that
+ * the variance of the mean of a state estimated by n histories is
+ * (sum(s^2)/n - mean^2)/(n-1). States estimated by fewer than two histories
+ * have zero variance. This must be called on all processes of the set.
+ */
+template<class Vector>
+void ForwardTally<Vector>::estimateVariance( Vector& variance )
+{
+    MCLS_REQUIRE( VT::getLocalLength(variance) == VT::getLocalLength(*d_x) );
+
+    MCLS_REQUIRE( Teuchos::nonnull(d_squares_export) );
+
+    // Copy the squared scores into the vector over the dead history states
+    // and export add them to the base decomposition.
+    Teuchos::ArrayRCP<Scalar> state_view = VT::viewNonConst( *d_state_tally );
+    for ( int i = 0; i < d_tally_states.size(); ++i )
+    {
+	state_view[i] = 
+	    d_state_moments.find( d_tally_states[i] )->second.sum_squares;
+    }
+    VT::putScalar( *d_squares, 0.0 );
+    d_squares_export->doExportAdd();
+
+    // Compute the variance of the mean of each state.
+    Teuchos::ArrayRCP<const Scalar> count_view = VT::view( *d_counts );
+    Teuchos::ArrayRCP<const Scalar> x_view = VT::view( *d_x );
+    Teuchos::ArrayRCP<const Scalar> squares_view = VT::view( *d_squares );
+    Teuchos::ArrayRCP<Scalar> var_view = VT::viewNonConst( variance );
+    for ( int i = 0; i < var_view.size(); ++i )
+    {
+	if ( count_view[i] > 1.0 )
+	{
+	    var_view[i] = std::max( 
+		squares_view[i] / count_view[i] - x_view[i] * x_view[i], 0.0 ) / 
+			  (count_view[i] - 1.0);
+	}
+	else
+	{
+	    var_view[i] = 0.0;
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Zero the score moments while keeping the tally states.
+ */
+template<class Vector>
+void ForwardTally<Vector>::zeroMoments( 
+    std::unordered_map<Ordinal,StateMoments>& state_moments )
+{
+    for ( auto& sm : state_moments )
+    {
+	sm.second.sum = 0.0;
+	sm.second.sum_squares = 0.0;
+	sm.second.count = 0;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Rebuild the tally state vector and its exports if any process in
+ * the set has tallied a new starting state. Tally states are never removed
+ * such that the state set settles over repeated solves. This must be called
+ * on all processes of the set.
+ */
+template<class Vector>
+void ForwardTally<Vector>::updateTallyStates()
+{
+    int local_rebuild = ( Teuchos::is_null(d_state_tally) ||
+			  d_state_moments.size() != 
+			  Teuchos::as<std::size_t>(d_tally_states.size()) );
+    int global_rebuild = 0;
+    Teuchos::reduceAll( *VT::getComm(*d_x), Teuchos::REDUCE_MAX,
+			local_rebuild, Teuchos::Ptr<int>(&global_rebuild) );
+
+    if ( global_rebuild )
+    {
+	d_tally_states.resize( d_state_moments.size() );
+	typename Teuchos::Array<Ordinal>::iterator state_it;
+	typename std::unordered_map<Ordinal,StateMoments>::const_iterator sm_it;
+	for ( state_it = d_tally_states.begin(),
+		sm_it = d_state_moments.begin();
+	      state_it != d_tally_states.end();
+	      ++state_it, ++sm_it )
+	{
+	    *state_it = sm_it->first;
+	}
+
+	d_state_tally = 
+	    VT::createFromRows( VT::getComm(*d_x), d_tally_states() );
+	d_x_export = Teuchos::rcp( 
+	    new VectorExport<Vector>(d_state_tally, d_x) );
+	d_count_export = Teuchos::rcp( 
+	    new VectorExport<Vector>(d_state_tally, d_counts) );
+	d_squares_export = Teuchos::rcp( 
+	    new VectorExport<Vector>(d_state_tally, d_squares) );
+    }
+
+    MCLS_ENSURE( Teuchos::nonnull(d_state_tally) );
+    MCLS_ENSURE( Teuchos::nonnull(d_x_export) );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace MCLS
@@ -42,6 +42,7 @@
 #define MCLS_GLOBALTRANSPORTER_HPP
 
 #include <Teuchos_RCP.hpp>
+#include <Teuchos_Array.hpp>
 
 namespace MCLS
 {
@@ -76,6 +77,18 @@ class GlobalTransporter
 
     // Reset the state of the transporter.
     virtual void reset() = 0;
+
+    // Get the number of histories completed on this process in the last
+    // transport.
+    virtual long numCompletedHistories() const = 0;
+
+    // Get the total number of steps of the histories completed on this
+    // process in the last transport.
+    virtual long numCompletedSteps() const = 0;
+
+    // Get the current history buffer size of each send neighbor of this
+    // process.
+    virtual Teuchos::Array<int> sendBufferSizes() const = 0;
 };
 
 //---------------------------------------------------------------------------//
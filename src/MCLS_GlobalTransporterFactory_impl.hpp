@@ -45,6 +45,7 @@
 
 #include "MCLS_SourceTransporter.hpp"
 #include "MCLS_SubdomainTransporter.hpp"
+#include "MCLS_BulkSynchronousTransporter.hpp"
 
 namespace MCLS
 {
@@ -74,6 +75,12 @@ GlobalTransporterFactory<Source>::create( const Teuchos::RCP<const Comm>& comm,
 	    transporter = Teuchos::rcp( 
 		new SubdomainTransporter<Source>(comm, domain, plist) );
 	}
+	else if ( "Bulk Synchronous" == 
+		  plist.get<std::string>("Transport Type") )
+	{
+	    transporter = Teuchos::rcp( 
+		new BulkSynchronousTransporter<Source>(comm, domain, plist) );
+	}
 	else
 	{
 	    transporter = Teuchos::rcp( 
@@ -56,6 +56,17 @@ namespace MCLS
 /*!
  * \class History
  * \brief Base class for encapsulation of a random walk history's state.
+ *
+ * Only the global state, weight, and step count are packed. Histories are
+ * only communicated after leaving a domain, so an unpacked history is dead
+ * with a boundary event and an invalid local state, which the receiving
+ * domain sets. If compact states are enabled, global states are packed as
+ * 32-bit integers. The step count is packed as a 32-bit integer unless
+ * compact steps are enabled, in which case it is packed as a 16-bit
+ * integer. Compact steps may only be enabled when the history length limit
+ * of the domain fits in 16 bits. If history ids are packed, the
+ * source-assigned history id is packed as a 64-bit integer such that a
+ * history keeps its random number substream when it is communicated.
  */
 //---------------------------------------------------------------------------//
 template<class Ordinal>
@@ -76,6 +87,7 @@ class History
 	, b_alive( false )
 	, b_event( 0 )
 	, b_num_steps( 0 )
+	, b_history_id( 0 )
     { /* ... */ }
 
     //! State constructor.
@@ -86,6 +98,7 @@ class History
 	, b_alive( false )
 	, b_event( 0 )
 	, b_num_steps( 0 )
+	, b_history_id( 0 )
     { /* ... */ }
 
     // Pack the history into a buffer.
@@ -157,15 +170,48 @@ class History
     //! Get the number of steps this history has taken.
     inline int numSteps() const
     { return b_num_steps; }
+
+    //! Set the source-assigned history id.
+    inline void setHistoryId( const std::size_t history_id )
+    { b_history_id = history_id; }
+
+    //! Get the source-assigned history id.
+    inline std::size_t historyId() const
+    { return b_history_id; }
     
   public:
 
     // Set the byte size of the packed history state.
-    static void setStaticSize();
+    static void setStaticSize( const bool compact_states = false,
+			       const bool compact_steps = false,
+			       const bool history_ids = false );
 
     // Get the number of bytes in the packed history state.
     static std::size_t getStaticSize();
 
+    //! Determine if global states are packed as 32-bit integers.
+    static bool compactStates()
+    { return b_compact_states; }
+
+    //! Determine if step counts are packed as 16-bit integers.
+    static bool compactSteps()
+    { return b_compact_steps; }
+
+    //! Determine if history ids are packed.
+    static bool packHistoryIds()
+    { return b_pack_ids; }
+
+  protected:
+
+    // Get the number of bytes in a packed global state.
+    static std::size_t packedStateBytes();
+
+    // Pack a global state into a buffer.
+    static void packState( Serializer& s, const Ordinal state );
+
+    // Unpack a global state from a buffer.
+    static void unpackState( Deserializer& ds, Ordinal& state );
+
   protected:
 
     // History state in global indexing.
@@ -185,11 +231,23 @@ class History
 
     // Number of steps this history has taken.
     int b_num_steps;
+
+    // Source-assigned history id.
+    std::size_t b_history_id;
     
   private:
 
     // Packed size of history in bytes.
     static std::size_t b_packed_bytes;
+
+    // Compact global state flag.
+    static int b_compact_states;
+
+    // Compact step count flag.
+    static int b_compact_steps;
+
+    // Packed history id flag.
+    static int b_pack_ids;
 };
 
 //---------------------------------------------------------------------------//
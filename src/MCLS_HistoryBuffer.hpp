@@ -55,6 +55,11 @@ namespace MCLS
  * \class HistoryBuffer
  * \brief Data buffer for histories. Tom Evans is responsible for the design
  * of this class and subsequent inheritance structure.
+ *
+ * Buffers are allocated for the maximum number of histories but each buffer
+ * has its own capacity, no larger than the maximum, at which it is full. The
+ * number of histories is stored at the front of the buffer followed by the
+ * packed histories so only the used portion of the buffer need be sent.
  */
 //---------------------------------------------------------------------------//
 template<class History>
@@ -73,6 +78,7 @@ class HistoryBuffer
     //! Default constructor.
     HistoryBuffer()
 	: d_number( 0 )
+	, d_capacity( d_max_num_histories )
     { /* ... */ }
 
     // Size constructor.
@@ -108,12 +114,23 @@ class HistoryBuffer
 
     //! Check if the buffer is full.
     bool isFull() const 
-    { return ( d_number == d_max_num_histories ); }
+    { return ( d_number >= d_capacity ); }
 
     //! Get the current allocated size of the buffer.
     std::size_t allocatedSize() const
     { return d_buffer.size(); }
 
+    // Set the number of histories at which this buffer is full.
+    void setCapacity( int capacity );
+
+    //! Get the number of histories at which this buffer is full.
+    int capacity() const
+    { return d_capacity; }
+
+    //! Get the number of bytes in the used portion of the buffer.
+    std::size_t messageSize() const
+    { return sizeof(int) + d_number*d_size_packed_history; }
+
   public:
 
     // Set the maximum number of histories allowed in the buffer.
@@ -146,6 +163,9 @@ class HistoryBuffer
     // Number of histories currently in the buffer.
     int d_number;
 
+    // Number of histories at which this buffer is full.
+    int d_capacity;
+
   private:
 
     // Maximum number of histories allowed in the buffer.
@@ -57,6 +57,7 @@ namespace MCLS
 template<class History>
 HistoryBuffer<History>::HistoryBuffer( std::size_t size, int num_history )
     : d_number( 0 )
+    , d_capacity( num_history )
 {
     setSizePackedHistory( size );
     setMaxNumHistories( num_history );
@@ -68,6 +69,7 @@ HistoryBuffer<History>::HistoryBuffer( std::size_t size, int num_history )
 /*!
  * \brief Allocate the buffer for the byte size of the maximum number of
  * histories plus an additional integer for the actual number of the buffer.
+ * The buffer capacity is reset to the maximum number of histories.
  */
 template<class History>
 void HistoryBuffer<History>::allocate()
@@ -75,6 +77,7 @@ void HistoryBuffer<History>::allocate()
     MCLS_REQUIRE( d_number == 0 );
     d_buffer.resize( 
 	d_max_num_histories*d_size_packed_history + sizeof(int), '\0' );
+    d_capacity = d_max_num_histories;
     MCLS_ENSURE( d_number == 0 );
 }
 
@@ -92,89 +95,98 @@ void HistoryBuffer<History>::deallocate()
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Write a history into the buffer.
+ * \brief Write a history into the buffer. The history is packed in place.
  */
 template<class History>
 void HistoryBuffer<History>::bufferHistory( const History& history )
 {
     MCLS_REQUIRE( d_size_packed_history > 0 );
-    MCLS_REQUIRE( d_number < d_max_num_histories );
+    MCLS_REQUIRE( d_number < d_capacity );
     MCLS_REQUIRE( d_number >= 0 );
     MCLS_REQUIRE( !d_buffer.empty() );
 
-    Buffer packed_history = HT::pack( history );
-    MCLS_CHECK( Teuchos::as<std::size_t>(packed_history.size()) == 
-		d_size_packed_history );
+    MCLS_CHECK( d_size_packed_history == HT::getPackedBytes() );
+    MCLS_CHECK( d_size_packed_history*(d_number+1) + sizeof(int) <= 
+		Teuchos::as<std::size_t>(d_buffer.size()) );
 
-    Buffer::iterator buffer_it = d_buffer.begin() + 
-				 d_size_packed_history*d_number;
-    MCLS_REQUIRE( buffer_it != d_buffer.end() );
-
-    std::copy( packed_history.begin(), packed_history.end(), buffer_it );
+    HT::pack( history, 
+	      &d_buffer[sizeof(int) + d_size_packed_history*d_number] );
     ++d_number;
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Add the histories in the buffer to a bank.
+ * \brief Add the histories in the buffer to a bank. The histories are
+ * unpacked in place into the bank.
  */
 template<class History>
 void HistoryBuffer<History>::addToBank( BankType& bank )
 {
     MCLS_REQUIRE( d_size_packed_history > 0 );
 
-    Buffer::const_iterator buffer_it = d_buffer.begin();
-    Buffer packed_history( d_size_packed_history );
+    Buffer::iterator buffer_it = d_buffer.begin() + sizeof(int);
 
     MCLS_REMEMBER( std::size_t bank_size = bank.size() );
 
     for ( int n = 0; n < d_number; ++n )
     {
-	std::copy( buffer_it, buffer_it + d_size_packed_history, 
-		   packed_history.begin() );
-
-	bank.emplace( HT::createFromBuffer(packed_history) );
+	bank.emplace();
+	HT::unpack( bank.top(), &(*buffer_it) );
 
 	buffer_it += d_size_packed_history;
     }
 
     MCLS_ENSURE( bank_size + d_number == bank.size() );
-    MCLS_ENSURE( d_number == d_max_num_histories ?
-		 buffer_it + sizeof(int) == d_buffer.end() :
-		 buffer_it + sizeof(int) != d_buffer.end() );
+    MCLS_ENSURE( buffer_it == d_buffer.begin() + messageSize() );
 
     empty();
     MCLS_ENSURE( isEmpty() );
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Set the number of histories at which this buffer is full. The
+ * capacity may not exceed the maximum number of histories.
+ */
+template<class History>
+void HistoryBuffer<History>::setCapacity( int capacity )
+{
+    MCLS_REQUIRE( capacity > 0 );
+    MCLS_REQUIRE( capacity <= d_max_num_histories );
+    MCLS_REQUIRE( d_number <= capacity );
+    d_capacity = capacity;
+}
+
 //---------------------------------------------------------------------------//
 // Protected Members.
 //---------------------------------------------------------------------------//
 /*!
- * \brief Add the number of histories to the end of the buffer.
+ * \brief Add the number of histories to the front of the buffer.
  */
 template<class History>
 void HistoryBuffer<History>::writeNumToBuffer()
 {
     MCLS_REQUIRE( Teuchos::as<std::size_t>(d_buffer.size()) > sizeof(int) );
     Serializer s;
-    s.setBuffer( sizeof(int), &d_buffer[d_buffer.size() - sizeof(int)] );
+    s.setBuffer( sizeof(int), &d_buffer[0] );
     s << d_number;
-    MCLS_ENSURE( s.getPtr() == &d_buffer[0] + d_buffer.size() );
+    MCLS_ENSURE( s.getPtr() == &d_buffer[0] + sizeof(int) );
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Read the number of histories from the end of the buffer.
+ * \brief Read the number of histories from the front of the buffer.
  */
 template<class History>
 void HistoryBuffer<History>::readNumFromBuffer()
 {
     Deserializer ds;
-    ds.setBuffer( sizeof(int), &d_buffer[d_buffer.size() - sizeof(int)] );
+    ds.setBuffer( sizeof(int), &d_buffer[0] );
     ds >> d_number;
-    MCLS_ENSURE( ds.getPtr() == &d_buffer[0] + d_buffer.size() );
+    MCLS_ENSURE( ds.getPtr() == &d_buffer[0] + sizeof(int) );
     MCLS_ENSURE( d_number >= 0 );
+    MCLS_ENSURE( messageSize() <= 
+		 Teuchos::as<std::size_t>(d_buffer.size()) );
 }
 
 //---------------------------------------------------------------------------//
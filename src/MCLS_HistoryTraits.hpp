@@ -100,6 +100,24 @@ class HistoryTraits
 	return Teuchos::Array<char>(0);
     }
 
+    /*!
+     * \brief Pack the history in place into a buffer of the packed history
+     * size.
+     */
+    static void pack( const history_type& history, char* buffer )
+    {
+	UndefinedHistoryTraits<History>::notDefined(); 
+    }
+
+    /*!
+     * \brief Unpack a history in place from a buffer of the packed history
+     * size.
+     */
+    static void unpack( history_type& history, char* buffer )
+    {
+	UndefinedHistoryTraits<History>::notDefined(); 
+    }
+
     /*!
      * \brief Set the state of a history in global indexing.
      */
@@ -222,9 +240,14 @@ class HistoryTraits
     }
 
     /*!
-     * \brief Set the byte size of the packed history state.
+     * \brief Set the byte size of the packed history state. Global states
+     * are packed as 32-bit integers if compact states are requested and
+     * step counts as 16-bit integers if compact steps are requested. History
+     * ids are packed if requested.
      */
-    static inline void setByteSize()
+    static inline void setByteSize( const bool compact_states = false,
+				    const bool compact_steps = false,
+				    const bool history_ids = false )
     {
 	UndefinedHistoryTraits<History>::notDefined();
     }
@@ -254,6 +277,24 @@ class HistoryTraits
 	UndefinedHistoryTraits<History>::notDefined();
 	return -1;
     }
+
+    /*!
+     * \brief Set the source-assigned id of the history.
+     */
+    static inline void setHistoryId( history_type& history,
+				     const std::size_t history_id )
+    {
+	UndefinedHistoryTraits<History>::notDefined();
+    }
+
+    /*!
+     * \brief Get the source-assigned id of the history.
+     */
+    static inline std::size_t historyId( const history_type& history )
+    {
+	UndefinedHistoryTraits<History>::notDefined();
+	return 0;
+    }
 };
 
 //---------------------------------------------------------------------------//
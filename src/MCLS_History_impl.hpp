@@ -42,8 +42,11 @@
 #define MCLS_HISTORY_IMPL_HPP
 
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 
 #include "MCLS_DBC.hpp"
+#include "MCLS_Events.hpp"
 
 #include <Teuchos_as.hpp>
 
@@ -56,20 +59,54 @@ namespace MCLS
 template<class Ordinal>
 void History<Ordinal>::packHistory( Serializer& s ) const
 {
-    s << b_global_state << b_weight << static_cast<int>(b_alive)
-      << b_event << b_num_steps;
+    packState( s, b_global_state );
+    s << b_weight;
+    if ( b_compact_steps )
+    {
+	MCLS_REQUIRE( b_num_steps <= std::numeric_limits<std::uint16_t>::max() );
+	s << static_cast<std::uint16_t>(b_num_steps);
+    }
+    else
+    {
+	s << static_cast<std::int32_t>(b_num_steps);
+    }
+    if ( b_pack_ids )
+    {
+	s << static_cast<std::uint64_t>(b_history_id);
+    }
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Unpack the history from a buffer.
+ * \brief Unpack the history from a buffer. The history is dead with a
+ * boundary event and an invalid local state.
  */
 template<class Ordinal>
 void History<Ordinal>::unpackHistory( Deserializer& ds )
 {
-    int alive;
-    ds >> b_global_state >> b_weight >> alive >> b_event >> b_num_steps;
-    b_alive = static_cast<bool>(alive);
+    unpackState( ds, b_global_state );
+    ds >> b_weight;
+    if ( b_compact_steps )
+    {
+	std::uint16_t num_steps = 0;
+	ds >> num_steps;
+	b_num_steps = num_steps;
+    }
+    else
+    {
+	std::int32_t num_steps = 0;
+	ds >> num_steps;
+	b_num_steps = num_steps;
+    }
+    if ( b_pack_ids )
+    {
+	std::uint64_t history_id = 0;
+	ds >> history_id;
+	b_history_id = history_id;
+    }
+    b_local_state = Teuchos::OrdinalTraits<int>::invalid();
+    b_alive = false;
+    b_event = Event::BOUNDARY;
 }
 
 //---------------------------------------------------------------------------//
@@ -78,14 +115,35 @@ void History<Ordinal>::unpackHistory( Deserializer& ds )
 template<class Ordinal>
 std::size_t History<Ordinal>::b_packed_bytes = 0;
 
+template<class Ordinal>
+int History<Ordinal>::b_compact_states = 0;
+
+template<class Ordinal>
+int History<Ordinal>::b_compact_steps = 0;
+
+template<class Ordinal>
+int History<Ordinal>::b_pack_ids = 0;
+
 //---------------------------------------------------------------------------//
 /*!
- * \brief Set the byte size of the packed history state.
+ * \brief Set the byte size of the packed history state. Compact states may
+ * only be used if all global states fit in a 32-bit integer. Compact steps
+ * may only be used if no history can take more steps than a 16-bit integer
+ * holds. History ids must be packed if the random number substream of a
+ * history is keyed by its id.
  */
 template<class Ordinal>
-void History<Ordinal>::setStaticSize()
+void History<Ordinal>::setStaticSize( const bool compact_states,
+				      const bool compact_steps,
+				      const bool history_ids )
 {
-    b_packed_bytes = sizeof(Ordinal) + sizeof(double) + 3*sizeof(int);
+    b_compact_states = compact_states;
+    b_compact_steps = compact_steps;
+    b_pack_ids = history_ids;
+    b_packed_bytes = packedStateBytes() + sizeof(double) + 
+		     (compact_steps ? sizeof(std::uint16_t) : 
+		      sizeof(std::int32_t)) +
+		     (history_ids ? sizeof(std::uint64_t) : 0);
 }
 
 //---------------------------------------------------------------------------//
@@ -99,6 +157,53 @@ std::size_t History<Ordinal>::getStaticSize()
     return b_packed_bytes;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the number of bytes in a packed global state.
+ */
+template<class Ordinal>
+std::size_t History<Ordinal>::packedStateBytes()
+{
+    return b_compact_states ? sizeof(std::int32_t) : sizeof(Ordinal);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Pack a global state into a buffer.
+ */
+template<class Ordinal>
+void History<Ordinal>::packState( Serializer& s, const Ordinal state )
+{
+    if ( b_compact_states )
+    {
+	MCLS_REQUIRE( state <= std::numeric_limits<std::int32_t>::max() );
+	s << static_cast<std::int32_t>(state);
+    }
+    else
+    {
+	s << state;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Unpack a global state from a buffer.
+ */
+template<class Ordinal>
+void History<Ordinal>::unpackState( Deserializer& ds, Ordinal& state )
+{
+    if ( b_compact_states )
+    {
+	std::int32_t compact_state = 0;
+	ds >> compact_state;
+	state = static_cast<Ordinal>(compact_state);
+    }
+    else
+    {
+	ds >> state;
+    }
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace MCLS
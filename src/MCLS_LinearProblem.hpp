@@ -46,7 +46,9 @@
 #include "MCLS_MatrixTraits.hpp"
 
 #include <Teuchos_RCP.hpp>
+#include <Teuchos_Comm.hpp>
 #include <Teuchos_Time.hpp>
+#include <Teuchos_ScalarTraits.hpp>
 
 namespace MCLS
 {
@@ -153,6 +155,21 @@ class LinearProblem
     // updated as well.
     void updatePrecResidual();
 
+    // Update the preconditioned residual and return its 2-norm. Without left
+    // preconditioning the residual update and norm are fused into a single
+    // pass over the residual.
+    typename Teuchos::ScalarTraits<Scalar>::magnitudeType 
+    updatePrecResidualNorm();
+
+    // Update the preconditioned residual and start a non-blocking reduction
+    // of its 2-norm.
+    Teuchos::RCP<Teuchos::CommRequest<int> > startPrecResidualNorm();
+
+    // Complete a preconditioned residual norm reduction and return the
+    // 2-norm.
+    typename Teuchos::ScalarTraits<Scalar>::magnitudeType 
+    finishPrecResidualNorm( Teuchos::RCP<Teuchos::CommRequest<int> >& request );
+
   private:
 
     // Linear operator.
@@ -176,6 +193,15 @@ class LinearProblem
     // Preconditioned residual rp = PL*(b - A*PR*x).
     Teuchos::RCP<Vector> d_rp;
 
+    // Work vector for preconditioned operator applications. Allocated once
+    // with the residuals so that no vectors are created in apply calls.
+    Teuchos::RCP<Vector> d_work;
+
+    // Local and global squared preconditioned residual norm buffers for
+    // non-blocking reductions.
+    double d_local_norm_squared;
+    double d_global_norm_squared;
+
 #if HAVE_MCLS_TIMERS
     // Matrix-matrix multiply timer.
     Teuchos::RCP<Teuchos::Time> d_mm_timer;
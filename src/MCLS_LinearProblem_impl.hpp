@@ -41,7 +41,10 @@
 #ifndef MCLS_LINEARPROBLEM_IMPL_HPP
 #define MCLS_LINEARPROBLEM_IMPL_HPP
 
+#include <cmath>
+
 #include "MCLS_DBC.hpp"
+#include "MCLS_CommTools.hpp"
 
 #include <Teuchos_ScalarTraits.hpp>
 #include <Teuchos_TimeMonitor.hpp>
@@ -62,6 +65,9 @@ LinearProblem<Vector,Matrix>::LinearProblem(
     , d_b( b )
     , d_r( MT::cloneVectorFromMatrixRows(*d_A) )
     , d_rp( MT::cloneVectorFromMatrixRows(*d_A) )
+    , d_work( MT::cloneVectorFromMatrixRows(*d_A) )
+    , d_local_norm_squared( 0.0 )
+    , d_global_norm_squared( 0.0 )
 #if HAVE_MCLS_TIMERS
     , d_mm_timer( Teuchos::TimeMonitor::getNewCounter("MCLS: Matrix-Matrix Multiply") )
     , d_mv_timer( Teuchos::TimeMonitor::getNewCounter("MCLS: Matrix-Vector Multiply") )
@@ -72,6 +78,7 @@ LinearProblem<Vector,Matrix>::LinearProblem(
     MCLS_ENSURE( Teuchos::nonnull(d_b) );
     MCLS_ENSURE( Teuchos::nonnull(d_r) );
     MCLS_ENSURE( Teuchos::nonnull(d_rp) );
+    MCLS_ENSURE( Teuchos::nonnull(d_work) );
 }
 
 //---------------------------------------------------------------------------//
@@ -232,10 +239,9 @@ void LinearProblem<Vector,Matrix>::updateSolution(
 
     if ( right_prec )
     {
-	Teuchos::RCP<Vector> prec_update = VT::clone(*update);
-	MT::apply( *d_PR, *update, *prec_update );
+	MT::apply( *d_PR, *update, *d_work );
 	VT::update( *d_x, Teuchos::ScalarTraits<Scalar>::one(),
-		    *prec_update, Teuchos::ScalarTraits<Scalar>::one() );
+		    *d_work, Teuchos::ScalarTraits<Scalar>::one() );
     }
     else
     {
@@ -258,9 +264,6 @@ void LinearProblem<Vector,Matrix>::apply( const Vector& x, Vector& y )
     const bool left_prec = Teuchos::nonnull( d_PL );
     const bool right_prec = Teuchos::nonnull( d_PR );
 
-    Teuchos::RCP<Vector> temp = 
-	( left_prec || right_prec ) ? VT::clone(y) : Teuchos::null;
-
     if ( !left_prec && !right_prec )
     {
 	MT::apply( *d_A, x, y );
@@ -269,18 +272,18 @@ void LinearProblem<Vector,Matrix>::apply( const Vector& x, Vector& y )
     else if ( left_prec && right_prec )
     {
 	MT::apply( *d_PR, x, y );
-	MT::apply( *d_A, y, *temp );
-	MT::apply( *d_PL, *temp, y );
+	MT::apply( *d_A, y, *d_work );
+	MT::apply( *d_PL, *d_work, y );
     }
     else if ( left_prec )
     {
-	MT::apply( *d_A, x, *temp );
-	MT::apply( *d_PL, *temp, y );
+	MT::apply( *d_A, x, *d_work );
+	MT::apply( *d_PL, *d_work, y );
     }
     else
     {
-	MT::apply( *d_PR, x, *temp );
-	MT::apply( *d_A, *temp, y );
+	MT::apply( *d_PR, x, *d_work );
+	MT::apply( *d_A, *d_work, y );
     }
 }
 
@@ -298,9 +301,6 @@ void LinearProblem<Vector,Matrix>::applyTranspose( const Vector& x, Vector& y )
     const bool left_prec = Teuchos::nonnull( d_PL );
     const bool right_prec = Teuchos::nonnull( d_PR );
 
-    Teuchos::RCP<Vector> temp = 
-	( left_prec || right_prec ) ? VT::clone(y) : Teuchos::null;
-
     if ( !left_prec && !right_prec )
     {
 	MT::applyTranspose( *d_A, x, y );
@@ -309,18 +309,18 @@ void LinearProblem<Vector,Matrix>::applyTranspose( const Vector& x, Vector& y )
     else if ( left_prec && right_prec )
     {
 	MT::applyTranspose( *d_PL, x, y );
-	MT::applyTranspose( *d_A, y, *temp );
-	MT::applyTranspose( *d_PR, *temp, y );
+	MT::applyTranspose( *d_A, y, *d_work );
+	MT::applyTranspose( *d_PR, *d_work, y );
     }
     else if ( left_prec )
     {
-	MT::applyTranspose( *d_PL, x, *temp );
-	MT::applyTranspose( *d_A, *temp, y );
+	MT::applyTranspose( *d_PL, x, *d_work );
+	MT::applyTranspose( *d_A, *d_work, y );
     }
     else
     {
-	MT::applyTranspose( *d_A, x, *temp );
-	MT::applyTranspose( *d_PR, *temp, y );
+	MT::applyTranspose( *d_A, x, *d_work );
+	MT::applyTranspose( *d_PR, *d_work, y );
     }
 }
 
@@ -421,9 +421,8 @@ void LinearProblem<Vector,Matrix>::updatePrecResidual()
     // Apply right preconditioning if necessary.
     if ( Teuchos::nonnull(d_PR) )
     {
-        Teuchos::RCP<Vector> temp = VT::clone(*d_rp);
-        MT::apply( *d_PR, *d_x, *temp);
-        MT::apply( *d_A, *temp, *d_rp );
+        MT::apply( *d_PR, *d_x, *d_work );
+        MT::apply( *d_A, *d_work, *d_rp );
     }
     else
     {
@@ -436,11 +435,85 @@ void LinearProblem<Vector,Matrix>::updatePrecResidual()
     // Apply left preconditioning if necessary.
     if ( Teuchos::nonnull(d_PL) )
     {
-        Teuchos::RCP<Vector> temp = VT::deepCopy(*d_rp);
-	MT::apply( *d_PL, *temp, *d_rp );
+	VT::update( *d_work, Teuchos::ScalarTraits<Scalar>::zero(),
+		    *d_rp, Teuchos::ScalarTraits<Scalar>::one() );
+	MT::apply( *d_PL, *d_work, *d_rp );
     }
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Update the preconditioned residual and return its 2-norm.
+ */
+template<class Vector, class Matrix>
+typename Teuchos::ScalarTraits<
+    typename LinearProblem<Vector,Matrix>::Scalar>::magnitudeType 
+LinearProblem<Vector,Matrix>::updatePrecResidualNorm()
+{
+    // With left preconditioning the norm must be computed after the
+    // preconditioner is applied.
+    if ( Teuchos::nonnull(d_PL) )
+    {
+	updatePrecResidual();
+	return VT::norm2( *d_rp );
+    }
+
+#if HAVE_MCLS_TIMERS
+    Teuchos::TimeMonitor mm_monitor( *d_mv_timer );
+#endif
+
+    MCLS_REQUIRE( Teuchos::nonnull(d_A) );
+    MCLS_REQUIRE( Teuchos::nonnull(d_x) );
+    MCLS_REQUIRE( Teuchos::nonnull(d_b) );
+
+    // Apply right preconditioning if necessary.
+    if ( Teuchos::nonnull(d_PR) )
+    {
+        MT::apply( *d_PR, *d_x, *d_work );
+        MT::apply( *d_A, *d_work, *d_rp );
+    }
+    else
+    {
+        MT::apply( *d_A, *d_x, *d_rp );
+    }
+
+    // Compute the residual and its norm in a single pass.
+    return VT::updateNorm2( *d_rp, -Teuchos::ScalarTraits<Scalar>::one(), 
+			    *d_b, Teuchos::ScalarTraits<Scalar>::one() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Update the preconditioned residual and start a non-blocking
+ * reduction of its 2-norm. The reduction must be completed with
+ * finishPrecResidualNorm() before another is started.
+ */
+template<class Vector, class Matrix>
+Teuchos::RCP<Teuchos::CommRequest<int> >
+LinearProblem<Vector,Matrix>::startPrecResidualNorm()
+{
+    updatePrecResidual();
+    d_local_norm_squared = VT::localNorm2Squared( *d_rp );
+    return CommTools::iallReduceSum( VT::getComm(*d_rp), 1,
+				     &d_local_norm_squared, 
+				     &d_global_norm_squared );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Complete a preconditioned residual norm reduction and return the
+ * 2-norm.
+ */
+template<class Vector, class Matrix>
+typename Teuchos::ScalarTraits<
+    typename LinearProblem<Vector,Matrix>::Scalar>::magnitudeType 
+LinearProblem<Vector,Matrix>::finishPrecResidualNorm( 
+    Teuchos::RCP<Teuchos::CommRequest<int> >& request )
+{
+    CommTools::waitRequest( request );
+    return std::sqrt( d_global_norm_squared );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace MCLS
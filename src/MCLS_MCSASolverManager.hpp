@@ -52,8 +52,10 @@
 #include "MCLS_VectorTraits.hpp"
 #include "MCLS_MatrixTraits.hpp"
 #include "MCLS_Xorshift.hpp"
+#include "MCLS_SampleRatioController.hpp"
 
 #include <Teuchos_RCP.hpp>
+#include <Teuchos_Array.hpp>
 #include <Teuchos_ParameterList.hpp>
 #include <Teuchos_ScalarTraits.hpp>
 #include <Teuchos_as.hpp>
@@ -66,6 +68,36 @@ namespace MCLS
 /*!
  * \class MCSASolverManager
  * \brief Solver manager for Monte Carlo synthetic acceleration.
+ *
+ * With "Multiple Set Load Balancing" enabled, the first iteration of a solve
+ * is used to time the Monte Carlo transport of each set. The sample ratios
+ * of the sets are then balanced such that the replicated sets finish
+ * together, and the set corrections are combined with weights equal to
+ * their share of the histories. Balancing is done per set and not per
+ * process: the processes of a set share one source normalization and
+ * exchange histories, so the work of a process is not set by its own sample
+ * ratio. The balance is measured once because the operator and therefore
+ * the cost of a history does not change over the iterations; an adapted
+ * sample ratio scales all sets alike and keeps their balance.
+ *
+ * The residual norm is only computed on iterations where it is checked
+ * ("Iteration Check Frequency") or printed. With "Pipelined Residual Norm"
+ * enabled, the global reduction for a checked norm is posted non-blocking
+ * and completed after the smoothing and Monte Carlo solve of the next
+ * iteration. If that norm has converged the speculative iteration is rolled
+ * back so the returned solution is the converged one.
+ *
+ * With "Adaptive Sample Ratio" enabled, the sample ratio is adjusted each
+ * time a residual norm is computed by a SampleRatioController to maximize
+ * the residual reduction per unit wall time, within the "Minimum Sample
+ * Ratio" and "Maximum Sample Ratio" bounds. The ratios chosen over the last
+ * solve are available from getSampleRatioTrace().
+ *
+ * With "Estimate Relative Error" enabled, the relative error norm of the
+ * Monte Carlo correction is recorded each iteration and is available from
+ * getRelativeErrorTrace(). With multiple sets it is estimated from the
+ * spread of the set corrections. With a single set it is estimated by the
+ * tally.
  */
 template<class Vector,
 	 class Matrix,
@@ -134,6 +166,15 @@ class MCSASolverManager : public SolverManager<Vector,Matrix>
     bool getConvergedStatus() const 
     { return Teuchos::as<bool>(d_converged_status); }
 
+    // Get the nominal sample ratios chosen over the last solve if the ratio
+    // was adapted.
+    Teuchos::Array<double> getSampleRatioTrace() const;
+
+    // Get the relative error norms of the Monte Carlo corrections of the
+    // last solve if they were estimated.
+    Teuchos::Array<double> getRelativeErrorTrace() const
+    { return d_relative_error_trace; }
+
   private:
 
     // Build the residual Monte Carlo problem from the input problem.
@@ -145,6 +186,18 @@ class MCSASolverManager : public SolverManager<Vector,Matrix>
     // Print bottom banner for the iteration.
     void printBottomBanner();
 
+    // Adapt the sample ratio with the residual norm observed at the end of
+    // an interval of iterations.
+    void adaptSampleRatio( 
+	const typename Teuchos::ScalarTraits<Scalar>::magnitudeType residual_norm,
+	const double set_ratio_scale,
+	double& interval_start );
+
+    // Print the relative residual for an iteration.
+    void printIteration( 
+	const int iteration,
+	const typename Teuchos::ScalarTraits<Scalar>::magnitudeType rel_residual );
+
   private:
 
     // Multiset Linear Problem.
@@ -156,6 +209,20 @@ class MCSASolverManager : public SolverManager<Vector,Matrix>
     // Residual linear problem
     Teuchos::RCP<LinearProblemType> d_residual_problem;
 
+    // Work vector for preconditioned source norms, set variances, and
+    // solution recovery.
+    Teuchos::RCP<Vector> d_work;
+
+    // Sample ratio controller.
+    Teuchos::RCP<SampleRatioController> d_ratio_controller;
+
+    // Saved solution for rolling back an iteration computed while the
+    // residual norm of the previous iteration was in flight.
+    Teuchos::RCP<Vector> d_x_save;
+
+    // Relative error norms of the Monte Carlo corrections of the last solve.
+    Teuchos::Array<double> d_relative_error_trace;
+
     // Parameters.
     Teuchos::RCP<Teuchos::ParameterList> d_plist;
 
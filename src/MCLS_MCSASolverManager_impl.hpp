@@ -44,11 +44,14 @@
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include <cmath>
+#include <algorithm>
 
 #include "MCLS_DBC.hpp"
 #include "MCLS_FixedPointIterationFactory.hpp"
 
 #include <Teuchos_TimeMonitor.hpp>
+#include <Teuchos_CommHelpers.hpp>
 
 namespace MCLS
 {
@@ -130,6 +133,12 @@ MCSASolverManager<Vector,Matrix,MonteCarloTag,RNG>::getValidParameters() const
     plist->set<int>("Iteration Print Frequency", 10);
     plist->set<int>("Iteration Check Frequency", 1);
     plist->set<std::string>("Fixed Point Type", "Richardson");
+    plist->set<bool>("Multiple Set Load Balancing", false);
+    plist->set<bool>("Pipelined Residual Norm", false);
+    plist->set<bool>("Adaptive Sample Ratio", false);
+    plist->set<double>("Minimum Sample Ratio", 0.1);
+    plist->set<double>("Maximum Sample Ratio", 10.0);
+    plist->set<double>("Sample Ratio Step Factor", 2.0);
 
     return plist;
 }
@@ -154,9 +163,8 @@ MCSASolverManager<Vector,Matrix,MonteCarloTag,RNG>::achievedTol() const
     // Compute the source norm preconditioned if necessary.
     if ( d_problem->isLeftPrec() )
     {
-	Teuchos::RCP<Vector> tmp = VT::clone( *d_problem->getRHS() );
-	d_problem->applyLeftPrec( *d_problem->getRHS(), *tmp );
-	source_norm = VT::norm2( *tmp );
+	d_problem->applyLeftPrec( *d_problem->getRHS(), *d_work );
+	source_norm = VT::norm2( *d_work );
     }
     else
     {
@@ -172,6 +180,19 @@ MCSASolverManager<Vector,Matrix,MonteCarloTag,RNG>::achievedTol() const
     return residual_norm;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the nominal sample ratios chosen over the last solve, starting
+ * with the initial ratio. Empty if the ratio was not adapted.
+ */
+template<class Vector, class Matrix, class MonteCarloTag, class RNG>
+Teuchos::Array<double> 
+MCSASolverManager<Vector,Matrix,MonteCarloTag,RNG>::getSampleRatioTrace() const
+{
+    return Teuchos::nonnull(d_ratio_controller) ?
+	d_ratio_controller->trace() : Teuchos::Array<double>();
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * \brief Set the multiset linear problem with the manager.
@@ -299,9 +320,8 @@ bool MCSASolverManager<Vector,Matrix,MonteCarloTag,RNG>::solve()
     // Compute the source norm preconditioned if necessary.
     if ( d_problem->isLeftPrec() )
     {
-	Teuchos::RCP<Vector> tmp = VT::clone( *d_problem->getRHS() );
-	d_problem->applyLeftPrec( *d_problem->getRHS(), *tmp );
-	source_norm = VT::norm2( *tmp );
+	d_problem->applyLeftPrec( *d_problem->getRHS(), *d_work );
+	source_norm = VT::norm2( *d_work );
     }
     else
     {
@@ -342,10 +362,90 @@ bool MCSASolverManager<Vector,Matrix,MonteCarloTag,RNG>::solve()
 	smooth_steps = d_plist->get<int>("Smoother Steps");
     }
 
+    // Multiple set load balancing setup. The sets are combined with equal
+    // weights until the sample ratios have been balanced.
+    bool balance_sets = false;
+    if ( d_plist->isParameter("Multiple Set Load Balancing") )
+    {
+	balance_sets = d_plist->get<bool>("Multiple Set Load Balancing") &&
+		       (d_multiset_problem->numSets() > 1);
+    }
+    double sample_ratio = 1.0;
+    if ( d_plist->isParameter("Sample Ratio") )
+    {
+	sample_ratio = d_plist->get<double>("Sample Ratio");
+    }
+    double set_weight = 1.0 / d_multiset_problem->numSets();
+    double transport_time = 0.0;
+
+    // Adaptive sample ratio setup. The ratio of each set is its share of the
+    // nominal ratio chosen by the controller.
+    bool adapt_ratio = false;
+    if ( d_plist->isParameter("Adaptive Sample Ratio") )
+    {
+	adapt_ratio = d_plist->get<bool>("Adaptive Sample Ratio");
+    }
+    double min_ratio = 0.1;
+    if ( d_plist->isParameter("Minimum Sample Ratio") )
+    {
+	min_ratio = d_plist->get<double>("Minimum Sample Ratio");
+    }
+    double max_ratio = 10.0;
+    if ( d_plist->isParameter("Maximum Sample Ratio") )
+    {
+	max_ratio = d_plist->get<double>("Maximum Sample Ratio");
+    }
+    double ratio_factor = 2.0;
+    if ( d_plist->isParameter("Sample Ratio Step Factor") )
+    {
+	ratio_factor = d_plist->get<double>("Sample Ratio Step Factor");
+    }
+    double set_ratio_scale = 1.0;
+    double interval_start = Teuchos::Time::wallTime();
+
+    // Relative error estimation setup. With multiple sets the sets are the
+    // batches of the estimate.
+    bool estimate_error = false;
+    if ( d_plist->isParameter("Estimate Relative Error") )
+    {
+	estimate_error = d_plist->get<bool>("Estimate Relative Error");
+    }
+    bool set_error = estimate_error && (d_multiset_problem->numSets() > 1);
+    double relative_error = 0.0;
+    d_relative_error_trace.clear();
+
+    // Pipelined residual norm setup. The norm of a check iteration is
+    // reduced while the next iteration is computed and that iteration is
+    // rolled back from a saved solution if the norm has converged.
+    bool pipeline_norms = false;
+    if ( d_plist->isParameter("Pipelined Residual Norm") )
+    {
+	pipeline_norms = d_plist->get<bool>("Pipelined Residual Norm");
+    }
+    if ( pipeline_norms && Teuchos::is_null(d_x_save) )
+    {
+	d_x_save = VT::clone( *d_problem->getLHS() );
+    }
+    Teuchos::RCP<Teuchos::CommRequest<int> > norm_request;
+    bool norm_pending = false;
+    bool check_iter = false;
+    bool print_iter = false;
+
     // Compute the initial preconditioned residual.
-    d_problem->updatePrecResidual();
     typename Teuchos::ScalarTraits<Scalar>::magnitudeType residual_norm =
-	VT::norm2( *d_problem->getPrecResidual() );
+	d_problem->updatePrecResidualNorm();
+
+    // Create the sample ratio controller with the initial residual.
+    d_ratio_controller = Teuchos::null;
+    if ( adapt_ratio )
+    {
+	d_ratio_controller = Teuchos::rcp( 
+	    new SampleRatioController( sample_ratio,
+				       std::min(min_ratio, sample_ratio),
+				       std::max(max_ratio, sample_ratio),
+				       ratio_factor,
+				       residual_norm ) );
+    }
 
     // Print initial iteration data.
     printTopBanner();
@@ -358,6 +458,15 @@ bool MCSASolverManager<Vector,Matrix,MonteCarloTag,RNG>::solve()
 	// Update the iteration count.
 	++d_num_iters;
 
+	// Save the solution if this iteration may need to be rolled back.
+	if ( norm_pending )
+	{
+	    VT::update( *d_x_save,
+			Teuchos::ScalarTraits<Scalar>::zero(),
+			*d_problem->getLHS(),
+			Teuchos::ScalarTraits<Scalar>::one() );
+	}
+
 	// Perform smoothing and update the residual.
 	for ( int l = 0; l < smooth_steps; ++l )
 	{
@@ -368,13 +477,80 @@ bool MCSASolverManager<Vector,Matrix,MonteCarloTag,RNG>::solve()
 	VT::putScalar( *d_residual_problem->getLHS(), 0.0 );
 
 	// Solve the residual Monte Carlo problem.
+	transport_time = Teuchos::Time::wallTime();
 	d_mc_solver->solve();
+	transport_time = Teuchos::Time::wallTime() - transport_time;
+
+	// Combine the Monte Carlo correction across sets with the set weights
+	// and record its relative error if estimated.
+	if ( set_error )
+	{
+	    relative_error = 
+		d_multiset_problem->blockConstantVectorSumWithError(
+		    d_residual_problem->getLHS(), set_weight, d_work );
+	    d_relative_error_trace.push_back( relative_error );
+	}
+	else
+	{
+	    VT::scale( *d_residual_problem->getLHS(), set_weight );
+	    d_multiset_problem->blockConstantVectorSum(
+		d_residual_problem->getLHS() );
+	    relative_error = d_mc_solver->relativeErrorNorm();
+	    if ( estimate_error && relative_error >= 0.0 )
+	    {
+		d_relative_error_trace.push_back( relative_error );
+	    }
+	}
+
+	// Use the first iteration as a warm-up to load balance the sample
+	// ratios of the sets with their transport times. The sets are then
+	// weighted by their fraction of the histories.
+	if ( balance_sets && 1 == d_num_iters )
+	{
+	    double balanced_ratio = d_multiset_problem->balanceSampleRatio(
+		sample_ratio, transport_time );
+	    d_plist->set<double>( "Sample Ratio", balanced_ratio );
+	    set_weight = balanced_ratio / 
+			 (sample_ratio * d_multiset_problem->numSets());
+	    set_ratio_scale = balanced_ratio / sample_ratio;
+	}
+
+	// Complete the residual norm of the previous iteration. If it has
+	// converged then roll back this iteration.
+	if ( norm_pending )
+	{
+	    residual_norm = d_problem->finishPrecResidualNorm( norm_request );
+	    norm_pending = false;
+	    if ( residual_norm <= convergence_criteria )
+	    {
+		VT::update( *d_problem->getLHS(),
+			    Teuchos::ScalarTraits<Scalar>::zero(),
+			    *d_x_save,
+			    Teuchos::ScalarTraits<Scalar>::one() );
+		d_problem->updatePrecResidual();
+		do_iterations = 0;
+	    }
+	    if ( print_iter || !do_iterations )
+	    {
+		printIteration( d_num_iters - 1, residual_norm / source_norm );
+	    }
+	    if ( !do_iterations )
+	    {
+		if ( estimate_error && relative_error >= 0.0 )
+		{
+		    d_relative_error_trace.pop_back();
+		}
+		--d_num_iters;
+		continue;
+	    }
 
-	// Combine the Monte Carlo correction across sets and normalize.
-	d_multiset_problem->blockConstantVectorSum(
-	    d_residual_problem->getLHS() );
-	VT::scale( *d_residual_problem->getLHS(),
-		   1.0 / d_multiset_problem->numSets() );
+	    // Adapt the sample ratio with the completed norm.
+	    if ( adapt_ratio )
+	    {
+		adaptSampleRatio( residual_norm, set_ratio_scale, 
+				  interval_start );
+	    }
+	}
 
 	// Apply the correction.
 	VT::update( *d_problem->getLHS(),
@@ -382,39 +558,65 @@ bool MCSASolverManager<Vector,Matrix,MonteCarloTag,RNG>::solve()
 		    *d_residual_problem->getLHS(),
 		    Teuchos::ScalarTraits<Scalar>::one() );
 
-	// Update the preconditioned residual.
-	d_problem->updatePrecResidual();
-	residual_norm = VT::norm2( *d_problem->getPrecResidual() );
-
-	// Check if we're done iterating.
-	if ( d_num_iters % check_freq == 0 )
+	// Update the preconditioned residual. The norm is only computed if
+	// it will be checked or printed.
+	check_iter = (d_num_iters % check_freq == 0) ||
+		     (d_num_iters >= max_num_iters);
+	print_iter = (d_num_iters % print_freq == 0);
+	if ( pipeline_norms && check_iter && (d_num_iters < max_num_iters) )
 	{
-	    do_iterations = (residual_norm > convergence_criteria) &&
-			    (d_num_iters < max_num_iters);
+	    norm_request = d_problem->startPrecResidualNorm();
+	    norm_pending = true;
 	}
-
-	// Print iteration data.
-	if ( d_is_rank_zero &&
-	     ((d_num_iters % print_freq == 0) || !do_iterations) )
+	else
 	{
-	    std::cout << std::setw(18) << d_num_iters;
-	    std::cout << std::setw(18) 
-		      << std::setprecision(4) 
-		      << std::scientific
-		      << residual_norm/source_norm << std::endl;
+	    if ( check_iter || print_iter )
+	    {
+		residual_norm = d_problem->updatePrecResidualNorm();
+	    }
+	    else
+	    {
+		d_problem->updatePrecResidual();
+	    }
+
+	    // Check if we're done iterating.
+	    if ( check_iter )
+	    {
+		do_iterations = (residual_norm > convergence_criteria) &&
+				(d_num_iters < max_num_iters);
+	    }
+
+	    // Print iteration data.
+	    if ( print_iter || !do_iterations )
+	    {
+		printIteration( d_num_iters, residual_norm / source_norm );
+	    }
+
+	    // Adapt the sample ratio if a norm was computed.
+	    if ( adapt_ratio && do_iterations && (check_iter || print_iter) )
+	    {
+		adaptSampleRatio( residual_norm, set_ratio_scale, 
+				  interval_start );
+	    }
 	}
     }
 
     // Finalize.
+    // Restore the sample ratio if the sets were load balanced or the ratio
+    // was adapted.
+    if ( balance_sets || adapt_ratio )
+    {
+	d_plist->set<double>( "Sample Ratio", sample_ratio );
+    }
+
     // Recover the original solution if right preconditioned.
     if ( d_problem->isRightPrec() )
     {
-	Teuchos::RCP<Vector> temp = VT::clone(*d_problem->getLHS());
 	d_problem->applyRightPrec( *d_problem->getLHS(),
-				   *temp );
+				   *d_work );
 	VT::update( *d_problem->getLHS(),
 		    Teuchos::ScalarTraits<Scalar>::zero(),
-		    *temp,
+		    *d_work,
 		    Teuchos::ScalarTraits<Scalar>::one() );
     }
 
@@ -446,6 +648,7 @@ MCSASolverManager<Vector,Matrix,MonteCarloTag,RNG>::buildResidualMonteCarloProbl
     // pass the preconditioners and operator separately to defer composite
     // operator construction until the last possible moment.
     Teuchos::RCP<Vector> delta_x = VT::clone( *d_problem->getLHS() );
+    d_work = VT::clone( *d_problem->getLHS() );
     d_residual_problem = Teuchos::rcp(
 	new LinearProblemType( d_problem->getOperator(),
 			       delta_x,
@@ -496,12 +699,72 @@ void MCSASolverManager<Vector,Matrix,MonteCarloTag,RNG>::printBottomBanner()
 {
     if ( d_is_rank_zero )
     {
+	std::cout << std::endl;
+	std::cout << "Average MC history length: " 
+		  << std::setprecision(4) << std::fixed
+		  << d_mc_solver->averageHistoryLength() << std::endl;
+	if ( d_mc_solver->maxBufferSize() > 0 )
+	{
+	    std::cout << "MC buffer size (min/ave/max): " 
+		      << d_mc_solver->minBufferSize() << " / "
+		      << std::setprecision(1) << std::fixed
+		      << d_mc_solver->averageBufferSize() << " / "
+		      << d_mc_solver->maxBufferSize() << std::endl;
+	}
 	std::cout << std::endl;
         std::cout << "**************************************************" << std::endl;
         std::cout << std::endl;
     } 
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Adapt the sample ratio with the residual norm observed at the end
+ * of an interval of iterations. The interval time is that of the slowest
+ * process such that all sets choose the same nominal ratio. The ratio of
+ * this set is its scaled share of the nominal ratio.
+ */
+template<class Vector, class Matrix, class MonteCarloTag, class RNG>
+void MCSASolverManager<Vector,Matrix,MonteCarloTag,RNG>::adaptSampleRatio(
+    const typename Teuchos::ScalarTraits<Scalar>::magnitudeType residual_norm,
+    const double set_ratio_scale,
+    double& interval_start )
+{
+    MCLS_REQUIRE( Teuchos::nonnull(d_ratio_controller) );
+
+    double interval_time = Teuchos::Time::wallTime() - interval_start;
+    double max_interval_time = 0.0;
+    Teuchos::reduceAll<int,double>( *d_multiset_problem->globalComm(),
+				    Teuchos::REDUCE_MAX,
+				    interval_time,
+				    Teuchos::ptrFromRef(max_interval_time) );
+
+    double nominal_ratio = 
+	d_ratio_controller->update( residual_norm, max_interval_time );
+    d_plist->set<double>( "Sample Ratio", nominal_ratio * set_ratio_scale );
+
+    interval_start = Teuchos::Time::wallTime();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Print the relative residual for an iteration.
+ */
+template<class Vector, class Matrix, class MonteCarloTag, class RNG>
+void MCSASolverManager<Vector,Matrix,MonteCarloTag,RNG>::printIteration(
+    const int iteration,
+    const typename Teuchos::ScalarTraits<Scalar>::magnitudeType rel_residual )
+{
+    if ( d_is_rank_zero )
+    {
+	std::cout << std::setw(18) << iteration;
+	std::cout << std::setw(18) 
+		  << std::setprecision(4) 
+		  << std::scientific
+		  << rel_residual << std::endl;
+    }
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace MCLS
@@ -96,9 +96,37 @@ class MCSolver
     // Set the domain.
     void setDomain( const Teuchos::RCP<Domain>& domain );
 
+    // Update the solver after the values of the current domain were
+    // refilled.
+    void refillDomain();
+
     // Set the source.
     void setSource( const Teuchos::RCP<Source>& source );
 
+    //! Get the average length of the histories completed in the set in the
+    //! last solve.
+    double averageHistoryLength() const
+    { return d_average_history_length; }
+
+    //! Get the minimum history buffer size over all send neighbors in the
+    //! set at the end of the last solve.
+    int minBufferSize() const
+    { return d_min_buffer_size; }
+
+    //! Get the average history buffer size over all send neighbors in the
+    //! set at the end of the last solve.
+    double averageBufferSize() const
+    { return d_average_buffer_size; }
+
+    //! Get the maximum history buffer size over all send neighbors in the
+    //! set at the end of the last solve.
+    int maxBufferSize() const
+    { return d_max_buffer_size; }
+
+    //! Get the number of solves transported by this solver.
+    std::size_t numSolves() const
+    { return d_num_solves; }
+
   private:
 
     // Set-constant communicator.
@@ -122,6 +150,21 @@ class MCSolver
     // Source.
     Teuchos::RCP<Source> d_source;
 
+    // Number of solves transported by this solver.
+    std::size_t d_num_solves;
+
+    // Average length of the histories completed in the last solve.
+    double d_average_history_length;
+
+    // Minimum history buffer size at the end of the last solve.
+    int d_min_buffer_size;
+
+    // Average history buffer size at the end of the last solve.
+    double d_average_buffer_size;
+
+    // Maximum history buffer size at the end of the last solve.
+    int d_max_buffer_size;
+
 #if HAVE_MCLS_TIMERS
     // Monte Carlo timer.
     Teuchos::RCP<Teuchos::Time> d_mc_timer;
@@ -42,14 +42,48 @@
 #define MCLS_MCSOLVER_IMPL_HPP
 
 #include <string>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
 
 #include "MCLS_DBC.hpp"
 #include "MCLS_GlobalTransporterFactory.hpp"
 
 #include <Teuchos_ScalarTraits.hpp>
+#include <Teuchos_CommHelpers.hpp>
+#include <Teuchos_as.hpp>
 
 namespace MCLS
 {
+//---------------------------------------------------------------------------//
+/*!
+ * \class SolveStatisticsReductionOp
+ * \brief Reduction of the transport statistics of a solve in a single
+ * collective. The last two entries are reduced with a maximum and all others
+ * with a sum. A minimum is reduced as the maximum of its negative.
+ */
+class SolveStatisticsReductionOp 
+    : public Teuchos::ValueTypeReductionOp<int,long>
+{
+  public:
+
+    //! Reduce the input buffer into the in/out buffer.
+    void reduce( const int count, 
+		 const long in_buffer[], 
+		 long inout_buffer[] ) const
+    {
+	MCLS_REQUIRE( count >= 2 );
+	for ( int i = 0; i < count - 2; ++i )
+	{
+	    inout_buffer[i] += in_buffer[i];
+	}
+	for ( int i = count - 2; i < count; ++i )
+	{
+	    inout_buffer[i] = std::max( inout_buffer[i], in_buffer[i] );
+	}
+    }
+};
+
 //---------------------------------------------------------------------------//
 /*!
  * \brief Constructor.
@@ -60,7 +94,11 @@ MCSolver<Source>::MCSolver( const Teuchos::RCP<const Comm>& set_comm,
 			    const Teuchos::RCP<Teuchos::ParameterList>& plist )
     : d_set_comm( set_comm )
     , d_plist( plist )
-    , d_rng( Teuchos::rcp(new PRNG<rng_type>(global_rank)) )
+    , d_num_solves( 0 )
+    , d_average_history_length( 0.0 )
+    , d_min_buffer_size( 0 )
+    , d_average_buffer_size( 0.0 )
+    , d_max_buffer_size( 0 )
 #if HAVE_MCLS_TIMERS
     , d_mc_timer( Teuchos::TimeMonitor::getNewCounter("MCLS: MC Transport") )
 #endif
@@ -68,8 +106,38 @@ MCSolver<Source>::MCSolver( const Teuchos::RCP<const Comm>& set_comm,
     MCLS_REQUIRE( Teuchos::nonnull(d_plist) );
     MCLS_REQUIRE( Teuchos::nonnull(d_set_comm) );
 
-    // Set the static byte size for the histories.
-    HT::setByteSize();
+    // Create the random number generator. In reproducible mode all
+    // processes share the same seed.
+    bool reproducible = false;
+    if ( d_plist->isParameter("Reproducible MC Mode") )
+    {
+	reproducible = d_plist->get<bool>("Reproducible MC Mode");
+    }
+    if ( reproducible )
+    {
+	int seed = 433494437;
+	if ( d_plist->isParameter("Random Number Seed") )
+	{
+	    seed = d_plist->get<int>("Random Number Seed");
+	}
+	d_rng = Teuchos::rcp( new PRNG<rng_type>(global_rank,seed) );
+
+	// Histories in the set are drawn from a stream keyed by the lowest
+	// global rank in the set such that each set has its own stream.
+	int set_key = 0;
+	Teuchos::reduceAll<int,int>( *d_set_comm, Teuchos::REDUCE_MIN,
+				     global_rank, Teuchos::outArg(set_key) );
+	d_rng->setHistoryStream( set_key );
+    }
+    else
+    {
+	d_rng = Teuchos::rcp( new PRNG<rng_type>(global_rank) );
+    }
+
+    // Set the static byte size for the histories. In reproducible mode the
+    // history ids are packed such that a communicated history keeps its
+    // random number substream.
+    HT::setByteSize( false, false, d_rng->reproducible() );
 
     MCLS_ENSURE( HT::getPackedBytes() > 0 );
     MCLS_ENSURE( Teuchos::nonnull(d_rng) );
@@ -96,6 +164,11 @@ void MCSolver<Source>::solve()
     // Assign the source to the transporter.
     d_transporter->assignSource( d_source );
 
+    // Key the history substreams with this solve such that the histories of
+    // each solve draw new random sequences.
+    d_rng->setSolve( d_num_solves );
+    ++d_num_solves;
+
     // Transport the source to solve the problem.
     {
 #if HAVE_MCLS_TIMERS
@@ -104,6 +177,43 @@ void MCSolver<Source>::solve()
 	d_transporter->transport();
     }
 
+    // Compute the average length of the histories completed in the set and
+    // the history buffer size statistics over all send neighbors in the set
+    // with a single reduction.
+    Teuchos::Array<int> buffer_sizes = d_transporter->sendBufferSizes();
+    int local_min_size = std::numeric_limits<int>::max();
+    int local_max_size = 0;
+    long local_size_sum = 0;
+    for ( int n = 0; n < buffer_sizes.size(); ++n )
+    {
+	local_min_size = std::min( local_min_size, buffer_sizes[n] );
+	local_max_size = std::max( local_max_size, buffer_sizes[n] );
+	local_size_sum += buffer_sizes[n];
+    }
+    long local_stats[6] = { d_transporter->numCompletedHistories(),
+			    d_transporter->numCompletedSteps(),
+			    local_size_sum,
+			    buffer_sizes.size(),
+			    -Teuchos::as<long>(local_min_size),
+			    local_max_size };
+    long global_stats[6] = { 0, 0, 0, 0, 0, 0 };
+    Teuchos::reduceAll<int,long>( *d_set_comm, SolveStatisticsReductionOp(),
+				  6, local_stats, global_stats );
+    d_average_history_length = (global_stats[0] > 0) ?
+	Teuchos::as<double>(global_stats[1]) / global_stats[0] : 0.0;
+    d_min_buffer_size = Teuchos::as<int>( -global_stats[4] );
+    d_max_buffer_size = Teuchos::as<int>( global_stats[5] );
+    if ( global_stats[3] > 0 )
+    {
+	d_average_buffer_size = 
+	    Teuchos::as<double>(global_stats[2]) / global_stats[3];
+    }
+    else
+    {
+	d_min_buffer_size = 0;
+	d_average_buffer_size = 0.0;
+    }
+
     // Finalize the set tallies.
     TT::finalize( *d_tally );
 
@@ -129,6 +239,22 @@ void MCSolver<Source>::setDomain( const Teuchos::RCP<Domain>& domain )
     // Get the domain tally.
     d_tally = DT::domainTally( *d_domain );
 
+    // Pack global states as 32-bit integers if every global state in the set
+    // fits and step counts as 16-bit integers if the history length limit of
+    // every domain in the set fits. Both maxima are found in one reduction.
+    // History ids are packed in reproducible mode.
+    typedef typename DT::ordinal_type Ordinal;
+    Ordinal local_max[2] = 
+	{ DT::maxLocalState( *d_domain ), 
+	  Teuchos::as<Ordinal>(DT::historyLength( *d_domain )) };
+    Ordinal global_max[2] = { 0, 0 };
+    Teuchos::reduceAll<int,Ordinal>( *d_set_comm, Teuchos::REDUCE_MAX, 2,
+				     local_max, global_max );
+    HT::setByteSize( 
+	global_max[0] <= std::numeric_limits<std::int32_t>::max(),
+	global_max[1] <= std::numeric_limits<std::uint16_t>::max(),
+	d_rng->reproducible() );
+
     // Generate the source transporter.
     d_transporter = GlobalTransporterFactory<Source>::create(
         d_set_comm, d_domain, *d_plist );
@@ -138,6 +264,26 @@ void MCSolver<Source>::setDomain( const Teuchos::RCP<Domain>& domain )
     MCLS_ENSURE( Teuchos::nonnull(d_transporter) );
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Update the solver after the values of the current domain were
+ * refilled. The domain structure has not changed so the packed history size
+ * and the transporter with its communication buffers are kept. Only the
+ * tally, which the domain may have rebuilt, is rebound. The source must be
+ * set again before solving.
+ */
+template<class Source>
+void MCSolver<Source>::refillDomain()
+{
+    MCLS_REQUIRE( Teuchos::nonnull(d_domain) );
+    MCLS_REQUIRE( Teuchos::nonnull(d_transporter) );
+
+    // Get the domain tally. The transporter rebinds it when reset.
+    d_tally = DT::domainTally( *d_domain );
+
+    MCLS_ENSURE( Teuchos::nonnull(d_tally) );
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * \brief Set the source for transport. Must always be called after
@@ -156,6 +302,9 @@ void MCSolver<Source>::setSource( const Teuchos::RCP<Source>& source )
 
     // Build the source.
     ST::buildSource( *d_source );
+
+    // Set the source weight with the domain for the weight cutoff.
+    DT::setSourceWeight( *d_domain, ST::sourceWeight(*d_source) );
     MCLS_ENSURE( Teuchos::nonnull(d_source) );
 }
 
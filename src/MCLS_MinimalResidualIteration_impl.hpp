@@ -119,21 +119,22 @@ void MinimalResidualIteration<Vector,Matrix>::doOneIteration()
     // Build p = A*r.
     d_problem->apply( *d_problem->getPrecResidual(), *d_p );
 
-    // Petrov-Galerkin condition.
-    Scalar alpha = VT::dot( *d_p, *d_problem->getPrecResidual() ) /
-                   VT::dot( *d_p, *d_p );
-
-    // Fixed point update.
-    VT::update( *d_problem->getLHS(), 
-                Teuchos::ScalarTraits<Scalar>::one(),
-                *d_problem->getPrecResidual(),
-                alpha );
-
-    // Residual update.
-    VT::update( *d_problem->getPrecResidual(),
-                Teuchos::ScalarTraits<Scalar>::one(),
-                *d_p,
-                -alpha );
+    // Petrov-Galerkin condition. Both inner products are computed in a
+    // single pass.
+    Scalar p_dot_r = Teuchos::ScalarTraits<Scalar>::zero();
+    Scalar p_dot_p = Teuchos::ScalarTraits<Scalar>::zero();
+    VT::dotPair( *d_p, 
+                 *d_problem->getPrecResidual(), 
+                 *d_p,
+                 p_dot_r,
+                 p_dot_p );
+    Scalar alpha = p_dot_r / p_dot_p;
+
+    // Fixed point and residual update in a single pass.
+    VT::updatePair( *d_problem->getLHS(), 
+                    *d_problem->getPrecResidual(),
+                    *d_p,
+                    alpha );
 }
 
 //---------------------------------------------------------------------------//
@@ -99,6 +99,12 @@ class MonteCarloTagTraits<Vector,Matrix,RNG,AdjointTag>
 /*!
  * \class MonteCarloSolverManager
  * \brief Solver manager for analog Monte Carlo.
+ *
+ * If "Estimate Relative Error" is set, the relative error norm of the
+ * Monte Carlo estimate is computed after each solve from the variance
+ * estimated by the tally. The adjoint tally estimates it by batch means over
+ * "Variance Batches" batches of histories. The forward tally estimates it
+ * from the complete history scores.
  */
 template<class Vector,
 	 class Matrix,
@@ -153,6 +159,31 @@ class MonteCarloSolverManager : public SolverManager<Vector,Matrix>
     // Get the number of iterations from the last linear solve.
     int getNumIters() const;
 
+    // Get the average length of the histories completed in the last linear
+    // solve.
+    double averageHistoryLength() const
+    { return d_mc_solver->averageHistoryLength(); }
+
+    // Get the minimum history buffer size over the send neighbors in the set
+    // at the end of the last linear solve.
+    int minBufferSize() const
+    { return d_mc_solver->minBufferSize(); }
+
+    // Get the average history buffer size over the send neighbors in the
+    // set at the end of the last linear solve.
+    double averageBufferSize() const
+    { return d_mc_solver->averageBufferSize(); }
+
+    // Get the maximum history buffer size over the send neighbors in the set
+    // at the end of the last linear solve.
+    int maxBufferSize() const
+    { return d_mc_solver->maxBufferSize(); }
+
+    // Get the relative error norm of the Monte Carlo estimate of the last
+    // linear solve. Negative if it was not estimated.
+    double relativeErrorNorm() const
+    { return d_relative_error; }
+
     // Set the linear problem with the manager.
     void setProblem( 
 	const Teuchos::RCP<LinearProblem<Vector,Matrix> >& problem );
@@ -190,6 +221,12 @@ class MonteCarloSolverManager : public SolverManager<Vector,Matrix>
     // Build the Monte Carlo source from the provided linear problem.
     void buildMonteCarloSource();
 
+    // Allocate the work vectors for the provided linear problem.
+    void buildWorkVectors();
+
+    // Estimate the relative error norm of the Monte Carlo estimate.
+    void estimateRelativeError();
+
   private:
 
     // Linear problem
@@ -210,9 +247,25 @@ class MonteCarloSolverManager : public SolverManager<Vector,Matrix>
     // Local source for this proc.
     Teuchos::RCP<SourceType> d_source;
 
+    // Sample ratio the local source was built with.
+    double d_source_ratio;
+
     // Monte Carlo set solver.
     Teuchos::RCP<MCSolver<SourceType> > d_mc_solver;
 
+    // Modified source vector. Refilled from the right-hand side each solve.
+    Teuchos::RCP<Vector> d_source_vector;
+
+    // Preconditioner work vector.
+    Teuchos::RCP<Vector> d_work;
+
+    // Tally variance vector. Allocated when the relative error is first
+    // estimated.
+    Teuchos::RCP<Vector> d_variance;
+
+    // Relative error norm of the last Monte Carlo estimate.
+    double d_relative_error;
+
 #if HAVE_MCLS_TIMERS
     // Total solve timer.
     Teuchos::RCP<Teuchos::Time> d_solve_timer;
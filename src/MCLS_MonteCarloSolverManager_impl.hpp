@@ -41,6 +41,8 @@
 #ifndef MCLS_MONTECARLOSOLVERMANAGER_IMPL_HPP
 #define MCLS_MONTECARLOSOLVERMANAGER_IMPL_HPP
 
+#include <cmath>
+
 #include "MCLS_DBC.hpp"
 
 #include <Teuchos_TimeMonitor.hpp>
@@ -60,6 +62,8 @@ MonteCarloSolverManager<Vector,Matrix,MonteCarloTag,RNG>::MonteCarloSolverManage
     : d_plist( plist )
     , d_global_rank( global_rank )
     , d_internal_solver( internal_solver )
+    , d_source_ratio( 0.0 )
+    , d_relative_error( -1.0 )
 #if HAVE_MCLS_TIMERS
     , d_solve_timer( Teuchos::TimeMonitor::getNewCounter("MCLS: MC Solve") )
 #endif
@@ -81,6 +85,8 @@ MonteCarloSolverManager<Vector,Matrix,MonteCarloTag,RNG>::MonteCarloSolverManage
     , d_plist( plist )
     , d_global_rank( global_rank )
     , d_internal_solver( internal_solver )
+    , d_source_ratio( 0.0 )
+    , d_relative_error( -1.0 )
 #if HAVE_MCLS_TIMERS
     , d_solve_timer( Teuchos::TimeMonitor::getNewCounter("MCLS: MC Solve") )
 #endif
@@ -88,6 +94,7 @@ MonteCarloSolverManager<Vector,Matrix,MonteCarloTag,RNG>::MonteCarloSolverManage
     MCLS_REQUIRE( Teuchos::nonnull(d_plist) );
 
     buildMonteCarloDomain();
+    buildWorkVectors();
 }
 
 //---------------------------------------------------------------------------//
@@ -105,7 +112,23 @@ MonteCarloSolverManager<Vector,Matrix,MonteCarloTag,RNG>::getValidParameters() c
     plist->set<double>("History Length", 10);
     plist->set<int>("MC Check Frequency", 1000);
     plist->set<int>("MC Buffer Size", 1000);
+    plist->set<int>("MC Min Buffer Size", 0);
+    plist->set<int>("MC Max Buffer Size", 0);
+    plist->set<int>("MC Send Buffers Per Neighbor", 2);
+    plist->set<int>("MC Termination Tree Width", 2);
     plist->set<double>("Neumann Relaxation", 1.0);
+    plist->set<int>("Overlap Size", 0);
+    plist->set<double>("Weight Cutoff", 0.0);
+    plist->set<bool>("Russian Roulette", false);
+    plist->set<std::string>("Estimator Type", "Collision");
+    plist->set<std::string>("Transition Sampler", "CDF");
+    plist->set<int>("Alias Table Minimum Row Size", 16);
+    plist->set<int>("History Batch Size", 1);
+    plist->set<bool>("Reproducible MC Mode", false);
+    plist->set<int>("Random Number Seed", 433494437);
+    plist->set<bool>("Reuse Domain Structure", false);
+    plist->set<bool>("Estimate Relative Error", false);
+    plist->set<int>("Variance Batches", 10);
     return plist;
 }
 
@@ -175,6 +198,7 @@ void MonteCarloSolverManager<Vector,Matrix,MonteCarloTag,RNG>::setProblem(
     if ( update_operator )
     {
         buildMonteCarloDomain();
+        buildWorkVectors();
     }
 }
 
@@ -189,6 +213,9 @@ void MonteCarloSolverManager<Vector,Matrix,MonteCarloTag,RNG>::setParameters(
 {
     MCLS_REQUIRE( Teuchos::nonnull(params) );
     d_plist = params;
+
+    // The source reads its sampling parameters on construction.
+    d_source = Teuchos::null;
 }
 
 //---------------------------------------------------------------------------//
@@ -213,19 +240,45 @@ bool MonteCarloSolverManager<Vector,Matrix,MonteCarloTag,RNG>::solve()
 
     // Initialize the tally.
     initializeTally( MonteCarloTag() );
+
+    // If the relative error is estimated, set the number of batches the
+    // tally keeps for its variance estimate.
+    bool estimate_error = false;
+    if ( d_plist->isParameter("Estimate Relative Error") )
+    {
+	estimate_error = d_plist->get<bool>("Estimate Relative Error");
+    }
+    int num_batches = 0;
+    if ( estimate_error )
+    {
+	num_batches = 10;
+	if ( d_plist->isParameter("Variance Batches") )
+	{
+	    num_batches = d_plist->get<int>("Variance Batches");
+	}
+    }
+    TallyTraits<typename MCTT::tally_type>::setVarianceBatches( 
+	*d_domain->domainTally(), num_batches );
     
     // Solve the Monte Carlo problem over the set.
     d_mc_solver->solve();
 
+    // Estimate the relative error of the Monte Carlo estimate from the tally
+    // variance if requested.
+    d_relative_error = -1.0;
+    if ( estimate_error )
+    {
+	estimateRelativeError();
+    }
+
     // If we're right preconditioned then we have to recover the original
     // solution.
     if ( d_problem->isRightPrec() && !d_internal_solver )
     {
-	Teuchos::RCP<Vector> temp = VT::clone(*d_problem->getLHS());
-	d_problem->applyRightPrec( *d_problem->getLHS(), *temp );
+	d_problem->applyRightPrec( *d_problem->getLHS(), *d_work );
 	VT::update( *d_problem->getLHS(),
 		    Teuchos::ScalarTraits<Scalar>::zero(),
-		    *temp,
+		    *d_work,
 		    Teuchos::ScalarTraits<Scalar>::one() );
     }
 
@@ -268,28 +321,9 @@ template<class Vector, class Matrix, class MonteCarloTag, class RNG>
 void MonteCarloSolverManager<Vector,Matrix,MonteCarloTag,RNG>::initializeTally(
     ForwardTag )
 {
-    // Get a copy of the source so we can modify it.
-    Teuchos::RCP<Vector> rhs_copy = VT::deepCopy( *d_problem->getRHS() );
-
-    // Left precondition the source if necessary.
-    if ( d_problem->isLeftPrec() && !d_internal_solver )
-    {
-	Teuchos::RCP<Vector> temp = VT::clone(*rhs_copy);
-	d_problem->applyLeftPrec( *rhs_copy, *temp );
-	VT::update( *rhs_copy,
-		    Teuchos::ScalarTraits<Scalar>::zero(),
-		    *temp,
-		    Teuchos::ScalarTraits<Scalar>::one() );
-    }
-
-    // Scale by the Neumann relaxation parameter.
-    if ( d_plist->isParameter("Neumann Relaxation") )
-    {
-	double omega = d_plist->get<double>("Neumann Relaxation");
-	VT::scale( *rhs_copy, omega );
-    }
-
-    d_domain->domainTally()->setSource( rhs_copy );
+    // The source vector was filled when the source was built for this solve.
+    MCLS_REQUIRE( Teuchos::nonnull(d_source_vector) );
+    d_domain->domainTally()->setSource( d_source_vector );
 }
 
 //---------------------------------------------------------------------------//
@@ -327,13 +361,32 @@ void MonteCarloSolverManager<Vector,Matrix,MonteCarloTag,RNG>::buildMonteCarloDo
     {
 	threshold =  d_plist->get<double>("Composite Operator Threshold");
     }
-    d_domain = Teuchos::rcp( 
-	new DomainType( getCompositeOperator(threshold,MonteCarloTag()),
-			d_problem->getLHS(),
-			*d_plist ) );
+    // If requested, reuse the boundary, neighbor, and column structure of an
+    // existing domain and only refill the operator values. The operator must
+    // have the same sparsity pattern. The solver then keeps its transporter
+    // and only rebinds the tally.
+    bool reuse_structure = false;
+    if ( d_plist->isParameter("Reuse Domain Structure") )
+    {
+	reuse_structure = d_plist->get<bool>("Reuse Domain Structure");
+    }
+    if ( reuse_structure && Teuchos::nonnull(d_domain) )
+    {
+	d_domain->refillValues( getCompositeOperator(threshold,MonteCarloTag()),
+				d_problem->getLHS(),
+				*d_plist );
+	d_mc_solver->refillDomain();
+    }
+    else
+    {
+	d_domain = Teuchos::rcp( 
+	    new DomainType( getCompositeOperator(threshold,MonteCarloTag()),
+			    d_problem->getLHS(),
+			    *d_plist ) );
 
-    // Set the local domain with the monte carlo solver.
-    d_mc_solver->setDomain( d_domain );
+	// Set the local domain with the monte carlo solver.
+	d_mc_solver->setDomain( d_domain );
+    }
 
     MCLS_ENSURE( Teuchos::nonnull(d_domain) );
     MCLS_ENSURE( Teuchos::nonnull(d_mc_solver) );
@@ -350,17 +403,19 @@ void MonteCarloSolverManager<Vector,Matrix,MonteCarloTag,RNG>::buildMonteCarloSo
     MCLS_REQUIRE( Teuchos::nonnull(d_domain()) );
     MCLS_REQUIRE( Teuchos::nonnull(d_mc_solver) );
 
-    // Get a copy of the source so we can modify it.
-    Teuchos::RCP<Vector> rhs_copy = VT::deepCopy( *d_problem->getRHS() );
+    // Copy the source into the work vector so we can modify it.
+    VT::update( *d_source_vector,
+		Teuchos::ScalarTraits<Scalar>::zero(),
+		*d_problem->getRHS(),
+		Teuchos::ScalarTraits<Scalar>::one() );
 
     // Left precondition the source if necessary.
     if ( d_problem->isLeftPrec() && !d_internal_solver )
     {
-	Teuchos::RCP<Vector> temp = VT::clone(*rhs_copy);
-	d_problem->applyLeftPrec( *rhs_copy, *temp );
-	VT::update( *rhs_copy,
+	d_problem->applyLeftPrec( *d_source_vector, *d_work );
+	VT::update( *d_source_vector,
 		    Teuchos::ScalarTraits<Scalar>::zero(),
-		    *temp,
+		    *d_work,
 		    Teuchos::ScalarTraits<Scalar>::one() );
     }
 
@@ -368,17 +423,77 @@ void MonteCarloSolverManager<Vector,Matrix,MonteCarloTag,RNG>::buildMonteCarloSo
     if ( d_plist->isParameter("Neumann Relaxation") )
     {
 	double omega = d_plist->get<double>("Neumann Relaxation");
-	VT::scale( *rhs_copy, omega );
+	VT::scale( *d_source_vector, omega );
     }
 
-    // Build the source.
-    d_source = Teuchos::rcp( new SourceType(rhs_copy,d_domain,*d_plist) );
+    // Build the source once for the current domain, work vector, and
+    // parameters. It is resampled from the source vector values each
+    // solve. The sample ratio may be changed in the parameters between solves
+    // by an outer solver and the source is then rebuilt.
+    double sample_ratio = 1.0;
+    if ( d_plist->isParameter("Sample Ratio") )
+    {
+	sample_ratio = d_plist->get<double>("Sample Ratio");
+    }
+    if ( Teuchos::is_null(d_source) || sample_ratio != d_source_ratio )
+    {
+	d_source = 
+	    Teuchos::rcp( new SourceType(d_source_vector,d_domain,*d_plist) );
+	d_source_ratio = sample_ratio;
+    }
     MCLS_ENSURE( Teuchos::nonnull(d_source) );
 
     // Set the local source with the solver.
     d_mc_solver->setSource( d_source );
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Allocate the work vectors for the provided linear problem. These
+ * persist over all solves with the same operator so that no vectors are
+ * created in repeated solves.
+ */
+template<class Vector, class Matrix, class MonteCarloTag, class RNG>
+void MonteCarloSolverManager<Vector,Matrix,MonteCarloTag,RNG>::buildWorkVectors()
+{
+    MCLS_REQUIRE( Teuchos::nonnull(d_problem) );
+
+    d_source_vector = VT::clone( *d_problem->getRHS() );
+    d_work = VT::clone( *d_problem->getLHS() );
+    d_variance = Teuchos::null;
+    d_source = Teuchos::null;
+
+    MCLS_ENSURE( Teuchos::nonnull(d_source_vector) );
+    MCLS_ENSURE( Teuchos::nonnull(d_work) );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Estimate the relative error norm of the Monte Carlo estimate from
+ * the variance of the tally. The relative error norm is the 2-norm of the
+ * standard deviation of the estimate over the 2-norm of the estimate.
+ */
+template<class Vector, class Matrix, class MonteCarloTag, class RNG>
+void MonteCarloSolverManager<Vector,Matrix,MonteCarloTag,RNG>::estimateRelativeError()
+{
+    typedef TallyTraits<typename MCTT::tally_type> TT;
+
+    if ( Teuchos::is_null(d_variance) )
+    {
+	d_variance = VT::clone( *d_problem->getLHS() );
+    }
+
+    if ( TT::estimateVariance(*d_domain->domainTally(), *d_variance) )
+    {
+	Teuchos::RCP<Vector> x = TT::getVector( *d_domain->domainTally() );
+	Scalar variance_sum = 0.0;
+	Scalar x_norm_squared = 0.0;
+	VT::sumAndNorm2Squared( *d_variance, *x, variance_sum, x_norm_squared );
+	d_relative_error = ( x_norm_squared > 0.0 ) ?
+			   std::sqrt( variance_sum / x_norm_squared ) : 0.0;
+    }
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace MCLS
@@ -117,6 +117,22 @@ class MultiSetLinearProblem
     // the LHS and RHS of the set linear problem.
     void blockConstantVectorSum( const Teuchos::RCP<Vector>& vector ) const;
 
+    // Sum a weighted vector over sets (block-constant) and estimate the
+    // relative error of the sum from the spread of the set vectors. Each set
+    // receives the resulting sum. The set weights must sum to one. The
+    // variance vector is used as work space and receives the variance
+    // estimate of the sum.
+    double blockConstantVectorSumWithError( 
+	const Teuchos::RCP<Vector>& vector,
+	const double weight,
+	const Teuchos::RCP<Vector>& variance ) const;
+
+    // Load balance the sample ratios of the sets in each block with their
+    // measured transport times. Returns the new sample ratio of the local
+    // set.
+    double balanceSampleRatio( const double sample_ratio,
+			       const double transport_time ) const;
+
   private:
 
     // Build the set-constant and block-constant communicators.
@@ -41,6 +41,10 @@
 #ifndef MCLS_MULTISETLINEARPROBLEM_IMPL_HPP
 #define MCLS_MULTISETLINEARPROBLEM_IMPL_HPP
 
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
 #include "MCLS_DBC.hpp"
 
 #include <Teuchos_TimeMonitor.hpp>
@@ -119,6 +123,125 @@ void MultiSetLinearProblem<Vector,Matrix>::blockConstantVectorSum(
 				    vector_view.getRawPtr() );
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Sum a weighted vector over sets (block-constant) and estimate the
+ * relative error of the sum from the spread of the set vectors.
+ *
+ * The sets are independent estimates of the same vector such that the
+ * variance of the weighted sum in each state is estimated by
+ * sum(w*x^2 - xbar^2)/(S-1) for S sets. With sets weighted by their fraction
+ * of the histories this is the batch means estimate with the sets as
+ * batches. The weighted vector and its square are summed in a single block
+ * reduction. The returned relative error is the 2-norm of the standard
+ * deviation over the 2-norm of the sum. This must be called on all
+ * processes.
+ */
+template<class Vector, class Matrix>
+double MultiSetLinearProblem<Vector,Matrix>::blockConstantVectorSumWithError( 
+    const Teuchos::RCP<Vector>& vector, 
+    const double weight,
+    const Teuchos::RCP<Vector>& variance ) const
+{
+#if HAVE_MCLS_TIMERS
+    Teuchos::TimeMonitor bcvs_monitor( *d_bcvs_timer );
+#endif
+
+    MCLS_REQUIRE( Teuchos::nonnull(vector) );
+    MCLS_REQUIRE( Teuchos::nonnull(variance) );
+    MCLS_REQUIRE( VT::getLocalLength(*vector) == 
+		  VT::getLocalLength(*variance) );
+    MCLS_REQUIRE( d_num_sets > 1 );
+
+    // Weight the vector and its square.
+    VT::elementWiseMultiply( *variance, 0.0, *vector, *vector, weight );
+    VT::scale( *vector, weight );
+
+    // Sum the weighted vector and its weighted square over the sets.
+    Teuchos::ArrayRCP<Scalar> vector_view = VT::viewNonConst( *vector );
+    Teuchos::ArrayRCP<Scalar> variance_view = VT::viewNonConst( *variance );
+    int local_length = vector_view.size();
+    Teuchos::Array<Scalar> local_moments( 2*local_length );
+    Teuchos::Array<Scalar> block_moments( 2*local_length );
+    std::copy( vector_view.begin(), vector_view.end(), 
+	       local_moments.begin() );
+    std::copy( variance_view.begin(), variance_view.end(), 
+	       local_moments.begin() + local_length );
+    Teuchos::reduceAll<int,Scalar>( *d_block_comm,
+				    Teuchos::REDUCE_SUM,
+				    local_moments.size(),
+				    local_moments.getRawPtr(),
+				    block_moments.getRawPtr() );
+    std::copy( block_moments.begin(), block_moments.begin() + local_length,
+	       vector_view.begin() );
+    std::copy( block_moments.begin() + local_length, block_moments.end(),
+	       variance_view.begin() );
+    vector_view = Teuchos::null;
+    variance_view = Teuchos::null;
+
+    // Estimate the variance of the sum and reduce the norms over the set.
+    double inv_sets = 1.0 / (d_num_sets - 1);
+    VT::elementWiseMultiply( 
+	*variance, inv_sets, *vector, *vector, -inv_sets );
+    Scalar variance_sum = 0.0;
+    Scalar vector_norm_squared = 0.0;
+    VT::sumAndNorm2Squared( 
+	*variance, *vector, variance_sum, vector_norm_squared );
+    variance_sum = std::max( variance_sum, 0.0 );
+
+    return ( vector_norm_squared > 0.0 ) ? 
+	std::sqrt( variance_sum / vector_norm_squared ) : 0.0;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Load balance the sample ratios of the sets in each block with their
+ * measured transport times.
+ *
+ * A set finishes its transport when its slowest process does. The sample
+ * ratios of the replicated sets are redistributed in proportion to the
+ * measured history rate of each set such that the sets finish together while
+ * the total number of histories over the sets is kept. A set should then be
+ * weighted by its fraction of the total sample ratio when the set results
+ * are combined. This must be called on all processes.
+ *
+ * All processes in a set get the same ratio. The source of a set is
+ * normalized over the whole set and histories move between its processes,
+ * so a different ratio on one process would bias the set estimate without
+ * bounding that process's work.
+ */
+template<class Vector, class Matrix>
+double MultiSetLinearProblem<Vector,Matrix>::balanceSampleRatio( 
+    const double sample_ratio, const double transport_time ) const
+{
+    MCLS_REQUIRE( sample_ratio > 0.0 );
+    MCLS_REQUIRE( transport_time >= 0.0 );
+
+    // The set transport time is that of its slowest process.
+    double set_time = 0.0;
+    Teuchos::reduceAll<int,double>( *d_set_comm,
+				    Teuchos::REDUCE_MAX,
+				    transport_time,
+				    Teuchos::outArg(set_time) );
+    set_time = std::max( set_time, std::numeric_limits<double>::epsilon() );
+
+    // Sum the sample ratios and the history rates of the sets.
+    double local_sums[2] = { sample_ratio, sample_ratio / set_time };
+    double block_sums[2] = { 0.0, 0.0 };
+    Teuchos::reduceAll<int,double>( *d_block_comm,
+				    Teuchos::REDUCE_SUM,
+				    2,
+				    local_sums,
+				    block_sums );
+
+    // Give each set a share of the total sample ratio proportional to its
+    // history rate.
+    double balanced_ratio = block_sums[0] * local_sums[1] / block_sums[1];
+
+    MCLS_ENSURE( balanced_ratio > 0.0 );
+    return balanced_ratio;
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * \brief Set the linear operator.
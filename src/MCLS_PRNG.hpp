@@ -41,7 +41,12 @@
 #ifndef MCLS_PRNG_HPP
 #define MCLS_PRNG_HPP
 
+#include <MCLS_DBC.hpp>
 #include <MCLS_RNGTraits.hpp>
+#include <MCLS_ThreadTools.hpp>
+
+#include <Teuchos_RCP.hpp>
+#include <Teuchos_Array.hpp>
 
 namespace MCLS
 {
@@ -49,6 +54,28 @@ namespace MCLS
 /*!
  * \class PRNG
  * \brief Parallel manager class for c++11 random number generators.
+ *
+ * Each thread that may be used for transport within a process has its own
+ * generator keyed through RNGTraits with the stream (global rank, thread).
+ * Random numbers are drawn from the stream of the calling thread. Keying a
+ * stream is O(1) for all ranks.
+ *
+ * In reproducible mode all processes share a user-provided seed and each
+ * history is drawn from its own substream keyed by (seed, solve, history
+ * stream, history id). The history id is assigned by the source and carried
+ * with the history when it is communicated and the history stream
+ * identifies the set. Before each step beginStep() keys the generator of the
+ * calling thread to the substream of the history at an offset of STEP_DRAWS
+ * random numbers per step already taken. The random sequence of a history
+ * therefore does not depend on the thread or process that transports it, on
+ * how many domain boundaries it crosses, or on whether it is transported
+ * alone or in a lockstep batch. The solver sets a new solve for each
+ * transport such that a history id draws a new sequence in every solve.
+ * With a counter-based generator such as Philox the offset is reached
+ * directly in the substream. Other generators key an independent sequence
+ * for each step. Substream 0 of every stream is reserved for the thread
+ * streams such that history substreams never overlap them. Otherwise the
+ * seed is drawn from a random device on each process.
  */
 //---------------------------------------------------------------------------//
 template<class RNG>
@@ -64,18 +91,80 @@ class PRNG
     typedef RandomDistributionTraits<IntDistribution> IDT;
     //@}
 
-    // Constructor.
-    PRNG( const int comm_rank );
+    //! Number of random numbers reserved for each step of a history in
+    //! reproducible mode.
+    enum StepDraws { STEP_DRAWS = 2 };
+
+    // Non-reproducible constructor.
+    explicit PRNG( const int comm_rank );
+
+    // Reproducible constructor.
+    PRNG( const int comm_rank, const std::size_t seed );
 
     // Get a random number from a specified distribution.
     template<class RandomDistribution>
     inline typename RandomDistributionTraits<RandomDistribution>::result_type
     random( RandomDistribution& distribution );
 
+    // Get a uniform random number in [0,1).
+    inline double uniform();
+
+    // Fill an array with uniform random numbers in [0,1).
+    inline void fill( double* values, const int num_values );
+
+    // Key the calling thread to a step of the substream of a history.
+    inline void beginStep( const std::size_t history_id, const int step );
+
+    // Set the stream from which history substreams are drawn.
+    void setHistoryStream( const std::size_t stream )
+    { d_history_stream = stream; }
+
+    // Set the solve for which history substreams are drawn.
+    void setSolve( const std::size_t solve );
+
+    //! Get the solve for which history substreams are drawn.
+    std::size_t solve() const
+    { return d_solve; }
+
+    //! Get the stream from which history substreams are drawn.
+    std::size_t historyStream() const
+    { return d_history_stream; }
+
+    //! Get the seed.
+    std::size_t seed() const
+    { return d_seed; }
+
+    //! Get whether or not the generators are in reproducible mode.
+    bool reproducible() const
+    { return d_reproducible; }
+
   private:
 
-    // Random number generator.
-    Teuchos::RCP<RNG> d_rng;
+    // Key the generators on this process.
+    void keyStreams( const int comm_rank );
+
+  private:
+
+    // Seed.
+    std::size_t d_seed;
+
+    // Reproducible mode flag.
+    bool d_reproducible;
+
+    // Random number generators for each thread.
+    Teuchos::Array<Teuchos::RCP<RNG> > d_rngs;
+
+    // Stream ids for each thread.
+    Teuchos::Array<std::size_t> d_streams;
+
+    // Stream from which history substreams are drawn.
+    std::size_t d_history_stream;
+
+    // Solve for which history substreams are drawn.
+    std::size_t d_solve;
+
+    // Seed of the history substreams of the current solve.
+    std::size_t d_history_seed;
 };
 
 //---------------------------------------------------------------------------//
@@ -89,7 +178,58 @@ template<class RandomDistribution>
 inline typename RandomDistributionTraits<RandomDistribution>::result_type
 PRNG<RNG>::random( RandomDistribution& distribution )
 {
-    return RNGT::random( *d_rng, distribution );
+    MCLS_REQUIRE( ThreadTools::threadId() < d_rngs.size() );
+    return RNGT::random( *d_rngs[ThreadTools::threadId()], distribution );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get a uniform random number in [0,1) from the stream of the calling
+ * thread. No distribution object is used such that threads share no state.
+ */
+template<class RNG>
+inline double PRNG<RNG>::uniform()
+{
+    MCLS_REQUIRE( ThreadTools::threadId() < d_rngs.size() );
+    double value = 0.0;
+    RNGT::fill( *d_rngs[ThreadTools::threadId()], &value, 1 );
+    return value;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Fill an array with uniform random numbers in [0,1) from the stream
+ * of the calling thread. Numbers are generated in blocks without a
+ * distribution object.
+ */
+template<class RNG>
+inline void PRNG<RNG>::fill( double* values, const int num_values )
+{
+    MCLS_REQUIRE( ThreadTools::threadId() < d_rngs.size() );
+    RNGT::fill( *d_rngs[ThreadTools::threadId()], values, num_values );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Key the generator of the calling thread to a step of the substream
+ * of a history. The substream is keyed by the current solve and the
+ * source-assigned history id only and the step is reached at an offset of
+ * STEP_DRAWS random numbers per step. This does nothing if the generators
+ * are not in reproducible mode.
+ */
+template<class RNG>
+inline void PRNG<RNG>::beginStep( const std::size_t history_id, 
+				  const int step )
+{
+    MCLS_REQUIRE( step >= 0 );
+    if ( d_reproducible )
+    {
+	int thread_id = ThreadTools::threadId();
+	MCLS_REQUIRE( thread_id < d_rngs.size() );
+	RNGT::setStream( *d_rngs[thread_id], d_history_seed, d_history_stream,
+			 history_id + 1, 
+			 static_cast<std::size_t>(step) * STEP_DRAWS );
+    }
 }
 
 //---------------------------------------------------------------------------//
@@ -42,36 +42,79 @@
 #define MCLS_PRNG_IMPL_HPP
 
 #include <random>
-#include <limits>
 
 namespace MCLS
 {
 //---------------------------------------------------------------------------//
 /*!
- * \brief Constructor.
+ * \brief Non-reproducible constructor. The seed is drawn from a random
+ * device on each process.
  *
  * \param comm_rank Rank of the local process in the global parallel
  * communicator.
  */
 template<class RNG>
 PRNG<RNG>::PRNG( const int comm_rank )
+    : d_seed( std::random_device()() )
+    , d_reproducible( false )
 {
-    // Create a random device to get an initial random number. This is
-    // potentially non-deterministic.
-    std::random_device rand_device;
-
-    // Create a master rng to produce seed values for each parallel rank.
-    Teuchos::RCP<RNG> master_rng = RNGT::create( rand_device() );
-    typename IDT::result_type seed = 0;
-    Teuchos::RCP<IntDistribution> distribution =IDT::create(
-	0, std::numeric_limits<typename IDT::result_type>::max() );
-    for ( int i = -1; i < comm_rank; ++i )
+    keyStreams( comm_rank );
+    setSolve( 0 );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Reproducible constructor.
+ *
+ * \param comm_rank Rank of the local process in the global parallel
+ * communicator.
+ *
+ * \param seed Seed shared by all processes.
+ */
+template<class RNG>
+PRNG<RNG>::PRNG( const int comm_rank, const std::size_t seed )
+    : d_seed( seed )
+    , d_reproducible( true )
+{
+    keyStreams( comm_rank );
+    setSolve( 0 );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Key the generators on this process. Each thread gets the stream
+ * (global rank, thread) starting at substream 0. Histories are drawn from
+ * the stream of the global rank until a history stream is set.
+ */
+template<class RNG>
+void PRNG<RNG>::keyStreams( const int comm_rank )
+{
+    MCLS_REQUIRE( comm_rank >= 0 );
+
+    int num_threads = ThreadTools::maxThreads();
+    d_rngs.resize( num_threads );
+    d_streams.resize( num_threads );
+    d_history_stream = comm_rank;
+    for ( int t = 0; t < num_threads; ++t )
     {
-	seed = RNGT::random( *master_rng, *distribution );
+	d_streams[t] = comm_rank*num_threads + t;
+	d_rngs[t] = RNGT::create( d_seed );
+	RNGT::setStream( *d_rngs[t], d_seed, d_streams[t], 0 );
     }
- 
-   // Seed the random number generator on this process.
-    d_rng = RNGT::create( seed );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Set the solve for which history substreams are drawn. The history
+ * substreams of a solve are keyed by a seed hashed from the shared seed and
+ * the solve such that a history id gives an independent sequence in each
+ * solve. All processes in a set must set the same solve.
+ */
+template<class RNG>
+void PRNG<RNG>::setSolve( const std::size_t solve )
+{
+    d_solve = solve;
+    d_history_seed = streamSeed( d_seed, 0, d_solve );
 }
 
 //---------------------------------------------------------------------------//
@@ -0,0 +1,292 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2012, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the University of Wisconsin - Madison nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file MCLS_Philox.hpp
+ * \author Stuart R. Slattery
+ * \brief Philox counter-based random number generator.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef MCLS_PHILOX_HPP
+#define MCLS_PHILOX_HPP
+
+#include <random>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+
+#include "MCLS_RNGTraits.hpp"
+
+namespace MCLS
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class Philox
+ * \brief Philox4x32-10 counter-based random number generator.
+ *
+ * Random numbers are produced by encrypting a 128-bit counter with a 64-bit
+ * key (Salmon et al., SC11). The key is the seed and the counter holds the
+ * stream, the substream, and the block index within the substream. Any
+ * (seed, stream, substream) sequence can therefore be started in O(1)
+ * without advancing any other sequence. Each block produces two 64-bit
+ * random numbers and a substream holds 2^32 blocks.
+ */
+//---------------------------------------------------------------------------//
+class Philox
+{
+  public:
+
+    //@{
+    //! Typedefs.
+    typedef std::uniform_int_distribution<int> uniform_int_distribution_type;
+    typedef std::uniform_real_distribution<double> uniform_real_distribution_type;
+    typedef std::uint64_t result_type;
+    //@}
+
+    //! Constructor.
+    explicit Philox( const result_type seed )
+    { 
+	this->seed( seed ); 
+    }
+
+    //! Minimum value.
+    static constexpr result_type min()
+    { return std::numeric_limits<result_type>::min(); }
+
+    //! Maximum value.
+    static constexpr result_type max()
+    { return std::numeric_limits<result_type>::max(); }
+
+    //! Seed the engine. This resets the engine to stream 0, substream 0.
+    void seed( const result_type seed )
+    { 
+	d_key = seed;
+	setStream( 0, 0 );
+    }
+
+    //! Set the engine to a stream and substream. The offset is the number of
+    //! random numbers of the substream to skip and is reached in O(1).
+    void setStream( const std::uint32_t stream, 
+		    const result_type substream,
+		    const result_type offset = 0 )
+    {
+	d_stream = stream;
+	d_substream = substream;
+	d_block = static_cast<std::uint32_t>( offset / 2 );
+	d_index = 2;
+	if ( offset % 2 )
+	{
+	    generateBlock();
+	    d_index = 1;
+	}
+    }
+
+    // Get a random number.
+    inline result_type operator()();
+
+    // Fill an array with uniform random numbers in [0,1).
+    inline void fill( double* values, const int num_values );
+
+  private:
+
+    // Encrypt the current counter into the output block.
+    inline void generateBlock();
+
+  private:
+
+    // Key.
+    result_type d_key;
+
+    // Stream id.
+    std::uint32_t d_stream;
+
+    // Substream id.
+    result_type d_substream;
+
+    // Block index in the substream.
+    std::uint32_t d_block;
+
+    // Index of the next output in the current block.
+    int d_index;
+
+    // Current output block.
+    result_type d_output[2];
+};
+
+//---------------------------------------------------------------------------//
+// Inline functions.
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get a random number.
+ */
+inline Philox::result_type Philox::operator()()
+{
+    if ( 2 == d_index )
+    {
+	generateBlock();
+	d_index = 0;
+    }
+    return d_output[ d_index++ ];
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Fill an array with uniform random numbers in [0,1). The sequence is
+ * the same as that from successive calls to operator().
+ */
+inline void Philox::fill( double* values, const int num_values )
+{
+    const int block_size = 64;
+    result_type bits[block_size];
+    int num_block = 0;
+    for ( int block = 0; block < num_values; block += block_size )
+    {
+	num_block = std::min( block_size, num_values - block );
+	for ( int i = 0; i < num_block; ++i )
+	{
+	    bits[i] = (*this)();
+	}
+	bitsToDouble( bits, values + block, num_block );
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Encrypt the current counter into the output block with 10 Philox
+ * rounds and advance the counter.
+ */
+inline void Philox::generateBlock()
+{
+    const std::uint64_t m0 = 0xD2511F53;
+    const std::uint64_t m1 = 0xCD9E8D57;
+    const std::uint32_t w0 = 0x9E3779B9;
+    const std::uint32_t w1 = 0xBB67AE85;
+
+    std::uint32_t c0 = d_block;
+    std::uint32_t c1 = static_cast<std::uint32_t>( d_substream );
+    std::uint32_t c2 = static_cast<std::uint32_t>( d_substream >> 32 );
+    std::uint32_t c3 = d_stream;
+    std::uint32_t k0 = static_cast<std::uint32_t>( d_key );
+    std::uint32_t k1 = static_cast<std::uint32_t>( d_key >> 32 );
+
+    std::uint64_t p0 = 0;
+    std::uint64_t p1 = 0;
+    for ( int r = 0; r < 10; ++r )
+    {
+	if ( r > 0 )
+	{
+	    k0 += w0;
+	    k1 += w1;
+	}
+	p0 = m0 * c0;
+	p1 = m1 * c2;
+	c0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+	c2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+	c1 = static_cast<std::uint32_t>( p1 );
+	c3 = static_cast<std::uint32_t>( p0 );
+    }
+
+    d_output[0] = (static_cast<std::uint64_t>(c0) << 32) | c1;
+    d_output[1] = (static_cast<std::uint64_t>(c2) << 32) | c3;
+    ++d_block;
+}
+
+//---------------------------------------------------------------------------//
+// Specialization for RNGTraits.
+//---------------------------------------------------------------------------//
+template<>
+class RNGTraits<Philox>
+{
+  public:
+
+    //@{
+    //! Typedefs.
+    typedef Philox rng_type;
+    typedef rng_type::uniform_int_distribution_type uniform_int_distribution_type;
+    typedef rng_type::uniform_real_distribution_type uniform_real_distribution_type;
+    //@}
+
+    //! Create a random number generator from a seed.
+    static Teuchos::RCP<rng_type> create( const std::size_t seed )
+    {
+	return Teuchos::rcp( new rng_type(seed) );
+    }
+
+    //! Key a random number generator with a seed, stream, and substream.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream )
+    {
+	rng.seed( seed );
+	rng.setStream( stream, substream );
+    }
+
+    //! Key a random number generator with a seed, stream, and substream and
+    //! skip to an offset in the substream without generating the skipped
+    //! numbers.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream,
+			   const std::size_t offset )
+    {
+	rng.seed( seed );
+	rng.setStream( stream, substream, offset );
+    }
+
+    //! Fill an array with uniform random numbers in [0,1).
+    static void fill( rng_type& rng, double* values, const int num_values )
+    {
+	rng.fill( values, num_values );
+    }
+
+    //! Get a random number from a specified distribution.
+    template<class RandomDistribution>
+    static inline typename RandomDistributionTraits<RandomDistribution>::result_type
+    random( rng_type& rng, RandomDistribution& distribution )
+    {
+	return distribution( rng );
+    }
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace MCLS
+
+#endif // end MCLS_PHILOX_HPP
+
+//---------------------------------------------------------------------------//
+// end MCLS_Philox.hpp
+//---------------------------------------------------------------------------//
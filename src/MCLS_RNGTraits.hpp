@@ -39,6 +39,9 @@
 //---------------------------------------------------------------------------//
 
 #include <random>
+#include <limits>
+#include <cmath>
+#include <cstdint>
 
 #include <Teuchos_RCP.hpp>
 
@@ -130,6 +133,42 @@ class RNGTraits
 	return Teuchos::null;
     }
 
+    /*!
+     * \brief Key a random number generator such that it produces the
+     * independent sequence identified by a seed, stream, and substream.
+     */
+    static void setStream( RNG& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream )
+    {
+	UndefinedRNGTraits<RNG>::notDefined();
+    }
+
+    /*!
+     * \brief Key a random number generator such that it produces the
+     * sequence identified by a seed, stream, and substream starting at an
+     * offset counted in random numbers. Counter-based generators reach the
+     * offset of the substream directly. Other generators key an independent
+     * sequence for each offset.
+     */
+    static void setStream( RNG& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream,
+			   const std::size_t offset )
+    {
+	UndefinedRNGTraits<RNG>::notDefined();
+    }
+
+    /*!
+     * \brief Fill an array with uniform random numbers in [0,1).
+     */
+    static void fill( RNG& rng, double* values, const int num_values )
+    {
+	UndefinedRNGTraits<RNG>::notDefined();
+    }
+
     //! Get a random number from a specified distribution.
     template<class RandomDistribution>
     static inline typename RandomDistributionTraits<RandomDistribution>::result_type 
@@ -182,6 +221,75 @@ class RandomDistributionTraits<std::uniform_int_distribution<int> >
     }
 };
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Hash a seed, stream, and substream into a single seed value for
+ * generators that are not counter-based. Each value is mixed with the
+ * splitmix64 finalizer.
+ */
+inline std::uint64_t streamSeed( const std::uint64_t seed,
+				 const std::uint64_t stream,
+				 const std::uint64_t substream )
+{
+    std::uint64_t hash = seed;
+    std::uint64_t values[2] = { stream, substream };
+    for ( int i = 0; i < 3; ++i )
+    {
+	hash += 0x9E3779B97F4A7C15ULL;
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+	hash ^= (hash >> 31);
+	if ( i < 2 ) hash ^= values[i];
+    }
+    return hash;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Hash a seed, stream, substream, and offset into a single seed
+ * value. The offset is mixed into the seed of the substream.
+ */
+inline std::uint64_t streamSeed( const std::uint64_t seed,
+				 const std::uint64_t stream,
+				 const std::uint64_t substream,
+				 const std::uint64_t offset )
+{
+    return streamSeed( streamSeed(seed,stream,substream), offset, 0 );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Convert a block of random bits to uniform doubles in [0,1). The
+ * upper 53 bits of each value are scaled directly without a distribution
+ * object.
+ */
+template<class UInt>
+inline void bitsToDouble( const UInt* bits, double* values, const int num_values )
+{
+    const int digits = std::numeric_limits<UInt>::digits;
+    const int shift = (digits > 53) ? digits - 53 : 0;
+    const double scale = std::ldexp( 1.0, shift - digits );
+    for ( int i = 0; i < num_values; ++i )
+    {
+	values[i] = static_cast<double>( bits[i] >> shift ) * scale;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Fill an array with uniform doubles in [0,1) from a generic c++11
+ * random number engine.
+ */
+template<class RNG>
+inline void fillCanonical( RNG& rng, double* values, const int num_values )
+{
+    for ( int i = 0; i < num_values; ++i )
+    {
+	values[i] = std::generate_canonical<
+	    double,std::numeric_limits<double>::digits>( rng );
+    }
+}
+
 //---------------------------------------------------------------------------//
 // C++11 Specializations for RNGTraits.
 //---------------------------------------------------------------------------//
@@ -203,6 +311,32 @@ class RNGTraits<std::minstd_rand>
 	return Teuchos::rcp( new rng_type(seed) );
     }
 
+    //! Key a random number generator with a seed, stream, and substream.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream )
+    {
+	rng.seed( streamSeed(seed,stream,substream) );
+    }
+
+    //! Key a random number generator with a seed, stream, substream, and
+    //! offset.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream,
+			   const std::size_t offset )
+    {
+	rng.seed( streamSeed(seed,stream,substream,offset) );
+    }
+
+    //! Fill an array with uniform random numbers in [0,1).
+    static void fill( rng_type& rng, double* values, const int num_values )
+    {
+	fillCanonical( rng, values, num_values );
+    }
+
     //! Get a random number from a specified distribution.
     template<class RandomDistribution>
     static inline typename RandomDistributionTraits<RandomDistribution>::result_type
@@ -231,6 +365,32 @@ class RNGTraits<std::minstd_rand0>
 	return Teuchos::rcp( new rng_type(seed) );
     }
 
+    //! Key a random number generator with a seed, stream, and substream.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream )
+    {
+	rng.seed( streamSeed(seed,stream,substream) );
+    }
+
+    //! Key a random number generator with a seed, stream, substream, and
+    //! offset.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream,
+			   const std::size_t offset )
+    {
+	rng.seed( streamSeed(seed,stream,substream,offset) );
+    }
+
+    //! Fill an array with uniform random numbers in [0,1).
+    static void fill( rng_type& rng, double* values, const int num_values )
+    {
+	fillCanonical( rng, values, num_values );
+    }
+
     //! Get a random number from a specified distribution.
     template<class RandomDistribution>
     static inline typename RandomDistributionTraits<RandomDistribution>::result_type
@@ -259,6 +419,32 @@ class RNGTraits<std::mt19937>
 	return Teuchos::rcp( new rng_type(seed) );
     }
 
+    //! Key a random number generator with a seed, stream, and substream.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream )
+    {
+	rng.seed( streamSeed(seed,stream,substream) );
+    }
+
+    //! Key a random number generator with a seed, stream, substream, and
+    //! offset.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream,
+			   const std::size_t offset )
+    {
+	rng.seed( streamSeed(seed,stream,substream,offset) );
+    }
+
+    //! Fill an array with uniform random numbers in [0,1).
+    static void fill( rng_type& rng, double* values, const int num_values )
+    {
+	fillCanonical( rng, values, num_values );
+    }
+
     //! Get a random number from a specified distribution.
     template<class RandomDistribution>
     static inline typename RandomDistributionTraits<RandomDistribution>::result_type
@@ -287,6 +473,32 @@ class RNGTraits<std::mt19937_64>
 	return Teuchos::rcp( new rng_type(seed) );
     }
 
+    //! Key a random number generator with a seed, stream, and substream.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream )
+    {
+	rng.seed( streamSeed(seed,stream,substream) );
+    }
+
+    //! Key a random number generator with a seed, stream, substream, and
+    //! offset.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream,
+			   const std::size_t offset )
+    {
+	rng.seed( streamSeed(seed,stream,substream,offset) );
+    }
+
+    //! Fill an array with uniform random numbers in [0,1).
+    static void fill( rng_type& rng, double* values, const int num_values )
+    {
+	fillCanonical( rng, values, num_values );
+    }
+
     //! Get a random number from a specified distribution.
     template<class RandomDistribution>
     static inline typename RandomDistributionTraits<RandomDistribution>::result_type
@@ -315,6 +527,32 @@ class RNGTraits<std::ranlux24_base>
 	return Teuchos::rcp( new rng_type(seed) );
     }
 
+    //! Key a random number generator with a seed, stream, and substream.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream )
+    {
+	rng.seed( streamSeed(seed,stream,substream) );
+    }
+
+    //! Key a random number generator with a seed, stream, substream, and
+    //! offset.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream,
+			   const std::size_t offset )
+    {
+	rng.seed( streamSeed(seed,stream,substream,offset) );
+    }
+
+    //! Fill an array with uniform random numbers in [0,1).
+    static void fill( rng_type& rng, double* values, const int num_values )
+    {
+	fillCanonical( rng, values, num_values );
+    }
+
     //! Get a random number from a specified distribution.
     template<class RandomDistribution>
     static inline typename RandomDistributionTraits<RandomDistribution>::result_type
@@ -343,6 +581,32 @@ class RNGTraits<std::ranlux48_base>
 	return Teuchos::rcp( new rng_type(seed) );
     }
 
+    //! Key a random number generator with a seed, stream, and substream.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream )
+    {
+	rng.seed( streamSeed(seed,stream,substream) );
+    }
+
+    //! Key a random number generator with a seed, stream, substream, and
+    //! offset.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream,
+			   const std::size_t offset )
+    {
+	rng.seed( streamSeed(seed,stream,substream,offset) );
+    }
+
+    //! Fill an array with uniform random numbers in [0,1).
+    static void fill( rng_type& rng, double* values, const int num_values )
+    {
+	fillCanonical( rng, values, num_values );
+    }
+
     //! Get a random number from a specified distribution.
     template<class RandomDistribution>
     static inline typename RandomDistributionTraits<RandomDistribution>::result_type 
@@ -371,6 +635,32 @@ class RNGTraits<std::ranlux24>
 	return Teuchos::rcp( new rng_type(seed) );
     }
 
+    //! Key a random number generator with a seed, stream, and substream.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream )
+    {
+	rng.seed( streamSeed(seed,stream,substream) );
+    }
+
+    //! Key a random number generator with a seed, stream, substream, and
+    //! offset.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream,
+			   const std::size_t offset )
+    {
+	rng.seed( streamSeed(seed,stream,substream,offset) );
+    }
+
+    //! Fill an array with uniform random numbers in [0,1).
+    static void fill( rng_type& rng, double* values, const int num_values )
+    {
+	fillCanonical( rng, values, num_values );
+    }
+
     //! Get a random number from a specified distribution.
     template<class RandomDistribution>
     static inline typename RandomDistributionTraits<RandomDistribution>::result_type
@@ -399,6 +689,32 @@ class RNGTraits<std::ranlux48>
 	return Teuchos::rcp( new rng_type(seed) );
     }
 
+    //! Key a random number generator with a seed, stream, and substream.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream )
+    {
+	rng.seed( streamSeed(seed,stream,substream) );
+    }
+
+    //! Key a random number generator with a seed, stream, substream, and
+    //! offset.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream,
+			   const std::size_t offset )
+    {
+	rng.seed( streamSeed(seed,stream,substream,offset) );
+    }
+
+    //! Fill an array with uniform random numbers in [0,1).
+    static void fill( rng_type& rng, double* values, const int num_values )
+    {
+	fillCanonical( rng, values, num_values );
+    }
+
     //! Get a random number from a specified distribution.
     template<class RandomDistribution>
     static inline typename RandomDistributionTraits<RandomDistribution>::result_type
@@ -428,6 +744,32 @@ class RNGTraits<std::knuth_b>
 	return Teuchos::rcp( new rng_type(seed) );
     }
 
+    //! Key a random number generator with a seed, stream, and substream.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream )
+    {
+	rng.seed( streamSeed(seed,stream,substream) );
+    }
+
+    //! Key a random number generator with a seed, stream, substream, and
+    //! offset.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream,
+			   const std::size_t offset )
+    {
+	rng.seed( streamSeed(seed,stream,substream,offset) );
+    }
+
+    //! Fill an array with uniform random numbers in [0,1).
+    static void fill( rng_type& rng, double* values, const int num_values )
+    {
+	fillCanonical( rng, values, num_values );
+    }
+
     //! Get a random number from a specified distribution.
     template<class RandomDistribution>
     static inline typename RandomDistributionTraits<RandomDistribution>::result_type
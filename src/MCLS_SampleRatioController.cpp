@@ -0,0 +1,120 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2012, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the University of Wisconsin - Madison nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file MCLS_SampleRatioController.cpp
+ * \author Stuart R. Slattery
+ * \brief Adaptive sample ratio controller implementation.
+ */
+//---------------------------------------------------------------------------//
+
+#include <algorithm>
+#include <cmath>
+
+#include "MCLS_SampleRatioController.hpp"
+#include "MCLS_DBC.hpp"
+
+namespace MCLS
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Constructor.
+ */
+SampleRatioController::SampleRatioController( const double initial_ratio,
+					      const double min_ratio,
+					      const double max_ratio,
+					      const double factor,
+					      const double initial_residual )
+    : d_ratio( initial_ratio )
+    , d_min_ratio( min_ratio )
+    , d_max_ratio( max_ratio )
+    , d_factor( factor )
+    , d_residual( initial_residual )
+    , d_efficiency( 0.0 )
+    , d_has_efficiency( false )
+    , d_direction( -1 )
+    , d_trace( 1, initial_ratio )
+{
+    MCLS_REQUIRE( min_ratio > 0.0 );
+    MCLS_REQUIRE( min_ratio <= initial_ratio );
+    MCLS_REQUIRE( initial_ratio <= max_ratio );
+    MCLS_REQUIRE( factor > 1.0 );
+    MCLS_REQUIRE( initial_residual >= 0.0 );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Observe the residual norm after an interval of iterations and the
+ * wall time of the interval. Return the sample ratio for the next
+ * interval. The arguments must be the same on all processes for the ratio to
+ * be consistent.
+ */
+double SampleRatioController::update( const double residual_norm, 
+				      const double elapsed_time )
+{
+    MCLS_REQUIRE( residual_norm >= 0.0 );
+    MCLS_REQUIRE( elapsed_time >= 0.0 );
+
+    // Without a residual to reduce or a measurable interval the ratio is
+    // kept.
+    if ( residual_norm > 0.0 && d_residual > 0.0 && elapsed_time > 0.0 )
+    {
+	double efficiency = std::log( d_residual / residual_norm ) / elapsed_time;
+
+	// Reverse direction if the last step made the solve less efficient.
+	if ( d_has_efficiency && efficiency < d_efficiency )
+	{
+	    d_direction = -d_direction;
+	}
+	d_efficiency = efficiency;
+	d_has_efficiency = true;
+
+	// Step the ratio.
+	d_ratio = ( d_direction > 0 ) ? d_ratio * d_factor : d_ratio / d_factor;
+	d_ratio = std::max( d_min_ratio, std::min(d_max_ratio, d_ratio) );
+    }
+    d_residual = residual_norm;
+
+    d_trace.push_back( d_ratio );
+    MCLS_ENSURE( d_ratio >= d_min_ratio && d_ratio <= d_max_ratio );
+    return d_ratio;
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace MCLS
+
+//---------------------------------------------------------------------------//
+// end MCLS_SampleRatioController.cpp
+// ---------------------------------------------------------------------------//
+
@@ -0,0 +1,123 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2012, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the University of Wisconsin - Madison nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file MCLS_SampleRatioController.hpp
+ * \author Stuart R. Slattery
+ * \brief Adaptive sample ratio controller declaration.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef MCLS_SAMPLERATIOCONTROLLER_HPP
+#define MCLS_SAMPLERATIOCONTROLLER_HPP
+
+#include <Teuchos_Array.hpp>
+
+namespace MCLS
+{
+
+//---------------------------------------------------------------------------//
+/*!
+ * \class SampleRatioController
+ * \brief Adapt the Monte Carlo sample ratio over the iterations of a solve.
+ *
+ * The efficiency of an interval of iterations is measured as the log
+ * reduction of the residual norm per unit wall time. After each observation
+ * the sample ratio is multiplied or divided by a constant factor. The
+ * direction is kept while the efficiency improves and reversed when it
+ * drops, such that the ratio is driven towards the minimum wall time to
+ * tolerance. The first step reduces the ratio as the smoother dominates the
+ * early iterations. The ratio is bounded from below and above.
+ */
+class SampleRatioController
+{
+  public:
+
+    // Constructor.
+    SampleRatioController( const double initial_ratio,
+			   const double min_ratio,
+			   const double max_ratio,
+			   const double factor,
+			   const double initial_residual );
+
+    // Observe the residual norm after an interval of iterations and the wall
+    // time of the interval. Return the sample ratio for the next interval.
+    double update( const double residual_norm, const double elapsed_time );
+
+    //! Get the current sample ratio.
+    double sampleRatio() const { return d_ratio; }
+
+    //! Get the sample ratios chosen over the solve in order, starting with
+    //! the initial ratio.
+    const Teuchos::Array<double>& trace() const { return d_trace; }
+
+  private:
+
+    // Current sample ratio.
+    double d_ratio;
+
+    // Minimum sample ratio.
+    double d_min_ratio;
+
+    // Maximum sample ratio.
+    double d_max_ratio;
+
+    // Multiplicative step factor.
+    double d_factor;
+
+    // Residual norm at the last observation.
+    double d_residual;
+
+    // Efficiency of the last interval.
+    double d_efficiency;
+
+    // Boolean for a previous efficiency measurement.
+    bool d_has_efficiency;
+
+    // Step direction. Positive to increase the ratio.
+    int d_direction;
+
+    // Sample ratio trace.
+    Teuchos::Array<double> d_trace;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace MCLS
+
+#endif // end MCLS_SAMPLERATIOCONTROLLER_HPP
+
+//---------------------------------------------------------------------------//
+// end MCLS_SampleRatioController.hpp
+// ---------------------------------------------------------------------------//
+
@@ -46,6 +46,7 @@
 
 #include "MCLS_DBC.hpp"
 
+#include <Teuchos_Array.hpp>
 #include <Teuchos_ArrayView.hpp>
 
 namespace MCLS
@@ -78,6 +79,104 @@ class SamplingTools
 	
 	return std::lower_bound( cdf, cdf+size, random ) - cdf;
     }
+
+    /*
+     * \brief Given a discrete PDF, build a Walker/Vose alias table for
+     * sampling it in constant time. The PDF need not be normalized.
+     */
+    template<class T>
+    static inline void
+    buildAliasTable( const T* pdf,
+		     const int size,
+		     T* probabilities,
+		     int* aliases )
+    {
+	MCLS_REQUIRE( size > 0 );
+
+	// Scale the PDF such that the average bin probability is 1.
+	T sum = 0.0;
+	for ( int i = 0; i < size; ++i )
+	{
+	    MCLS_REQUIRE( pdf[i] >= 0.0 );
+	    sum += pdf[i];
+	}
+	MCLS_CHECK( sum > 0.0 );
+
+	// Sort the bins into those under and over the average.
+	Teuchos::Array<int> small;
+	Teuchos::Array<int> large;
+	small.reserve( size );
+	large.reserve( size );
+	for ( int i = 0; i < size; ++i )
+	{
+	    probabilities[i] = pdf[i] * size / sum;
+	    aliases[i] = i;
+	    if ( probabilities[i] < 1.0 )
+	    {
+		small.push_back( i );
+	    }
+	    else
+	    {
+		large.push_back( i );
+	    }
+	}
+
+	// Fill each small bin with the excess of a large bin.
+	int s = 0;
+	int l = 0;
+	while ( !small.empty() && !large.empty() )
+	{
+	    s = small.back();
+	    small.pop_back();
+	    l = large.back();
+	    large.pop_back();
+
+	    aliases[s] = l;
+	    probabilities[l] = (probabilities[l] + probabilities[s]) - 1.0;
+
+	    if ( probabilities[l] < 1.0 )
+	    {
+		small.push_back( l );
+	    }
+	    else
+	    {
+		large.push_back( l );
+	    }
+	}
+
+	// Any bins left over are full up to round-off.
+	for ( int i = 0; i < large.size(); ++i )
+	{
+	    probabilities[ large[i] ] = 1.0;
+	}
+	for ( int i = 0; i < small.size(); ++i )
+	{
+	    probabilities[ small[i] ] = 1.0;
+	}
+    }
+
+    /*
+     * \brief Given an alias table and random number, sample it to get the
+     * output state.
+     */
+    template<class T>
+    static inline int
+    sampleAliasTable( const T* probabilities,
+		      const int* aliases,
+		      const int size,
+		      const T& random )
+    {
+	MCLS_REQUIRE( size > 0 );
+	MCLS_REQUIRE( random >= 0.0 && random <= 1.0 );
+
+	// Use the integer part of the scaled random number to select a bin
+	// and the fractional part to select between the bin and its alias.
+	T scaled = random * size;
+	int bin = std::min( static_cast<int>(scaled), size-1 );
+	MCLS_CHECK( bin >= 0 && bin < size );
+
+	return ( scaled - bin < probabilities[bin] ) ? bin : aliases[bin];
+    }
 };
 
 //---------------------------------------------------------------------------//
@@ -42,6 +42,7 @@
 #define MCLS_SERIALIZER_HPP
 
 #include <cstring>
+#include <type_traits>
 
 #include "MCLS_DBC.hpp"
 
@@ -123,6 +124,8 @@ class Serializer
 	    MCLS_REQUIRE( d_ptr >= d_begin);
 	    MCLS_REQUIRE( d_ptr + sizeof(T) <= d_end );
 	
+	    static_assert( std::is_trivially_copyable<T>::value,
+			   "Serialized types must be trivially copyable" );
 	    std::memcpy( d_ptr, &data, sizeof(T) );
 	
 	    d_ptr += sizeof(T);
@@ -233,6 +236,8 @@ class Deserializer
 	MCLS_REQUIRE( d_ptr >= d_begin);
 	MCLS_REQUIRE( d_ptr + sizeof(T) <= d_end );
 	
+	static_assert( std::is_trivially_copyable<T>::value,
+		       "Deserialized types must be trivially copyable" );
 	std::memcpy( &data, d_ptr, sizeof(T) );
 	
 	d_ptr += sizeof(T);
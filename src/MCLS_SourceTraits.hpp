@@ -116,6 +116,16 @@ class SourceTraits
 	return 0.0;
     }
 
+    /*!
+     * \brief Get the magnitude of the starting weight of the source
+     * histories.
+     */
+    static double sourceWeight( const Source& source )
+    { 
+	UndefinedSourceTraits<Source>::notDefined(); 
+	return 0.0;
+    }
+
     /*!
      * \brief Get a history from the source.
      */
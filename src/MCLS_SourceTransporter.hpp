@@ -51,6 +51,8 @@
 #include <Teuchos_Comm.hpp>
 #include <Teuchos_ParameterList.hpp>
 #include <Teuchos_ArrayRCP.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_Time.hpp>
 
 namespace MCLS
 {
@@ -64,6 +66,18 @@ namespace MCLS
  * all subsequent histories through the global domain until completion. All
  * communication operations occur within a set. Multiple set problems will
  * create multiple instances of this class.
+ *
+ * Local transport is done in cycles. In each cycle the worker threads pull
+ * histories from the source and the bank, a batch of "History Batch Size"
+ * histories at a time, and transport them through the local domain with
+ * their own random number streams and tally buffers. All communication is
+ * done by the master thread between cycles.
+ *
+ * Termination is detected by reducing the number of completed histories up
+ * a tree of width "MC Termination Tree Width" (2 by default) rooted at the
+ * master. All reports are non-blocking. A process with a report still in
+ * flight accumulates its count until that report completes. The time each
+ * process spends out of work waiting for completion is recorded.
  */
 //---------------------------------------------------------------------------//
 template<class Source>
@@ -101,31 +115,75 @@ class SourceTransporter : public GlobalTransporter<Source>
     // Reset the state of the transporter.
     void reset();
 
+    //! Get the number of histories completed on this process in the last
+    //! transport.
+    long numCompletedHistories() const
+    { return d_domain_transporter.numCompletedHistories(); }
+
+    //! Get the total number of steps of the histories completed on this
+    //! process in the last transport.
+    long numCompletedSteps() const
+    { return d_domain_transporter.numCompletedSteps(); }
+
+    //! Get the time in seconds this process spent out of work waiting for
+    //! completion in the last transport.
+    double completionWaitTime() const
+    { return d_completion_wait_time; }
+
+    //! Get the current history buffer size of each send neighbor of this
+    //! process.
+    Teuchos::Array<int> sendBufferSizes() const
+    { return d_domain_communicator.bufferSizes(); }
+
+    //! Get the parent of this process in the termination tree.
+    int parent() const
+    { return d_parent; }
+
+    //! Get the children of this process in the termination tree.
+    const Teuchos::Array<int>& children() const
+    { return d_children; }
+
+    // Get the parent of a rank in a termination tree of a given width.
+    static int treeParent( const int rank, const int tree_width );
+
+    // Get the children of a rank in a termination tree of a given width over
+    // a communicator of a given size.
+    static Teuchos::Array<int> treeChildren( const int rank, 
+					     const int comm_size,
+					     const int tree_width );
+
   private:
 
-    // Transport a source history.
-    void transportSourceHistory( BankType& bank );
+    // Transport a cycle of source and bank histories through the local
+    // domain with the worker threads.
+    int transportLocalHistories( BankType& bank );
 
-    // Transport a bank history.
-    void transportBankHistory( BankType& bank );
+    // Pull source and bank histories into a batch.
+    void pullHistories( BankType& bank, 
+			Teuchos::Array<HistoryType>& batch,
+			const int max_histories );
 
-    // Transport a history through the local domain.
-    template<class T>
-    void localHistoryTransport( T&& history );
+    // Transport a batch of histories through the local domain on the
+    // calling thread.
+    int transportBatch( Teuchos::Array<HistoryType>& batch,
+			Teuchos::Array<HistoryType>& outgoing );
 
     // Process incoming messages.
     void processMessages( BankType& bank );
 
-    // Post communications in the binary tree.
+    // Post communications in the termination tree.
     void postTreeCount();
 
-    // Complete outstanding communications in the binary tree at the end of a
-    // cycle.
+    // Complete outstanding communications in the termination tree at the end
+    // of a cycle.
     void completeTreeCount();
 
-    // Update the binary tree count of completed histories.
+    // Update the termination tree count of completed histories.
     void updateTreeCount();
 
+    // Report the number of completed histories to the parent.
+    void reportToParent();
+
     // Send the global finished message to the children.
     void sendCompleteToChildren();
 
@@ -146,7 +204,7 @@ class SourceTransporter : public GlobalTransporter<Source>
     int d_parent;
 
     // Child processes.
-    std::pair<int,int> d_children;
+    Teuchos::Array<int> d_children;
 
     // Local domain.
     Teuchos::RCP<Domain> d_domain;
@@ -160,12 +218,19 @@ class SourceTransporter : public GlobalTransporter<Source>
     // Source.
     Teuchos::RCP<Source> d_source;
 
-    // Master-worker asynchronous communication request handles for number of
-    // histories complete.
-    std::pair<Teuchos::RCP<Request>,Teuchos::RCP<Request> > d_num_done_handles;
+    // Asynchronous communication request handles for number of histories
+    // complete from each child.
+    Teuchos::Array<Teuchos::RCP<Request> > d_num_done_handles;
+
+    // Reports for number of histories complete from each child.
+    Teuchos::Array<Teuchos::ArrayRCP<int> > d_num_done_report;
+
+    // Request handle for the number of histories complete sent to the
+    // parent.
+    Teuchos::RCP<Request> d_report_handle;
 
-    // Master-worker reports for number of histories complete communications. 
-    std::pair<Teuchos::ArrayRCP<int>,Teuchos::ArrayRCP<int> > d_num_done_report;
+    // Number of histories complete sent to the parent.
+    Teuchos::ArrayRCP<int> d_report;
 
     // Request handle for completed work on worker nodes.
     Teuchos::RCP<Request> d_complete_handle;
@@ -173,6 +238,9 @@ class SourceTransporter : public GlobalTransporter<Source>
     // Completion report.
     Teuchos::ArrayRCP<int> d_complete_report;
 
+    // Request handles for the completion message sent to each child.
+    Teuchos::Array<Teuchos::RCP<Request> > d_complete_handles;
+
     // Total number of source histories in set.
     int d_nh;
 
@@ -188,11 +256,31 @@ class SourceTransporter : public GlobalTransporter<Source>
     // Check frequency for history buffer communication.
     int d_check_freq;
 
+    // Number of histories transported together as a batch.
+    int d_batch_size;
+
+    // History batch of each worker thread.
+    Teuchos::Array<Teuchos::Array<HistoryType> > d_thread_batches;
+
+    // Histories that left the local domain on each worker thread in the
+    // current cycle.
+    Teuchos::Array<Teuchos::Array<HistoryType> > d_thread_outgoing;
+
+    // Number of histories completed on each worker thread in the current
+    // cycle.
+    Teuchos::Array<int> d_thread_num_done;
+
     // Completed histories tag.
     int d_num_done_tag;
 
     // Completion status tag.
     int d_completion_status_tag;
+
+    // Timer for the time spent out of work waiting for completion.
+    Teuchos::RCP<Teuchos::Time> d_completion_timer;
+
+    // Time spent out of work waiting for completion in the last transport.
+    double d_completion_wait_time;
 };
 
 //---------------------------------------------------------------------------//
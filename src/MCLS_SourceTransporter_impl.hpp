@@ -41,14 +41,22 @@
 #ifndef MCLS_SOURCETRANSPORTER_IMPL_HPP
 #define MCLS_SOURCETRANSPORTER_IMPL_HPP
 
+#include <algorithm>
+
+#include "MCLS_config.hpp"
 #include "MCLS_DBC.hpp"
 #include "MCLS_CommTools.hpp"
 #include "MCLS_Events.hpp"
+#include "MCLS_ThreadTools.hpp"
 
 #include <Teuchos_CommHelpers.hpp>
 #include <Teuchos_Ptr.hpp>
 #include <Teuchos_OrdinalTraits.hpp>
 
+#if HAVE_MCLS_TIMERS
+#include <Teuchos_TimeMonitor.hpp>
+#endif
+
 namespace MCLS
 {
 //---------------------------------------------------------------------------//
@@ -62,17 +70,23 @@ SourceTransporter<Source>::SourceTransporter(
     const Teuchos::ParameterList& plist )
     : d_comm( comm )
     , d_parent( Teuchos::OrdinalTraits<int>::invalid() )
-    , d_children( Teuchos::OrdinalTraits<int>::invalid(),
-                  Teuchos::OrdinalTraits<int>::invalid() )
     , d_domain( domain )
     , d_domain_transporter( d_domain )
     , d_domain_communicator( d_domain, d_comm, plist )
-    , d_num_done_report( Teuchos::ArrayRCP<int>(1,0), Teuchos::ArrayRCP<int>(1,0) )
+    , d_report( Teuchos::ArrayRCP<int>(1,0) )
     , d_complete_report( Teuchos::ArrayRCP<int>(1,0) )
     , d_num_done( Teuchos::ArrayRCP<int>(1,0) )
     , d_complete( Teuchos::ArrayRCP<int>(1,0) )
     , d_num_done_tag( 19873 )
     , d_completion_status_tag( 19874 )
+#if HAVE_MCLS_TIMERS
+    , d_completion_timer( 
+	Teuchos::TimeMonitor::getNewCounter("MCLS: MC Completion Wait") )
+#else
+    , d_completion_timer( 
+	Teuchos::rcp(new Teuchos::Time("MCLS: MC Completion Wait")) )
+#endif
+    , d_completion_wait_time( 0.0 )
 {
     MCLS_REQUIRE( Teuchos::nonnull(d_comm) );
     MCLS_REQUIRE( Teuchos::nonnull(d_domain) );
@@ -81,31 +95,24 @@ SourceTransporter<Source>::SourceTransporter(
     int my_rank = d_comm->getRank();
     int my_size = d_comm->getSize();
 
-    // Get the parent process. MASTER has no parent.
-    if ( my_rank != MASTER )
+    // Get the width of the termination tree. Default to a binary tree.
+    int tree_width = 2;
+    if ( plist.isParameter("MC Termination Tree Width") )
     {
-	if ( my_rank % 2 == 0 )
-	{
-	    d_parent = ( my_rank / 2 ) - 1;
-	}
-	else
-	{
-	    d_parent = ( my_rank - 1 ) / 2;
-	}
+	tree_width = plist.get<int>("MC Termination Tree Width");
     }
-	 
-    // Get the first child process.
-    int child_1 = ( my_rank * 2 ) + 1;
-    if ( child_1 < my_size )
+    MCLS_INSIST( tree_width > 0, 
+		 "MC Termination Tree Width must be positive" );
+
+    // Get the parent and child processes.
+    d_parent = treeParent( my_rank, tree_width );
+    d_children = treeChildren( my_rank, my_size, tree_width );
+    d_num_done_handles.resize( d_children.size() );
+    d_num_done_report.resize( d_children.size() );
+    d_complete_handles.resize( d_children.size() );
+    for ( int c = 0; c < d_children.size(); ++c )
     {
-	d_children.first = child_1;
-    }
-
-    // Get the second child process.
-    int child_2 = child_1 + 1;
-    if ( child_2 < my_size )
-    {
-	d_children.second = child_2;
+	d_num_done_report[c] = Teuchos::ArrayRCP<int>(1,0);
     }
 
     // Set the check frequency. For every d_check_freq histories run, we will
@@ -115,12 +122,72 @@ SourceTransporter<Source>::SourceTransporter(
     {
 	d_check_freq = plist.get<int>("MC Check Frequency");
     }
+
+    // Set the number of histories to transport together. Default to 1.
+    d_batch_size = 1;
+    if ( plist.isParameter("History Batch Size") )
+    {
+	d_batch_size = plist.get<int>("History Batch Size");
+    }
+
+    // Create the worker thread batches.
+    int num_threads = ThreadTools::maxThreads();
+    d_thread_batches.resize( num_threads );
+    d_thread_outgoing.resize( num_threads );
+    d_thread_num_done.resize( num_threads, 0 );
+    for ( int t = 0; t < num_threads; ++t )
+    {
+	d_thread_batches[t].reserve( d_batch_size );
+    }
     
     MCLS_ENSURE( d_check_freq > 0 );
+    MCLS_ENSURE( d_batch_size > 0 );
     MCLS_ENSURE( Teuchos::nonnull(d_comm) );
     MCLS_ENSURE( Teuchos::nonnull(d_comm) );
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the parent of a rank in a termination tree of a given width.
+ * MASTER has no parent.
+ */
+template<class Source>
+int SourceTransporter<Source>::treeParent( const int rank, 
+					   const int tree_width )
+{
+    MCLS_REQUIRE( rank >= 0 );
+    MCLS_REQUIRE( tree_width > 0 );
+    return ( rank != MASTER ) ? ( rank - 1 ) / tree_width 
+			      : Teuchos::OrdinalTraits<int>::invalid();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the children of a rank in a termination tree of a given width
+ * over a communicator of a given size.
+ */
+template<class Source>
+Teuchos::Array<int> 
+SourceTransporter<Source>::treeChildren( const int rank, 
+					 const int comm_size,
+					 const int tree_width )
+{
+    MCLS_REQUIRE( rank >= 0 );
+    MCLS_REQUIRE( rank < comm_size );
+    MCLS_REQUIRE( tree_width > 0 );
+
+    Teuchos::Array<int> children;
+    for ( int c = 1; c <= tree_width; ++c )
+    {
+	int child = rank*tree_width + c;
+	if ( child < comm_size )
+	{
+	    children.push_back( child );
+	}
+    }
+    return children;
+}
+
 //---------------------------------------------------------------------------//
 /*!
 * \brief Assign the source.
@@ -151,6 +218,7 @@ void SourceTransporter<Source>::transport()
     d_complete[0] = 0;
     d_num_done[0] = 0;
     d_num_run = 0;
+    double start_wait_time = d_completion_timer->totalElapsedTime();
 
     // Get the number of histories in the set from the source.
     d_nh = ST::numToTransportInSet( *d_source );
@@ -162,47 +230,44 @@ void SourceTransporter<Source>::transport()
     // Everyone posts receives for history buffers to get started.
     d_domain_communicator.post();
 
-    // Post asynchronous communcations in the binary tree for history counts.
+    // Post asynchronous communcations in the tree for history counts.
     postTreeCount();
 
     // Transport all histories through the global domain until completion.
     while ( !d_complete[0] )
     {
-	// Transport the source histories.
-	if ( !ST::empty(*d_source) )
-	{
-	    transportSourceHistory( bank );
-	    ++d_num_run;
-	}
-
-	// If the source is empty, transport the bank histories.
-	else if ( !bank.empty() )
+	// Transport a cycle of source and bank histories.
+	if ( !ST::empty(*d_source) || !bank.empty() )
 	{
-	    transportBankHistory( bank );
-	    ++d_num_run;
+	    d_num_run += transportLocalHistories( bank );
 	}
 
 	// If we're out of source and bank histories or have hit the check
 	// frequency, process incoming messages.
 	if ( (ST::empty(*d_source) && bank.empty()) ||  
-             d_num_run == d_check_freq )
+             d_num_run >= d_check_freq )
 	{
             processMessages( bank );
 	    d_num_run = 0;
 	}
 
 	// If everything looks like it is finished locally, report through
-        // the tree to check if transport is done.
+        // the tree to check if transport is done. Time spent here is spent
+        // waiting for completion.
         if ( ST::empty(*d_source) && bank.empty() )
 	{
+	    d_completion_timer->start();
 	    controlTermination();
+	    d_completion_timer->stop();
 	}
     }
+    d_completion_wait_time = 
+	d_completion_timer->totalElapsedTime() - start_wait_time;
 
     // Barrier before continuing.
     d_comm->barrier();
 
-    // Complete the binary tree outstanding communication.
+    // Complete the tree outstanding communication.
     completeTreeCount();
 
     // End all communication and free all buffers.
@@ -220,80 +285,173 @@ void SourceTransporter<Source>::transport()
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Reset the state of the transporter.
+ * \brief Reset the state of the transporter. The domain tally is rebound
+ * such that a domain with refilled values may be transported again.
  */
 template<class Source>
 void SourceTransporter<Source>::reset()
 {
-    d_num_done_report = std::make_pair( Teuchos::ArrayRCP<int>(1,0),
-					Teuchos::ArrayRCP<int>(1,0) );
+    for ( int c = 0; c < d_children.size(); ++c )
+    {
+	d_num_done_report[c] = Teuchos::ArrayRCP<int>(1,0);
+    }
+    d_report = Teuchos::ArrayRCP<int>(1,0);
     d_complete_report = Teuchos::ArrayRCP<int>(1,0);
     d_num_done = Teuchos::ArrayRCP<int>(1,0);
     d_complete = Teuchos::ArrayRCP<int>(1,0);
+    d_domain_transporter.resetStatistics();
+    d_domain_transporter.updateTally();
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Transport a source history.
+ * \brief Transport a cycle of source and bank histories through the local
+ * domain and return the number of histories transported.
+ *
+ * Each worker thread repeatedly pulls a batch of histories from the source,
+ * and from the bank once the source is empty, and transports it on its own
+ * random number stream and tally buffer until the stacks are empty or the
+ * cycle is full. The source and the bank are only accessed inside a critical
+ * section. A cycle holds at least "MC Check Frequency" histories and enough
+ * histories for a batch on every thread. The master thread communicates the
+ * histories that left the local domain and counts those that finished in
+ * thread order after the cycle.
  */
 template<class Source>
-void SourceTransporter<Source>::transportSourceHistory( BankType& bank )
+int SourceTransporter<Source>::transportLocalHistories( BankType& bank )
 {
-    MCLS_REQUIRE( Teuchos::nonnull(d_source) );
-    MCLS_REQUIRE( !ST::empty(*d_source) );
+    MCLS_REQUIRE( !ST::empty(*d_source) || !bank.empty() );
+
+    int num_threads = d_thread_batches.size();
+    int cycle_size = std::max( d_check_freq, num_threads*d_batch_size );
+    int num_pulled = 0;
+
+#if HAVE_MCLS_OPENMP
+#pragma omp parallel num_threads(num_threads)
+#endif
+    {
+	int thread_id = ThreadTools::threadId();
+	Teuchos::Array<HistoryType>& batch = d_thread_batches[thread_id];
+	Teuchos::Array<HistoryType>& outgoing = d_thread_outgoing[thread_id];
+
+	do
+	{
+	    // Pull a batch of histories from the source and the bank.
+	    batch.clear();
+#if HAVE_MCLS_OPENMP
+#pragma omp critical(MCLS_SourceTransporter_pull)
+#endif
+	    {
+		pullHistories( bank, batch, 
+			       std::min(d_batch_size,cycle_size-num_pulled) );
+		num_pulled += batch.size();
+	    }
+
+	    // Transport the batch.
+	    if ( !batch.empty() )
+	    {
+		d_thread_num_done[thread_id] += 
+		    transportBatch( batch, outgoing );
+	    }
+	} while ( !batch.empty() );
+    }
+
+    // Communicate the histories that left the local domain and count those
+    // that finished all of their steps.
+    for ( int t = 0; t < num_threads; ++t )
+    {
+	typename Teuchos::Array<HistoryType>::iterator history_it;
+	for ( history_it = d_thread_outgoing[t].begin(); 
+	      history_it != d_thread_outgoing[t].end(); 
+	      ++history_it )
+	{
+	    d_domain_communicator.communicate( *history_it );
+	}
+	d_thread_outgoing[t].clear();
+	d_num_done[0] += d_thread_num_done[t];
+	d_thread_num_done[t] = 0;
+    }
 
-    // Transport a source history through the local domain and communicate it if
-    // needed. 
-    localHistoryTransport( ST::getHistory(*d_source) );
+    MCLS_ENSURE( num_pulled > 0 );
+    return num_pulled;
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Transport a bank history.
+ * \brief Pull up to a maximum number of source and bank histories into a
+ * batch. Source histories are used first.
  */
 template<class Source>
-void SourceTransporter<Source>::transportBankHistory( BankType& bank )
+void SourceTransporter<Source>::pullHistories( 
+    BankType& bank,
+    Teuchos::Array<HistoryType>& batch,
+    const int max_histories )
 {
-    MCLS_REQUIRE( !bank.empty() );
-
-    // Get a reference to the history on top of the bank.
-    HistoryType& history = bank.top();
-
-    // Transport the history through the local domain and communicate it if
-    // needed. 
-    localHistoryTransport( history );
-
-    // Pop the top of the bank.
-    bank.pop();
+    while ( !ST::empty(*d_source) && batch.size() < max_histories )
+    {
+	batch.push_back( ST::getHistory(*d_source) );
+    }
+    while ( !bank.empty() && batch.size() < max_histories )
+    {
+	batch.push_back( bank.top() );
+	bank.pop();
+    }
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Transport a history through the local domain.
+ * \brief Transport a batch of histories through the local domain on the
+ * calling thread. The histories that left the local domain are added to the
+ * outgoing histories and the number of histories that finished all of their
+ * steps is returned.
  */
 template<class Source>
-template<class T>
-void SourceTransporter<Source>::localHistoryTransport( T&& history )
+int SourceTransporter<Source>::transportBatch( 
+    Teuchos::Array<HistoryType>& batch,
+    Teuchos::Array<HistoryType>& outgoing )
 {
-    // Set the history alive for transport.
-    HT::live( history );
-    
-    // Do local transport.
-    d_domain_transporter.transport( history );
-    MCLS_CHECK( !HT::alive(history) );
+    MCLS_REQUIRE( !batch.empty() );
 
-    // Communicate the history if it left the local domain.
-    if ( Event::BOUNDARY == HT::event(history) )
+    // Set the histories alive for transport.
+    typename Teuchos::Array<HistoryType>::iterator history_it;
+    for ( history_it = batch.begin(); 
+	  history_it != batch.end(); 
+	  ++history_it )
     {
-	d_domain_communicator.communicate( history );
+	HT::live( *history_it );
     }
 
-    // Otherwise the history was killed by the finishing all of its steps.
+    // Do local transport.
+    if ( 1 == batch.size() )
+    {
+	d_domain_transporter.transport( batch.front() );
+    }
     else
     {
-	MCLS_CHECK( Event::CUTOFF == HT::event(history) );
-	++d_num_done[0];
+	d_domain_transporter.transport( batch() );
     }
+
+    // Collect the histories that left the local domain and count those that
+    // finished all of their steps.
+    int num_done = 0;
+    for ( history_it = batch.begin(); 
+	  history_it != batch.end(); 
+	  ++history_it )
+    {
+	MCLS_CHECK( !HT::alive(*history_it) );
+
+	if ( Event::BOUNDARY == HT::event(*history_it) )
+	{
+	    outgoing.push_back( *history_it );
+	}
+	else
+	{
+	    MCLS_CHECK( Event::CUTOFF == HT::event(*history_it) );
+	    ++num_done;
+	}
+    }
+
+    return num_done;
 }
 
 //---------------------------------------------------------------------------//
@@ -312,27 +470,17 @@ void SourceTransporter<Source>::processMessages( BankType& bank )
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Post communications in the binary tree.
+ * \brief Post communications in the termination tree.
  */
 template<class Source>
 void SourceTransporter<Source>::postTreeCount()
 {
-    // Post a receive from the first child for history count data.
-    if ( d_children.first != Teuchos::OrdinalTraits<int>::invalid() )
-    {
-	d_num_done_report.first[0] = 0;
-	d_num_done_handles.first = Teuchos::ireceive<int,int>(
-	    d_num_done_report.first, d_children.first, 
-	    d_num_done_tag, *d_comm );
-    }
-
-    // Post a receive from the second child for history count data.
-    if ( d_children.second != Teuchos::OrdinalTraits<int>::invalid() )
+    // Post a receive from each child for history count data.
+    for ( int c = 0; c < d_children.size(); ++c )
     {
-	d_num_done_report.second[0] = 0;
-	d_num_done_handles.second = Teuchos::ireceive<int,int>(
-	    d_num_done_report.second, d_children.second, 
-	    d_num_done_tag, *d_comm );
+	d_num_done_report[c][0] = 0;
+	d_num_done_handles[c] = Teuchos::ireceive<int,int>(
+	    d_num_done_report[c], d_children[c], d_num_done_tag, *d_comm );
     }
 
     // Post a receive from parent for transport completion.
@@ -345,17 +493,38 @@ void SourceTransporter<Source>::postTreeCount()
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Complete outstanding communications in the binary tree at the end of
- * a cycle.
+ * \brief Complete outstanding communications in the termination tree at the
+ * end of a cycle.
  */
 template<class Source>
 void SourceTransporter<Source>::completeTreeCount()
 {
     Teuchos::Ptr<Teuchos::RCP<Request> > request_ptr;
 
-    // Children nodes send the finish message to the parent.
+    // Complete the completion messages sent to the children.
+    for ( int c = 0; c < d_children.size(); ++c )
+    {
+	if ( Teuchos::nonnull(d_complete_handles[c]) )
+	{
+	    request_ptr = 
+		Teuchos::Ptr<Teuchos::RCP<Request> >(&d_complete_handles[c]);
+	    Teuchos::wait( *d_comm, request_ptr );
+	    MCLS_CHECK( Teuchos::is_null(d_complete_handles[c]) );
+	}
+    }
+
+    // Children nodes complete their last report and send the finish message
+    // to the parent.
     if ( d_parent != Teuchos::OrdinalTraits<int>::invalid() )
     {
+	if ( Teuchos::nonnull(d_report_handle) )
+	{
+	    request_ptr = 
+		Teuchos::Ptr<Teuchos::RCP<Request> >(&d_report_handle);
+	    Teuchos::wait( *d_comm, request_ptr );
+	    MCLS_CHECK( Teuchos::is_null(d_report_handle) );
+	}
+
 	Teuchos::ArrayRCP<int> clear( 1, 1 );
 	Teuchos::RCP<Request> finish = Teuchos::isend<int,int>(
 	    clear, d_parent, d_num_done_tag, *d_comm );
@@ -365,98 +534,90 @@ void SourceTransporter<Source>::completeTreeCount()
 	MCLS_CHECK( Teuchos::is_null(finish) );
     }
 
-    // Parent will wait for first child node to clear communication.
-    if ( d_children.first != Teuchos::OrdinalTraits<int>::invalid() )
-    {
-        request_ptr = 
-            Teuchos::Ptr<Teuchos::RCP<Request> >(&d_num_done_handles.first);
-        Teuchos::wait( *d_comm, request_ptr );
-        MCLS_CHECK( Teuchos::is_null(d_num_done_handles.first) );
-    }
-
-    // Parent will wait for second child node to clear communication.
-    if ( d_children.second != Teuchos::OrdinalTraits<int>::invalid() )
+    // Parent will wait for each child node to clear communication.
+    for ( int c = 0; c < d_children.size(); ++c )
     {
         request_ptr = 
-            Teuchos::Ptr<Teuchos::RCP<Request> >(&d_num_done_handles.second);
+            Teuchos::Ptr<Teuchos::RCP<Request> >(&d_num_done_handles[c]);
         Teuchos::wait( *d_comm, request_ptr );
-        MCLS_CHECK( Teuchos::is_null(d_num_done_handles.second) );
+        MCLS_CHECK( Teuchos::is_null(d_num_done_handles[c]) );
     }
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Update the binary tree count of completed histories.
+ * \brief Update the termination tree count of completed histories.
  */
 template<class Source>
 void SourceTransporter<Source>::updateTreeCount()
 {
-    // Check for received reports of updated counts from first child.
-    if ( d_children.first != Teuchos::OrdinalTraits<int>::invalid() )
+    // Check for received reports of updated counts from each child.
+    for ( int c = 0; c < d_children.size(); ++c )
     {
         // Receive completed reports and repost.
-        if ( CommTools::isRequestComplete(d_num_done_handles.first) )
+        if ( CommTools::isRequestComplete(d_num_done_handles[c]) )
         {
-            MCLS_CHECK( *(d_num_done_report.first) > 0 );
-            d_num_done_handles.first = Teuchos::null;
+            MCLS_CHECK( d_num_done_report[c][0] > 0 );
+            d_num_done_handles[c] = Teuchos::null;
 
             // Add to the running total.
-            d_num_done[0] += d_num_done_report.first[0];
+            d_num_done[0] += d_num_done_report[c][0];
             MCLS_CHECK( d_num_done[0] <= d_nh );
 
             // Repost.
-            d_num_done_handles.first = Teuchos::ireceive<int,int>(
-		d_num_done_report.first, d_children.first,
+            d_num_done_handles[c] = Teuchos::ireceive<int,int>(
+		d_num_done_report[c], d_children[c], 
 		d_num_done_tag, *d_comm );
         }
     }
+}
 
-    // Check for received reports of updated counts from second child.
-    if ( d_children.second != Teuchos::OrdinalTraits<int>::invalid() )
-    {
-        // Receive completed reports and repost.
-        if ( CommTools::isRequestComplete(d_num_done_handles.second) )
-        {
-            MCLS_CHECK( d_num_done_report.second[0] > 0 );
-            d_num_done_handles.second = Teuchos::null;
-
-            // Add to the running total.
-            d_num_done[0] += d_num_done_report.second[0];
-            MCLS_CHECK( d_num_done[0] <= d_nh );
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Report the number of completed histories to the parent. If the
+ * last report is still in flight the count continues to accumulate until a
+ * later call.
+ */
+template<class Source>
+void SourceTransporter<Source>::reportToParent()
+{
+    MCLS_REQUIRE( d_parent != Teuchos::OrdinalTraits<int>::invalid() );
 
-            // Repost.
-            d_num_done_handles.second = Teuchos::ireceive<int,int>(
-		d_num_done_report.second, d_children.second,
-		d_num_done_tag, *d_comm );
-        }
+    // Complete the last report.
+    if ( Teuchos::nonnull(d_report_handle) )
+    {
+	if ( CommTools::isRequestComplete(d_report_handle) )
+	{
+	    d_report_handle = Teuchos::null;
+	}
+	else
+	{
+	    return;
+	}
     }
+
+    // Post the new report.
+    if ( d_num_done[0] > 0 )
+    {
+	d_report[0] = d_num_done[0];
+	d_report_handle = Teuchos::isend<int,int>(
+	    d_report, d_parent, d_num_done_tag, *d_comm );
+	d_num_done[0] = 0;
+    } 
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Send the global finished message to the children.
+ * \brief Send the global finished message to the children. The sends are
+ * completed at the end of the cycle.
  */
 template<class Source>
 void SourceTransporter<Source>::sendCompleteToChildren()
 {
-    // Child 1
-    if ( d_children.first != Teuchos::OrdinalTraits<int>::invalid() )
+    for ( int c = 0; c < d_children.size(); ++c )
     {
-        Teuchos::RCP<Request> complete = Teuchos::isend<int,int>(
-	    d_complete, d_children.first, d_completion_status_tag, *d_comm );
-        Teuchos::Ptr<Teuchos::RCP<Request> > request_ptr(&complete);
-        Teuchos::wait( *d_comm, request_ptr );
-        MCLS_CHECK( Teuchos::is_null(complete) );
-    }
-
-    // Child 2
-    if ( d_children.second != Teuchos::OrdinalTraits<int>::invalid() )
-    {
-        Teuchos::RCP<Request> complete = Teuchos::isend<int,int>(
-	    d_complete, d_children.second, d_completion_status_tag, *d_comm );
-        Teuchos::Ptr<Teuchos::RCP<Request> > request_ptr(&complete);
-        Teuchos::wait( *d_comm, request_ptr );
-        MCLS_CHECK( Teuchos::is_null(complete) );
+        d_complete_handles[c] = Teuchos::isend<int,int>(
+	    d_complete, d_children[c], d_completion_status_tag, *d_comm );
     }
 }
 
@@ -483,21 +644,13 @@ void SourceTransporter<Source>::controlTermination()
         }
     }
 
-    // Other nodes send the number of histories completed to parent and check
-    // to see if a message has arrived from the parent indicating that
+    // Other nodes report the number of histories completed to the parent and
+    // check to see if a message has arrived from the parent indicating that
     // transport has been completed.
     else
     {
-        // Send completed number of histories to parent.
-        if ( d_num_done[0] > 0 )
-        {
-            Teuchos::RCP<Request> report = Teuchos::isend<int,int>(
-		d_num_done, d_parent, d_num_done_tag, *d_comm );
-            Teuchos::Ptr<Teuchos::RCP<Request> > request_ptr(&report);
-            Teuchos::wait( *d_comm, request_ptr );
-            MCLS_CHECK( Teuchos::is_null(report) );
-            d_num_done[0] = 0;
-        } 
+        // Report completed number of histories to parent.
+	reportToParent();
 
         // Check for completion status from parent.
         if ( CommTools::isRequestComplete(d_complete_handle) )
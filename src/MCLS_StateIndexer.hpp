@@ -0,0 +1,168 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2012, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the University of Wisconsin - Madison nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file MCLS_StateIndexer.hpp
+ * \author Stuart R. Slattery
+ * \brief StateIndexer class declaration.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef MCLS_STATEINDEXER_HPP
+#define MCLS_STATEINDEXER_HPP
+
+#include <algorithm>
+
+#include "MCLS_DBC.hpp"
+
+#include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayView.hpp>
+#include <Teuchos_OrdinalTraits.hpp>
+
+namespace MCLS
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \class StateIndexer
+ * \brief Map from global states to integer ids.
+ *
+ * If the global states span a range of no more than the maximum dense ratio
+ * times the number of states, as is the case for contiguous maps, the ids
+ * are stored in a dense array indexed by the offset of the state from the
+ * smallest state and a lookup is a single load. Otherwise the states are
+ * stored sorted and looked up with a binary search. States that are not in
+ * the indexer have an invalid id.
+ */
+//---------------------------------------------------------------------------//
+template<class Ordinal>
+class StateIndexer
+{
+  public:
+
+    //@{
+    //! Typedefs.
+    typedef Ordinal                                  ordinal_type;
+    //@}
+
+    // Default constructor.
+    StateIndexer();
+
+    // Build the indexer from a set of unique states and their ids.
+    void build( const Teuchos::ArrayView<const Ordinal>& states,
+		const Teuchos::ArrayView<const int>& ids,
+		const double max_dense_ratio = 2.0 );
+
+    // Get the id of a state. Returns an invalid id if the state is not in
+    // the indexer.
+    inline int find( const Ordinal& state ) const;
+
+    //! Determine if a state is in the indexer.
+    bool contains( const Ordinal& state ) const
+    { return Teuchos::OrdinalTraits<int>::invalid() != find(state); }
+
+    //! Get the number of states in the indexer.
+    int size() const
+    { return d_size; }
+
+    //! Determine if the indexer uses dense storage.
+    bool isDense() const
+    { return d_dense; }
+
+  private:
+
+    // Number of states.
+    int d_size;
+
+    // Dense storage flag.
+    int d_dense;
+
+    // Smallest state.
+    Ordinal d_min_state;
+
+    // Dense ids indexed by the state offset from the smallest state.
+    Teuchos::Array<int> d_dense_ids;
+
+    // Sorted states for sparse storage.
+    Teuchos::Array<Ordinal> d_sorted_states;
+
+    // Ids of the sorted states for sparse storage.
+    Teuchos::Array<int> d_sorted_ids;
+};
+
+//---------------------------------------------------------------------------//
+// Inline functions.
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Get the id of a state. Returns an invalid id if the state is not in
+ * the indexer.
+ */
+template<class Ordinal>
+inline int StateIndexer<Ordinal>::find( const Ordinal& state ) const
+{
+    if ( d_dense )
+    {
+	if ( state < d_min_state || 
+	     state - d_min_state >= Ordinal(d_dense_ids.size()) )
+	{
+	    return Teuchos::OrdinalTraits<int>::invalid();
+	}
+	return d_dense_ids[ state - d_min_state ];
+    }
+
+    typename Teuchos::Array<Ordinal>::const_iterator state_it =
+	std::lower_bound( d_sorted_states.begin(), d_sorted_states.end(), 
+			  state );
+    if ( state_it == d_sorted_states.end() || *state_it != state )
+    {
+	return Teuchos::OrdinalTraits<int>::invalid();
+    }
+    return d_sorted_ids[ state_it - d_sorted_states.begin() ];
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace MCLS
+
+//---------------------------------------------------------------------------//
+// Template includes.
+//---------------------------------------------------------------------------//
+
+#include "MCLS_StateIndexer_impl.hpp"
+
+//---------------------------------------------------------------------------//
+
+#endif // end MCLS_STATEINDEXER_HPP
+
+//---------------------------------------------------------------------------//
+// end MCLS_StateIndexer.hpp
+// ---------------------------------------------------------------------------//
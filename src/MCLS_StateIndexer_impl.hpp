@@ -0,0 +1,141 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2012, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the University of Wisconsin - Madison nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file MCLS_StateIndexer_impl.hpp
+ * \author Stuart R. Slattery
+ * \brief StateIndexer class implementation.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef MCLS_STATEINDEXER_IMPL_HPP
+#define MCLS_STATEINDEXER_IMPL_HPP
+
+#include <algorithm>
+#include <utility>
+
+#include <Teuchos_as.hpp>
+
+namespace MCLS
+{
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Default constructor.
+ */
+template<class Ordinal>
+StateIndexer<Ordinal>::StateIndexer()
+    : d_size( 0 )
+    , d_dense( 1 )
+    , d_min_state( 0 )
+{ /* ... */ }
+
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Build the indexer from a set of unique states and their ids. Dense
+ * storage is used if the range of the states is no larger than the maximum
+ * dense ratio times the number of states.
+ */
+template<class Ordinal>
+void StateIndexer<Ordinal>::build( 
+    const Teuchos::ArrayView<const Ordinal>& states,
+    const Teuchos::ArrayView<const int>& ids,
+    const double max_dense_ratio )
+{
+    MCLS_REQUIRE( states.size() == ids.size() );
+    MCLS_REQUIRE( max_dense_ratio >= 1.0 );
+
+    d_size = states.size();
+    d_dense_ids.clear();
+    d_sorted_states.clear();
+    d_sorted_ids.clear();
+
+    if ( 0 == d_size )
+    {
+	d_dense = 1;
+	d_min_state = 0;
+	return;
+    }
+
+    // Determine the storage from the range of the states.
+    d_min_state = *std::min_element( states.begin(), states.end() );
+    Ordinal max_state = *std::max_element( states.begin(), states.end() );
+    double range = Teuchos::as<double>(max_state - d_min_state) + 1.0;
+    d_dense = ( range <= max_dense_ratio * d_size );
+
+    // Dense storage.
+    if ( d_dense )
+    {
+	d_dense_ids.assign( Teuchos::as<int>(range), 
+			    Teuchos::OrdinalTraits<int>::invalid() );
+	for ( int i = 0; i < d_size; ++i )
+	{
+	    MCLS_CHECK( Teuchos::OrdinalTraits<int>::invalid() ==
+			d_dense_ids[states[i] - d_min_state] );
+	    d_dense_ids[ states[i] - d_min_state ] = ids[i];
+	}
+    }
+
+    // Sorted storage.
+    else
+    {
+	Teuchos::Array<std::pair<Ordinal,int> > sorted( d_size );
+	for ( int i = 0; i < d_size; ++i )
+	{
+	    sorted[i] = std::make_pair( states[i], ids[i] );
+	}
+	std::sort( sorted.begin(), sorted.end() );
+
+	d_sorted_states.resize( d_size );
+	d_sorted_ids.resize( d_size );
+	for ( int i = 0; i < d_size; ++i )
+	{
+	    MCLS_CHECK( 0 == i || sorted[i-1].first != sorted[i].first );
+	    d_sorted_states[i] = sorted[i].first;
+	    d_sorted_ids[i] = sorted[i].second;
+	}
+    }
+
+    MCLS_ENSURE( d_size == Teuchos::as<int>(states.size()) );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace MCLS
+
+//---------------------------------------------------------------------------//
+
+#endif // end MCLS_STATEINDEXER_IMPL_HPP
+
+//---------------------------------------------------------------------------//
+// end MCLS_StateIndexer_impl.hpp
+// ---------------------------------------------------------------------------//
@@ -119,22 +119,22 @@ void SteepestDescentIteration<Vector,Matrix>::doOneIteration()
     // Build p = A*r.
     d_problem->apply( *d_problem->getPrecResidual(), *d_p );
 
-    // Petrov-Galerkin condition.
-    Scalar alpha = VT::dot( *d_problem->getPrecResidual(), 
-                            *d_problem->getPrecResidual() ) /
-                   VT::dot( *d_p, *d_problem->getPrecResidual() );
-
-    // Fixed point update.
-    VT::update( *d_problem->getLHS(), 
-                Teuchos::ScalarTraits<Scalar>::one(),
-                *d_problem->getPrecResidual(),
-                alpha );
-
-    // Residual update.
-    VT::update( *d_problem->getPrecResidual(),
-                Teuchos::ScalarTraits<Scalar>::one(),
-                *d_p,
-                -alpha );
+    // Petrov-Galerkin condition. Both inner products are computed in a
+    // single pass.
+    Scalar r_dot_r = Teuchos::ScalarTraits<Scalar>::zero();
+    Scalar r_dot_p = Teuchos::ScalarTraits<Scalar>::zero();
+    VT::dotPair( *d_problem->getPrecResidual(), 
+                 *d_problem->getPrecResidual(), 
+                 *d_p,
+                 r_dot_r,
+                 r_dot_p );
+    Scalar alpha = r_dot_r / r_dot_p;
+
+    // Fixed point and residual update in a single pass.
+    VT::updatePair( *d_problem->getLHS(), 
+                    *d_problem->getPrecResidual(),
+                    *d_p,
+                    alpha );
 }
 
 //---------------------------------------------------------------------------//
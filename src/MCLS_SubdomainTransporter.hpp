@@ -64,6 +64,10 @@ namespace MCLS
  * subsequent histories through the local domain until completion. No
  * communication operations occur within a set. Multiple set problems will
  * create multiple instances of this class.
+ *
+ * The worker threads pull batches of "History Batch Size" histories from
+ * the source until it is empty and transport them with their own random
+ * number streams and tally buffers.
  */
 //---------------------------------------------------------------------------//
 template<class Source>
@@ -98,6 +102,21 @@ class SubdomainTransporter : public GlobalTransporter<Source>
     // Reset the state of the transporter.
     void reset();
 
+    //! Get the number of histories completed on this process in the last
+    //! transport.
+    long numCompletedHistories() const
+    { return d_domain_transporter.numCompletedHistories(); }
+
+    //! Get the total number of steps of the histories completed on this
+    //! process in the last transport.
+    long numCompletedSteps() const
+    { return d_domain_transporter.numCompletedSteps(); }
+
+    //! Get the current history buffer size of each send neighbor of this
+    //! process. There is no communication in a subdomain.
+    Teuchos::Array<int> sendBufferSizes() const
+    { return Teuchos::Array<int>(); }
+
   private:
 
     // Parallel communicator for this set.
@@ -111,6 +130,12 @@ class SubdomainTransporter : public GlobalTransporter<Source>
 
     // Source.
     Teuchos::RCP<Source> d_source;
+
+    // Number of histories transported together as a batch.
+    int d_batch_size;
+
+    // History batch of each worker thread.
+    Teuchos::Array<Teuchos::Array<HistoryType> > d_thread_batches;
 };
 
 //---------------------------------------------------------------------------//
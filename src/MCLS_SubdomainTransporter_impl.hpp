@@ -41,9 +41,11 @@
 #ifndef MCLS_SUBDOMAINTRANSPORTER_IMPL_HPP
 #define MCLS_SUBDOMAINTRANSPORTER_IMPL_HPP
 
+#include "MCLS_config.hpp"
 #include "MCLS_DBC.hpp"
 #include "MCLS_CommTools.hpp"
 #include "MCLS_Events.hpp"
+#include "MCLS_ThreadTools.hpp"
 
 #include <Teuchos_CommHelpers.hpp>
 #include <Teuchos_Ptr.hpp>
@@ -63,9 +65,25 @@ SubdomainTransporter<Source>::SubdomainTransporter(
     : d_comm( comm )
     , d_domain( domain )
     , d_domain_transporter( d_domain )
+    , d_batch_size( 1 )
 {
     MCLS_REQUIRE( Teuchos::nonnull(d_comm) );
     MCLS_REQUIRE( Teuchos::nonnull(d_domain) );
+
+    // Set the number of histories to transport together. Default to 1.
+    if ( plist.isParameter("History Batch Size") )
+    {
+	d_batch_size = plist.get<int>("History Batch Size");
+    }
+
+    // Create the worker thread batches.
+    d_thread_batches.resize( ThreadTools::maxThreads() );
+    for ( int t = 0; t < d_thread_batches.size(); ++t )
+    {
+	d_thread_batches[t].reserve( d_batch_size );
+    }
+
+    MCLS_ENSURE( d_batch_size > 0 );
 }
 
 //---------------------------------------------------------------------------//
@@ -91,18 +109,46 @@ void SubdomainTransporter<Source>::transport()
 {
     MCLS_REQUIRE( Teuchos::nonnull(d_source) );
 
-    // Transport all source histories through the local domain until completion.
-    while ( !ST::empty(*d_source) )
+    // Transport all source histories through the local domain until
+    // completion. Each worker thread pulls batches of histories from the
+    // source. The source is only accessed inside a critical section.
+#if HAVE_MCLS_OPENMP
+#pragma omp parallel num_threads(d_thread_batches.size())
+#endif
     {
-        // Get a history from the source.
-        HistoryType history = ST::getHistory( *d_source );
-        MCLS_CHECK( HT::alive(history) );
-
-        // Do local transport.
-        d_domain_transporter.transport( history );
-        MCLS_CHECK( !HT::alive(history) );
-        MCLS_CHECK( Event::CUTOFF == HT::event(history) ||
-                    Event::BOUNDARY == HT::event(history) );
+	Teuchos::Array<HistoryType>& batch = 
+	    d_thread_batches[ ThreadTools::threadId() ];
+
+	do
+	{
+	    // Get a batch of histories from the source and set them alive for
+	    // transport.
+	    batch.clear();
+#if HAVE_MCLS_OPENMP
+#pragma omp critical(MCLS_SubdomainTransporter_pull)
+#endif
+	    {
+		while ( !ST::empty(*d_source) && 
+			batch.size() < d_batch_size )
+		{
+		    batch.push_back( ST::getHistory(*d_source) );
+		    HT::live( batch.back() );
+		}
+	    }
+
+	    // Do local transport.
+	    if ( 1 == batch.size() )
+	    {
+		d_domain_transporter.transport( batch.front() );
+		MCLS_CHECK( !HT::alive(batch.front()) );
+		MCLS_CHECK( Event::CUTOFF == HT::event(batch.front()) ||
+			    Event::BOUNDARY == HT::event(batch.front()) );
+	    }
+	    else if ( !batch.empty() )
+	    {
+		d_domain_transporter.transport( batch() );
+	    }
+	} while ( !batch.empty() );
     }
 
     // Barrier before continuing.
@@ -113,11 +159,15 @@ void SubdomainTransporter<Source>::transport()
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Reset the state of the transporter.
+ * \brief Reset the state of the transporter. The domain tally is rebound
+ * such that a domain with refilled values may be transported again.
  */
 template<class Source>
 void SubdomainTransporter<Source>::reset()
-{ /* ... */ }
+{
+    d_domain_transporter.resetStatistics();
+    d_domain_transporter.updateTally();
+}
 
 //---------------------------------------------------------------------------//
 
@@ -44,6 +44,7 @@
 #include <Teuchos_RCP.hpp>
 #include <Teuchos_Comm.hpp>
 #include <Teuchos_Array.hpp>
+#include <Teuchos_ArrayView.hpp>
 
 namespace MCLS
 {
@@ -103,6 +104,37 @@ class TallyTraits
 	return Teuchos::null;
     }
     
+    /*!
+     * \brief Set the tally to use the expected value estimator with the
+     * packed rows of the local iteration matrix. The row data is owned by
+     * the domain. Contributions are only made for steps less than the
+     * history length.
+     */
+    static void setExpectedValueEstimator( 
+	Tally& tally,
+	const Teuchos::ArrayView<const int>& row_offsets,
+	const Teuchos::ArrayView<const int>& local_columns,
+	const Teuchos::ArrayView<const double>& cdfs,
+	const Teuchos::ArrayView<const int>& signs,
+	const Teuchos::ArrayView<const double>& weights,
+	const int history_length )
+    {
+	UndefinedTallyTraits<Tally>::notDefined(); 
+    }
+
+    /*!
+     * \brief Set the overlap states of the tally in local state order. Local
+     * states beyond the local length of the tally vector are overlap states
+     * and their tallies are returned to their owning processes when the
+     * tally is finalized.
+     */
+    static void setOverlapStates( 
+	Tally& tally,
+	const Teuchos::ArrayView<const ordinal_type>& states )
+    {
+	UndefinedTallyTraits<Tally>::notDefined(); 
+    }
+
     /*!
      * \brief Add a history's contribution to the tally.
      */
@@ -144,6 +176,29 @@ class TallyTraits
     {
 	UndefinedTallyTraits<Tally>::notDefined(); 
     }
+
+    /*!
+     * \brief Set the number of batches the tally keeps for its variance
+     * estimate. Zero disables the batches. Tallies that estimate their
+     * variance from complete history scores do not need batches.
+     */
+    static void setVarianceBatches( Tally& tally, const int num_batches )
+    {
+	UndefinedTallyTraits<Tally>::notDefined(); 
+    }
+
+    /*!
+     * \brief Estimate the variance of the mean of each state of the last
+     * finalized tally from the scores of its histories. The variance vector
+     * is in the decomposition of the tally vector. Return false if the tally
+     * cannot estimate its variance. This must be called on all processes of
+     * the set.
+     */
+    static bool estimateVariance( Tally& tally, vector_type& variance )
+    {
+	UndefinedTallyTraits<Tally>::notDefined(); 
+	return false;
+    }
 };
 
 //---------------------------------------------------------------------------//
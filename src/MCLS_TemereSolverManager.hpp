@@ -161,6 +161,9 @@ class TemereSolverManager : public SolverManager<Vector,Matrix>
     // Residual linear problem
     Teuchos::RCP<LinearProblemType> d_residual_problem;
 
+    // Work vector for preconditioned source norms and solution recovery.
+    Teuchos::RCP<Vector> d_work;
+
     // Parameters.
     Teuchos::RCP<Teuchos::ParameterList> d_plist;
 
@@ -147,9 +147,8 @@ TemereSolverManager<Vector,Matrix,MonteCarloTag,RNG>::achievedTol() const
     // Compute the source norm preconditioned if necessary.
     if ( d_problem->isLeftPrec() )
     {
-	Teuchos::RCP<Vector> tmp = VT::clone( *d_problem->getRHS() );
-	d_problem->applyLeftPrec( *d_problem->getRHS(), *tmp );
-	source_norm = VT::norm2( *tmp );
+	d_problem->applyLeftPrec( *d_problem->getRHS(), *d_work );
+	source_norm = VT::norm2( *d_work );
     }
     else
     {
@@ -249,9 +248,8 @@ bool TemereSolverManager<Vector,Matrix,MonteCarloTag,RNG>::solve()
     // Compute the source norm preconditioned if necessary.
     if ( d_problem->isLeftPrec() )
     {
-	Teuchos::RCP<Vector> tmp = VT::clone( *d_problem->getRHS() );
-	d_problem->applyLeftPrec( *d_problem->getRHS(), *tmp );
-	source_norm = VT::norm2( *tmp );
+	d_problem->applyLeftPrec( *d_problem->getRHS(), *d_work );
+	source_norm = VT::norm2( *d_work );
     }
     else
     {
@@ -293,9 +291,8 @@ bool TemereSolverManager<Vector,Matrix,MonteCarloTag,RNG>::solve()
     }
 
     // Compute the initial preconditioned residual.
-    d_problem->updatePrecResidual();
     typename Teuchos::ScalarTraits<Scalar>::magnitudeType residual_norm =
-	VT::norm2( *d_problem->getPrecResidual() );
+	d_problem->updatePrecResidualNorm();
 
     // Print initial iteration data.
     printTopBanner();
@@ -325,8 +322,7 @@ bool TemereSolverManager<Vector,Matrix,MonteCarloTag,RNG>::solve()
 		    Teuchos::ScalarTraits<Scalar>::one() );
 
 	// Update the preconditioned residual.
-	d_problem->updatePrecResidual();
-	residual_norm = VT::norm2( *d_problem->getPrecResidual() );
+	residual_norm = d_problem->updatePrecResidualNorm();
 
 	// Check if we're done iterating.
 	if ( d_num_iters % check_freq == 0 )
@@ -351,12 +347,11 @@ bool TemereSolverManager<Vector,Matrix,MonteCarloTag,RNG>::solve()
     // Recover the original solution if right preconditioned.
     if ( d_problem->isRightPrec() )
     {
-	Teuchos::RCP<Vector> temp = VT::clone(*d_problem->getLHS());
 	d_problem->applyRightPrec( *d_problem->getLHS(),
-				   *temp );
+				   *d_work );
 	VT::update( *d_problem->getLHS(),
 		    Teuchos::ScalarTraits<Scalar>::zero(),
-		    *temp,
+		    *d_work,
 		    Teuchos::ScalarTraits<Scalar>::one() );
     }
 
@@ -388,6 +383,7 @@ TemereSolverManager<Vector,Matrix,MonteCarloTag,RNG>::buildResidualMonteCarloPro
     // pass the preconditioners and operator separately to defer composite
     // operator construction until the last possible moment.
     Teuchos::RCP<Vector> delta_x = VT::clone( *d_problem->getLHS() );
+    d_work = VT::clone( *d_problem->getLHS() );
     d_residual_problem = Teuchos::rcp(
 	new LinearProblemType( d_problem->getOperator(),
 			       delta_x,
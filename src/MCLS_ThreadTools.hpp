@@ -0,0 +1,114 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2012, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the University of Wisconsin - Madison nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+ * \file MCLS_ThreadTools.hpp
+ * \author Stuart R. Slattery
+ * \brief ThreadTools definition.
+ */
+//---------------------------------------------------------------------------//
+
+#ifndef MCLS_THREADTOOLS_HPP
+#define MCLS_THREADTOOLS_HPP
+
+#include "MCLS_config.hpp"
+
+#if HAVE_MCLS_OPENMP
+#include <omp.h>
+#endif
+
+namespace MCLS
+{
+
+//---------------------------------------------------------------------------//
+/*!
+ * \class ThreadTools
+ * \brief Tools for shared-memory threading within a process.
+ *
+ * When MCLS is built without OpenMP all work is done by a single thread with
+ * id 0.
+ */
+class ThreadTools
+{
+  public:
+
+    /*!
+     * \brief Get the maximum number of threads that may be used for a
+     * parallel region.
+     */
+    static inline int maxThreads()
+    {
+#if HAVE_MCLS_OPENMP
+	return omp_get_max_threads();
+#else
+	return 1;
+#endif
+    }
+
+    /*!
+     * \brief Get the number of threads in the team of the current parallel
+     * region. This may be less than the number requested for the region.
+     */
+    static inline int numThreads()
+    {
+#if HAVE_MCLS_OPENMP
+	return omp_get_num_threads();
+#else
+	return 1;
+#endif
+    }
+
+    /*!
+     * \brief Get the id of the calling thread in the current parallel
+     * region.
+     */
+    static inline int threadId()
+    {
+#if HAVE_MCLS_OPENMP
+	return omp_get_thread_num();
+#else
+	return 0;
+#endif
+    }
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace MCLS
+
+//---------------------------------------------------------------------------//
+
+#endif // end MCLS_THREADTOOLS_HPP
+
+//---------------------------------------------------------------------------//
+// end MCLS_ThreadTools.hpp
+//---------------------------------------------------------------------------//
@@ -45,6 +45,7 @@
 
 #include "MCLS_SourceTraits.hpp"
 #include "MCLS_DomainTraits.hpp"
+#include "MCLS_HistoryTraits.hpp"
 #include "MCLS_VectorTraits.hpp"
 #include "MCLS_TallyTraits.hpp"
 #include "MCLS_PRNG.hpp"
@@ -77,6 +78,7 @@ class UniformAdjointSource
     typedef Domain                                        domain_type;
     typedef DomainTraits<Domain>                          DT;
     typedef typename DT::history_type                     HistoryType;
+    typedef HistoryTraits<HistoryType>                    HT;
     typedef typename DT::ordinal_type                     Ordinal;
     typedef typename DT::tally_type                       TallyType;
     typedef TallyTraits<TallyType>                        TT;
@@ -177,6 +179,9 @@ class UniformAdjointSource
     // Number of histories emitted in the local domain.
     int d_nh_emitted;
 
+    // Set id of the first history emitted in the local domain.
+    std::size_t d_first_history;
+
     // Random/stratified sampling boolean.
     int d_random_sampling;
 
@@ -237,6 +242,15 @@ class SourceTraits<UniformAdjointSource<Domain> >
 	return source.sourceWeight();
     }
 
+    /*!
+     * \brief Get the magnitude of the starting weight of the source
+     * histories.
+     */
+    static double sourceWeight( const source_type& source )
+    { 
+	return source.sourceWeight();
+    }
+
     /*!
      * \brief Get a history from the source.
      */
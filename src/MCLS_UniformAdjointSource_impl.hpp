@@ -41,6 +41,8 @@
 #ifndef MCLS_UNIFORMADJOINTSOURCE_IMPL_HPP
 #define MCLS_UNIFORMADJOINTSOURCE_IMPL_HPP
 
+#include <algorithm>
+
 #include "MCLS_DBC.hpp"
 #include "MCLS_SamplingTools.hpp"
 #include "MCLS_Serializer.hpp"
@@ -69,6 +71,7 @@ UniformAdjointSource<Domain>::UniformAdjointSource(
     , d_weight( VT::norm1(*d_b) )
     , d_nh_left(0)
     , d_nh_emitted(0)
+    , d_first_history(0)
     , d_random_sampling(1)
     , d_local_length( VT::getLocalLength(*d_b) )
     , d_cdf( d_local_length )
@@ -110,7 +113,8 @@ UniformAdjointSource<Domain>::UniformAdjointSource(
 
 //---------------------------------------------------------------------------//
 /*!
- * \brief Build the source.
+ * \brief Build the source. The source may be rebuilt for new values of the
+ * source vector.
  */
 template<class Domain>
 void UniformAdjointSource<Domain>::buildSource()
@@ -120,6 +124,15 @@ void UniformAdjointSource<Domain>::buildSource()
     d_local_length = VT::getLocalLength(*d_b);
     MCLS_CHECK( d_local_source.size() > 0 );
 
+    // Reset the weight and requested histories for the current source
+    // values.
+    d_weight = VT::norm1( *d_b );
+    d_nh_total = d_nh_requested;
+    while ( !d_history_stack.empty() )
+    {
+	d_history_stack.pop();
+    }
+
     // Build the source.
     if ( d_random_sampling )
     {
@@ -135,6 +148,18 @@ void UniformAdjointSource<Domain>::buildSource()
 			d_nh_domain, Teuchos::Ptr<int>(&d_nh_total) );
     MCLS_CHECK( d_nh_total > 0 );
 
+    // In reproducible mode number the histories of the set consecutively by
+    // process such that each history has a stable id for its random number
+    // substream.
+    d_first_history = 0;
+    if ( Teuchos::nonnull(d_rng) && d_rng->reproducible() )
+    {
+	int nh_inclusive = 0;
+	Teuchos::scan( *VT::getComm(*d_b), Teuchos::REDUCE_SUM, 
+		       d_nh_domain, Teuchos::Ptr<int>(&nh_inclusive) );
+	d_first_history = nh_inclusive - d_nh_domain;
+    }
+
     // Set counters.
     d_nh_left = d_nh_domain;
     d_nh_emitted = 0;
@@ -164,14 +189,17 @@ UniformAdjointSource<Domain>::getHistory()
         d_history_stack.pop();
     }
 
+    // Generate the history. Its id keys its random number substream.
+    Ordinal weight_sign = (d_local_source[local_state] > 0.0) ? 1 : -1;
+    HistoryType history(
+	d_global_states[local_state], local_state, d_weight * weight_sign );
+    HT::setHistoryId( history, d_first_history + d_nh_emitted );
+
     // Update count.
     --d_nh_left;
     ++d_nh_emitted;
 
-    // Generate the history.
-    Ordinal weight_sign = (d_local_source[local_state] > 0.0) ? 1 : -1;
-    return HistoryType(
-	d_global_states[local_state], local_state, d_weight * weight_sign );
+    return history;
 }
 
 //---------------------------------------------------------------------------//
@@ -195,7 +223,7 @@ void UniformAdjointSource<Domain>::buildRandomSource()
 
     // Stratify sample the global domain to get the number of histories that
     // will be generated by sampling the local cdf.
-    d_nh_domain = d_nh_total * d_cdf().back() / VT::norm1(*d_b);
+    d_nh_domain = d_nh_total * d_cdf().back() / d_weight;
 
     // Normalize the CDF.
     for ( cdf_it = d_cdf.begin(); cdf_it != d_cdf.end(); ++cdf_it )
@@ -205,14 +233,23 @@ void UniformAdjointSource<Domain>::buildRandomSource()
     }
     MCLS_CHECK( std::abs(d_cdf().back()-1) < 1.0e-6 );
 
-    // Randomly sample the source to build the history stack.
+    // Randomly sample the source to build the history stack. Random numbers
+    // are generated in blocks.
     for ( auto& i : d_samples_per_state ) i = 0;
-    for ( int i = 0; i < d_nh_domain; ++i )
+    const int block_size = 256;
+    double random_block[block_size];
+    int num_block = 0;
+    for ( int block = 0; block < d_nh_domain; block += block_size )
     {
-	++d_samples_per_state[
-	    SamplingTools::sampleDiscreteCDF( 
-		d_cdf.getRawPtr(), d_cdf.size(), d_rng->random(*d_rng_dist) )
-	    ];
+	num_block = std::min( block_size, d_nh_domain - block );
+	d_rng->fill( random_block, num_block );
+	for ( int i = 0; i < num_block; ++i )
+	{
+	    ++d_samples_per_state[
+		SamplingTools::sampleDiscreteCDF( 
+		    d_cdf.getRawPtr(), d_cdf.size(), random_block[i] )
+		];
+	}
     }
     for ( int i = 0; i < d_local_source.size(); ++i )
     {
@@ -43,6 +43,7 @@
 
 #include "MCLS_SourceTraits.hpp"
 #include "MCLS_DomainTraits.hpp"
+#include "MCLS_HistoryTraits.hpp"
 #include "MCLS_VectorTraits.hpp"
 #include "MCLS_TallyTraits.hpp"
 #include "MCLS_PRNG.hpp"
@@ -75,6 +76,7 @@ class UniformForwardSource
     typedef Domain                                        domain_type;
     typedef DomainTraits<Domain>                          DT;
     typedef typename DT::history_type                     HistoryType;
+    typedef HistoryTraits<HistoryType>                    HT;
     typedef typename DT::ordinal_type                     Ordinal;
     typedef typename DT::tally_type                       TallyType;
     typedef TallyTraits<TallyType>                        TT;
@@ -222,6 +224,15 @@ class SourceTraits<UniformForwardSource<Domain> >
 	return source.sourceWeight();
     }
 
+    /*!
+     * \brief Get the magnitude of the starting weight of the source
+     * histories.
+     */
+    static double sourceWeight( const source_type& source )
+    { 
+	return source.sourceWeight();
+    }
+
     /*!
      * \brief Get a history from the source.
      */
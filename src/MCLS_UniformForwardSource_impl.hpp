@@ -128,8 +128,13 @@ UniformForwardSource<Domain>::getHistory()
     Ordinal starting_state = VT::getGlobalRow( *d_b, d_current_local_state );
     MCLS_CHECK( DT::isGlobalState(*d_domain,starting_state) );
 
-    // Create the history.
+    // Create the history. Its id is its sample index over the global states
+    // such that it does not depend on the decomposition. The index is
+    // computed in std::size_t as it may not fit in the ordinal type.
     HistoryType history( starting_state, d_current_local_state, d_weight );
+    std::size_t history_id = 
+	static_cast<std::size_t>(starting_state) * d_nh_per_state + 
+	d_current_state_samples;
     
     // Update local state.
     ++d_current_state_samples;
@@ -143,6 +148,9 @@ UniformForwardSource<Domain>::getHistory()
     --d_nh_left;
     ++d_nh_emitted;
 
+    // Set the id that keys the random number substream of the history.
+    HT::setHistoryId( history, history_id );
+
     // Return the history.
     return history;
 }
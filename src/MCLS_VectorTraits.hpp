@@ -350,6 +350,49 @@ class VectorTraits
 				     const Vector& B, const Vector& C,
 				     const scalar_type& beta)
     { UndefinedVectorTraits<Vector>::notDefined(); }
+
+    /*!
+     * \brief Update vector with A = alpha*A + beta*B and return the 2-norm
+     * of the updated vector. The update and norm are computed in a single
+     * pass over the vectors.
+     */
+    static typename Teuchos::ScalarTraits<scalar_type>::magnitudeType 
+    updateNorm2( Vector& A, const scalar_type& alpha,
+		 const Vector& B, const scalar_type& beta )
+    { UndefinedVectorTraits<Vector>::notDefined(); return 0; }
+
+    /*!
+     * \brief Update two vectors with A = A + alpha*B and B = B - alpha*C in
+     * a single pass over the vectors.
+     */
+    static void updatePair( Vector& A, Vector& B, 
+			    const Vector& C, const scalar_type& alpha )
+    { UndefinedVectorTraits<Vector>::notDefined(); }
+
+    /*!
+     * \brief Compute the dot products A \dot B and A \dot C in a single
+     * pass over the vectors with a single global reduction.
+     */
+    static void dotPair( const Vector& A, const Vector& B, const Vector& C,
+			 scalar_type& A_dot_B, scalar_type& A_dot_C )
+    { UndefinedVectorTraits<Vector>::notDefined(); }
+
+    /*!
+     * \brief Compute the squared 2-norm of the local components of the
+     * vector without a global reduction.
+     */
+    static typename Teuchos::ScalarTraits<scalar_type>::magnitudeType 
+    localNorm2Squared( const Vector& vector )
+    { UndefinedVectorTraits<Vector>::notDefined(); return 0; }
+
+    /*!
+     * \brief Compute the sum of the components of A and the squared 2-norm
+     * of B in a single pass over the vectors with a single global reduction.
+     */
+    static void sumAndNorm2Squared( const Vector& A, const Vector& B,
+				    scalar_type& A_sum, 
+				    scalar_type& B_norm2_squared )
+    { UndefinedVectorTraits<Vector>::notDefined(); }
 };
 
 //---------------------------------------------------------------------------//
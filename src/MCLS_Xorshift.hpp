@@ -43,6 +43,7 @@
 
 #include <random>
 #include <limits>
+#include <algorithm>
 
 #include "MCLS_RNGTraits.hpp"
 
@@ -87,6 +88,9 @@ class Xorshift
     // Get a random number.
     inline result_type operator()();
 
+    // Fill an array with uniform random numbers in [0,1).
+    inline void fill( double* values, const int num_values );
+
   private:
 
     // Random number state.
@@ -108,6 +112,38 @@ inline uint_type Xorshift<uint_type,a,b,c>::operator()()
     return d_x;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * \brief Fill an array with uniform random numbers in [0,1).
+ *
+ * The recurrence is run with the state held in a register to produce a
+ * block of raw bits which is then converted to doubles in a separate loop
+ * that the compiler may vectorize. The sequence is the same as that from
+ * successive calls to operator().
+ */
+template<class uint_type, uint_type a, uint_type b, uint_type c>
+inline void Xorshift<uint_type,a,b,c>::fill( double* values, 
+					     const int num_values )
+{
+    const int block_size = 64;
+    uint_type bits[block_size];
+    uint_type x = d_x;
+    int num_block = 0;
+    for ( int block = 0; block < num_values; block += block_size )
+    {
+	num_block = std::min( block_size, num_values - block );
+	for ( int i = 0; i < num_block; ++i )
+	{
+	    x ^= x << a;
+	    x ^= x >> b;
+	    x ^= x << c;
+	    bits[i] = x;
+	}
+	bitsToDouble( bits, values + block, num_block );
+    }
+    d_x = x;
+}
+
 //---------------------------------------------------------------------------//
 // Specialization for RNGTraits.
 //---------------------------------------------------------------------------//
@@ -129,6 +165,35 @@ class RNGTraits<Xorshift<uint_type,a,b,c> >
 	return Teuchos::rcp( new rng_type(seed) );
     }
 
+    //! Key a random number generator with a seed, stream, and substream. A
+    //! zero state is invalid for Xorshift so it is remapped.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream )
+    {
+	uint_type state = streamSeed( seed, stream, substream );
+	rng.seed( (0 == state) ? 1 : state );
+    }
+
+    //! Key a random number generator with a seed, stream, substream, and
+    //! offset. Each offset keys an independent sequence.
+    static void setStream( rng_type& rng, 
+			   const std::size_t seed,
+			   const std::size_t stream,
+			   const std::size_t substream,
+			   const std::size_t offset )
+    {
+	uint_type state = streamSeed( seed, stream, substream, offset );
+	rng.seed( (0 == state) ? 1 : state );
+    }
+
+    //! Fill an array with uniform random numbers in [0,1).
+    static void fill( rng_type& rng, double* values, const int num_values )
+    {
+	rng.fill( values, num_values );
+    }
+
     //! Get a random number from a specified distribution.
     template<class RandomDistribution>
     static inline typename RandomDistributionTraits<RandomDistribution>::result_type
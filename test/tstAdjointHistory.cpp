@@ -44,6 +44,8 @@
 #include <sstream>
 #include <stdexcept>
 #include <random>
+#include <cstdint>
+#include <limits>
 
 #include <MCLS_config.hpp>
 #include <MCLS_AdjointHistory.hpp>
@@ -135,7 +137,8 @@ UNIT_TEST_INSTANTIATION( AdjointHistory, history )
 //---------------------------------------------------------------------------//
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( AdjointHistory, pack_unpack, Ordinal )
 {
-    std::size_t byte_size = sizeof(Ordinal) + sizeof(double) + 3*sizeof(int);
+    std::size_t byte_size = 
+	sizeof(Ordinal) + sizeof(double) + sizeof(std::int32_t);
     MCLS::AdjointHistory<Ordinal>::setByteSize();
     std::size_t packed_bytes = 
 	MCLS::AdjointHistory<Ordinal>::getPackedBytes();
@@ -153,13 +156,118 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( AdjointHistory, pack_unpack, Ordinal )
     TEST_EQUALITY( h_2.weight(), 6 );
     TEST_EQUALITY( h_2.globalState(), 5 );
     TEST_EQUALITY( h_2.localState(), Teuchos::OrdinalTraits<Ordinal>::invalid() );
-    TEST_ASSERT( h_2.alive() );
+    TEST_ASSERT( !h_2.alive() );
     TEST_EQUALITY( h_2.event(), MCLS::Event::BOUNDARY );
     TEST_EQUALITY( h_2.numSteps(), 1 );
+
+    // Without compact steps the step count is not limited to 16 bits.
+    TEST_ASSERT( !MCLS::AdjointHistory<Ordinal>::compactSteps() );
+    MCLS::AdjointHistory<Ordinal> h_3( 5, 2, 6 );
+    int long_history = std::numeric_limits<std::uint16_t>::max() + 10;
+    for ( int i = 0; i < long_history; ++i )
+    {
+	h_3.addStep();
+    }
+    MCLS::AdjointHistory<Ordinal> h_4( h_3.pack() );
+    TEST_EQUALITY( h_4.numSteps(), long_history );
 }
 
 UNIT_TEST_INSTANTIATION( AdjointHistory, pack_unpack )
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( AdjointHistory, pack_unpack_compact, Ordinal )
+{
+    std::size_t byte_size = 
+	sizeof(std::int32_t) + sizeof(double) + sizeof(std::uint16_t);
+    MCLS::AdjointHistory<Ordinal>::setByteSize( true, true );
+    std::size_t packed_bytes = 
+	MCLS::AdjointHistory<Ordinal>::getPackedBytes();
+    TEST_EQUALITY( packed_bytes, byte_size );
+
+    MCLS::AdjointHistory<Ordinal> h_1( 5, 2, 6 );
+    h_1.live();
+    h_1.setEvent( MCLS::Event::BOUNDARY );
+    h_1.addStep();
+    h_1.addStep();
+    Teuchos::Array<char> packed_history = h_1.pack();
+    TEST_EQUALITY( Teuchos::as<std::size_t>( packed_history.size() ), 
+		   byte_size );
+
+    MCLS::AdjointHistory<Ordinal> h_2( packed_history );
+    TEST_EQUALITY( h_2.weight(), 6 );
+    TEST_EQUALITY( h_2.globalState(), 5 );
+    TEST_EQUALITY( h_2.localState(), Teuchos::OrdinalTraits<Ordinal>::invalid() );
+    TEST_ASSERT( !h_2.alive() );
+    TEST_EQUALITY( h_2.event(), MCLS::Event::BOUNDARY );
+    TEST_EQUALITY( h_2.numSteps(), 2 );
+    TEST_ASSERT( MCLS::AdjointHistory<Ordinal>::compactSteps() );
+
+    MCLS::AdjointHistory<Ordinal>::setByteSize();
+}
+
+UNIT_TEST_INSTANTIATION( AdjointHistory, pack_unpack_compact )
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( AdjointHistory, pack_unpack_history_id, Ordinal )
+{
+    std::size_t byte_size = 
+	sizeof(Ordinal) + sizeof(double) + sizeof(std::int32_t) + 
+	sizeof(std::uint64_t);
+    MCLS::AdjointHistory<Ordinal>::setByteSize( false, false, true );
+    std::size_t packed_bytes = 
+	MCLS::AdjointHistory<Ordinal>::getPackedBytes();
+    TEST_EQUALITY( packed_bytes, byte_size );
+    TEST_ASSERT( MCLS::AdjointHistory<Ordinal>::packHistoryIds() );
+
+    // Ids beyond 32 bits are preserved.
+    std::size_t history_id = 5000000000ULL;
+    MCLS::AdjointHistory<Ordinal> h_1( 5, 2, 6 );
+    h_1.setHistoryId( history_id );
+    h_1.addStep();
+    h_1.addStep();
+    h_1.addStep();
+    Teuchos::Array<char> packed_history = h_1.pack();
+    TEST_EQUALITY( Teuchos::as<std::size_t>( packed_history.size() ), 
+		   byte_size );
+
+    MCLS::AdjointHistory<Ordinal> h_2( packed_history );
+    TEST_EQUALITY( h_2.globalState(), 5 );
+    TEST_EQUALITY( h_2.weight(), 6 );
+    TEST_EQUALITY( h_2.numSteps(), 3 );
+    TEST_ASSERT( history_id == h_2.historyId() );
+
+    MCLS::AdjointHistory<Ordinal>::setByteSize();
+    TEST_ASSERT( !MCLS::AdjointHistory<Ordinal>::packHistoryIds() );
+}
+
+UNIT_TEST_INSTANTIATION( AdjointHistory, pack_unpack_history_id )
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( AdjointHistory, pack_unpack_in_place, Ordinal )
+{
+    MCLS::AdjointHistory<Ordinal>::setByteSize();
+    std::size_t packed_bytes = 
+	MCLS::AdjointHistory<Ordinal>::getPackedBytes();
+    Teuchos::Array<char> buffer( 2*packed_bytes );
+
+    MCLS::AdjointHistory<Ordinal> h_1( 5, 2, 6 );
+    h_1.live();
+    h_1.setEvent( MCLS::Event::BOUNDARY );
+    h_1.addStep();
+    h_1.pack( buffer.getRawPtr() + packed_bytes );
+
+    MCLS::AdjointHistory<Ordinal> h_2;
+    h_2.unpack( buffer.getRawPtr() + packed_bytes );
+    TEST_EQUALITY( h_2.weight(), 6 );
+    TEST_EQUALITY( h_2.globalState(), 5 );
+    TEST_EQUALITY( h_2.localState(), Teuchos::OrdinalTraits<Ordinal>::invalid() );
+    TEST_ASSERT( !h_2.alive() );
+    TEST_EQUALITY( h_2.event(), MCLS::Event::BOUNDARY );
+    TEST_EQUALITY( h_2.numSteps(), 1 );
+}
+
+UNIT_TEST_INSTANTIATION( AdjointHistory, pack_unpack_in_place )
+
 //---------------------------------------------------------------------------//
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( AdjointHistory, broadcast, Ordinal )
 {
@@ -187,7 +295,7 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( AdjointHistory, broadcast, Ordinal )
     TEST_EQUALITY( h_2.weight(), 6 );
     TEST_EQUALITY( h_2.globalState(), 5 );
     TEST_EQUALITY( h_2.localState(), Teuchos::OrdinalTraits<Ordinal>::invalid() );
-    TEST_ASSERT( h_2.alive() );
+    TEST_ASSERT( !h_2.alive() );
     TEST_EQUALITY( h_2.event(), MCLS::Event::BOUNDARY );
     TEST_EQUALITY( h_2.numSteps(), 1 );
 }
@@ -102,6 +102,99 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( CommTools, ReduceSum, Scalar )
 
 UNIT_TEST_INSTANTIATION( CommTools, ReduceSum )
 
+//---------------------------------------------------------------------------//
+// Message size and contents from rank q to rank r for the neighbor exchange.
+int messageSize( const int q, const int r )
+{
+    return (2*q + r) % 4;
+}
+
+char messageByte( const int q, const int r, const int k )
+{
+    return static_cast<char>( (q + 3*r + k) % 127 );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( CommTools, NeighborAlltoallv )
+{
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = getDefaultComm<int>();
+    int comm_rank = comm->getRank();
+    int comm_size = comm->getSize();
+
+    // Every proc neighbors every other proc. Messages have uneven sizes and
+    // some neighbors are sent zero-length messages.
+    Teuchos::Array<int> neighbor_ranks;
+    for ( int n = 0; n < comm_size; ++n )
+    {
+	if ( n != comm_rank )
+	{
+	    neighbor_ranks.push_back( n );
+	}
+    }
+    Teuchos::RCP<const Teuchos::Comm<int> > neighbor_comm =
+	MCLS::CommTools::createNeighborComm( 
+	    comm, neighbor_ranks(), neighbor_ranks() );
+
+    Teuchos::Array<int> send_sizes( neighbor_ranks.size() );
+    Teuchos::Array<char> send_buffer;
+    for ( int n = 0; n < neighbor_ranks.size(); ++n )
+    {
+	send_sizes[n] = messageSize( comm_rank, neighbor_ranks[n] );
+	for ( int k = 0; k < send_sizes[n]; ++k )
+	{
+	    send_buffer.push_back( 
+		messageByte(comm_rank, neighbor_ranks[n], k) );
+	}
+    }
+
+    Teuchos::Array<int> receive_sizes( neighbor_ranks.size(), -1 );
+    Teuchos::Array<char> receive_buffer;
+    MCLS::CommTools::neighborAlltoallv( neighbor_comm,
+					send_sizes(),
+					send_buffer(),
+					receive_sizes(),
+					receive_buffer );
+
+    // Check that the messages from each neighbor arrived in neighbor order.
+    int offset = 0;
+    for ( int n = 0; n < neighbor_ranks.size(); ++n )
+    {
+	TEST_EQUALITY( receive_sizes[n], 
+		       messageSize(neighbor_ranks[n], comm_rank) );
+	for ( int k = 0; k < receive_sizes[n]; ++k )
+	{
+	    TEST_EQUALITY( receive_buffer[offset+k], 
+			   messageByte(neighbor_ranks[n], comm_rank, k) );
+	}
+	offset += receive_sizes[n];
+    }
+    TEST_EQUALITY( Teuchos::as<int>(receive_buffer.size()), offset );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( CommTools, SerialNeighborAlltoallv )
+{
+    // A serial communicator has no neighbors, even in an MPI build.
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::rcp( new Teuchos::SerialComm<int>() );
+    Teuchos::Array<int> neighbor_ranks;
+    Teuchos::RCP<const Teuchos::Comm<int> > neighbor_comm =
+	MCLS::CommTools::createNeighborComm( 
+	    comm, neighbor_ranks(), neighbor_ranks() );
+    TEST_EQUALITY( neighbor_comm->getSize(), 1 );
+
+    Teuchos::Array<int> send_sizes;
+    Teuchos::Array<char> send_buffer;
+    Teuchos::Array<int> receive_sizes;
+    Teuchos::Array<char> receive_buffer( 4, 'a' );
+    MCLS::CommTools::neighborAlltoallv( neighbor_comm,
+					send_sizes(),
+					send_buffer(),
+					receive_sizes(),
+					receive_buffer );
+    TEST_ASSERT( receive_buffer.empty() );
+}
+
 //---------------------------------------------------------------------------//
 // end tstCommTools.cpp
 //---------------------------------------------------------------------------//
@@ -44,6 +44,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <random>
+#include <cstdint>
 
 #include <MCLS_config.hpp>
 #include <MCLS_ForwardHistory.hpp>
@@ -148,7 +149,8 @@ UNIT_TEST_INSTANTIATION( ForwardHistory, history )
 //---------------------------------------------------------------------------//
 TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( ForwardHistory, pack_unpack, Ordinal )
 {
-    std::size_t byte_size = 2*sizeof(Ordinal) + 2*sizeof(double) + 3*sizeof(int);
+    std::size_t byte_size = 
+	2*sizeof(Ordinal) + 2*sizeof(double) + sizeof(std::int32_t);
     MCLS::ForwardHistory<Ordinal>::setByteSize();
     std::size_t packed_bytes =
 	MCLS::ForwardHistory<Ordinal>::getPackedBytes();
@@ -168,7 +170,7 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( ForwardHistory, pack_unpack, Ordinal )
     TEST_EQUALITY( h_2.globalState(), 5 );
     TEST_EQUALITY( h_2.localState(), Teuchos::OrdinalTraits<Ordinal>::invalid() );
     TEST_EQUALITY( h_2.startingState(), 5 );
-    TEST_ASSERT( h_2.alive() );
+    TEST_ASSERT( !h_2.alive() );
     TEST_EQUALITY( h_2.event(), MCLS::Event::BOUNDARY );
     TEST_EQUALITY( h_2.historyTally(), 2.44 );
     TEST_EQUALITY( h_2.numSteps(), 1 );
@@ -205,7 +207,7 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( ForwardHistory, broadcast, Ordinal )
     TEST_EQUALITY( h_2.globalState(), 5 );
     TEST_EQUALITY( h_2.localState(), Teuchos::OrdinalTraits<Ordinal>::invalid() );
     TEST_EQUALITY( h_2.startingState(), 5 );
-    TEST_ASSERT( h_2.alive() );
+    TEST_ASSERT( !h_2.alive() );
     TEST_EQUALITY( h_2.event(), MCLS::Event::BOUNDARY );
     TEST_EQUALITY( h_2.historyTally(), 1.98 );
     TEST_EQUALITY( h_2.numSteps(), 1 );
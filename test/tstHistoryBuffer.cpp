@@ -45,6 +45,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <random>
+#include <cstdint>
 
 #include <MCLS_config.hpp>
 #include <MCLS_AdjointHistory.hpp>
@@ -100,7 +101,7 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( HistoryBuffer, sizes, Ordinal )
     MCLS::HistoryBuffer<HT>::setMaxNumHistories( 10 );
     TEST_EQUALITY( MCLS::HistoryBuffer<HT>::maxNum(), 10 );
     TEST_EQUALITY( MCLS::HistoryBuffer<HT>::sizePackedHistory(),
-		   sizeof(double)+sizeof(Ordinal)+3*sizeof(int) );
+		   sizeof(double)+sizeof(Ordinal)+sizeof(std::int32_t) );
 
     MCLS::HistoryBuffer<HT> buffer_2;
     TEST_EQUALITY( buffer_2.allocatedSize(), 0 );
@@ -122,7 +123,7 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( HistoryBuffer, sizes, Ordinal )
 
     TEST_EQUALITY( MCLS::HistoryBuffer<HT>::maxNum(), 10 );
     TEST_EQUALITY( MCLS::HistoryBuffer<HT>::sizePackedHistory(),
-		   sizeof(double) + sizeof(Ordinal) + 3*sizeof(int));
+		   sizeof(double) + sizeof(Ordinal) + sizeof(std::int32_t));
 }
 
 UNIT_TEST_INSTANTIATION( HistoryBuffer, sizes )
@@ -137,7 +138,7 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( HistoryBuffer, buffering, Ordinal )
     MCLS::HistoryBuffer<HT> buffer( HT::getPackedBytes(), num_history );
     TEST_EQUALITY( MCLS::HistoryBuffer<HT>::maxNum(), 4 );
     TEST_EQUALITY( MCLS::HistoryBuffer<HT>::sizePackedHistory(),
-		   sizeof(double)+sizeof(Ordinal)+3*sizeof(int) );
+		   sizeof(double)+sizeof(Ordinal)+sizeof(std::int32_t) );
 
     TEST_EQUALITY( buffer.allocatedSize(),
 		   num_history*MCLS::HistoryBuffer<HT>::sizePackedHistory() 
@@ -206,6 +207,49 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( HistoryBuffer, buffering, Ordinal )
 
 UNIT_TEST_INSTANTIATION( HistoryBuffer, buffering )
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( HistoryBuffer, capacity, Ordinal )
+{
+    typedef MCLS::AdjointHistory<Ordinal> HT;
+    HT::setByteSize();
+
+    int num_history = 4;
+    MCLS::HistoryBuffer<HT> buffer( HT::getPackedBytes(), num_history );
+    TEST_EQUALITY( buffer.capacity(), 4 );
+    TEST_EQUALITY( buffer.messageSize(), sizeof(int) );
+
+    buffer.setCapacity( 2 );
+    TEST_EQUALITY( buffer.capacity(), 2 );
+    TEST_EQUALITY( buffer.allocatedSize(),
+		   num_history*MCLS::HistoryBuffer<HT>::sizePackedHistory() 
+		   + sizeof(int) );
+
+    HT h1( 1, 1, 1 );
+    HT h2( 2, 2, 2 );
+
+    buffer.bufferHistory( h1 );
+    TEST_ASSERT( !buffer.isFull() );
+    TEST_EQUALITY( buffer.messageSize(), 
+		   sizeof(int) + MCLS::HistoryBuffer<HT>::sizePackedHistory() );
+
+    buffer.bufferHistory( h2 );
+    TEST_ASSERT( buffer.isFull() );
+    TEST_EQUALITY( buffer.messageSize(), 
+		   sizeof(int) + 2*MCLS::HistoryBuffer<HT>::sizePackedHistory() );
+
+    std::stack<HT> bank;
+    buffer.addToBank( bank );
+    TEST_EQUALITY( bank.size(), 2 );
+    TEST_EQUALITY( bank.top().globalState(), 2 );
+    TEST_ASSERT( buffer.isEmpty() );
+    TEST_EQUALITY( buffer.capacity(), 2 );
+
+    buffer.setCapacity( 4 );
+    TEST_EQUALITY( buffer.capacity(), 4 );
+}
+
+UNIT_TEST_INSTANTIATION( HistoryBuffer, capacity )
+
 //---------------------------------------------------------------------------//
 // end tstHistoryBuffer.cpp
 //---------------------------------------------------------------------------//
@@ -45,8 +45,11 @@
 #include <sstream>
 #include <stdexcept>
 
+#include <MCLS_config.hpp>
 #include <MCLS_PRNG.hpp>
 #include <MCLS_Xorshift.hpp>
+#include <MCLS_Philox.hpp>
+#include <MCLS_ThreadTools.hpp>
 
 #include "Teuchos_UnitTestHarness.hpp"
 #include "Teuchos_RCP.hpp"
@@ -111,13 +114,231 @@ TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PRNG, prng_test, RNG )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PRNG, thread_test, RNG )
+{
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = getDefaultComm<int>();
+    
+    MCLS::PRNG<RNG> prng( comm->getRank() );
+    
+    // Make a set of random numbers on each thread.
+    int num_threads = MCLS::ThreadTools::maxThreads();
+    int num_random = 1000;
+    Teuchos::Array<double> rands( num_random * num_threads, 0.0 );
+    std::uniform_real_distribution<double> rand_dist(0.0,1.0);
+
+#if HAVE_MCLS_OPENMP
+#pragma omp parallel num_threads(num_threads)
+#endif
+    {
+	int thread_id = MCLS::ThreadTools::threadId();
+	for ( int i = 0; i < num_random; ++i )
+	{
+	    rands[thread_id*num_random + i] = prng.random( rand_dist );
+	}
+    }
+
+    // Check that the random numbers on each thread are unique.
+    for ( int i = 0; i < num_threads; ++i )
+    {
+	for ( int j = 0; j < num_threads; ++j )
+	{
+	    if ( i != j )
+	    {
+		for ( int k = 0; k < num_random; ++k )
+		{
+		    TEST_INEQUALITY( rands[i*num_random + k],
+				     rands[j*num_random + k] );
+		}
+	    }
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PRNG, reproducible_test, RNG )
+{
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = getDefaultComm<int>();
+    
+    // Make two generators with the same seed.
+    std::size_t seed = 2394723;
+    MCLS::PRNG<RNG> prng_1( comm->getRank(), seed );
+    MCLS::PRNG<RNG> prng_2( comm->getRank(), seed );
+    TEST_ASSERT( prng_1.reproducible() );
+    TEST_EQUALITY( prng_1.seed(), seed );
+
+    // Check that they produce the same sequence.
+    int num_random = 1000;
+    std::uniform_real_distribution<double> rand_dist(0.0,1.0);
+    for ( int i = 0; i < num_random; ++i )
+    {
+	TEST_EQUALITY( prng_1.random(rand_dist), prng_2.random(rand_dist) );
+    }
+
+    // Check that a history substream only depends on the history id and
+    // the history stream and not on the state of the generator.
+    prng_1.beginStep( 7, 0 );
+    prng_1.beginStep( 2, 0 );
+    double history_2_val = prng_1.random( rand_dist );
+    for ( int i = 0; i < num_random; ++i )
+    {
+	prng_2.random( rand_dist );
+    }
+    prng_2.beginStep( 1, 0 );
+    double history_1_val = prng_2.random( rand_dist );
+    prng_2.beginStep( 2, 0 );
+    TEST_EQUALITY( prng_2.random(rand_dist), history_2_val );
+    TEST_INEQUALITY( history_1_val, history_2_val );
+
+    // A generator on another rank with the same history stream gives the
+    // same history sequence.
+    MCLS::PRNG<RNG> prng_3( comm->getRank() + 1, seed );
+    prng_3.setHistoryStream( prng_1.historyStream() );
+    prng_3.beginStep( 2, 0 );
+    TEST_EQUALITY( prng_3.random(rand_dist), history_2_val );
+
+    // A different history stream gives a different sequence.
+    prng_3.setHistoryStream( prng_1.historyStream() + 1 );
+    prng_3.beginStep( 2, 0 );
+    TEST_INEQUALITY( prng_3.random(rand_dist), history_2_val );
+
+    // The same history id gives a different sequence in the next solve and
+    // the same sequence when the solve is repeated.
+    TEST_ASSERT( 0 == prng_1.solve() );
+    prng_1.setSolve( 1 );
+    prng_1.beginStep( 2, 0 );
+    double solve_1_val = prng_1.random( rand_dist );
+    TEST_INEQUALITY( solve_1_val, history_2_val );
+    prng_1.setSolve( 0 );
+    prng_1.beginStep( 2, 0 );
+    TEST_EQUALITY( prng_1.random(rand_dist), history_2_val );
+    prng_2.setSolve( 1 );
+    prng_2.beginStep( 2, 0 );
+    TEST_EQUALITY( prng_2.random(rand_dist), solve_1_val );
+
+    // A step of a history gives the same sequence regardless of the state
+    // of the generator and differs from the first step.
+    prng_1.beginStep( 2, 3 );
+    double step_3_val = prng_1.uniform();
+    TEST_INEQUALITY( step_3_val, prng_1.uniform() );
+    prng_2.setSolve( 0 );
+    prng_2.beginStep( 7, 0 );
+    prng_2.uniform();
+    prng_2.beginStep( 2, 3 );
+    TEST_EQUALITY( prng_2.uniform(), step_3_val );
+    prng_2.beginStep( 2, 0 );
+    TEST_INEQUALITY( prng_2.uniform(), step_3_val );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( Philox, known_answer )
+{
+    // Philox4x32-10 known answer test from the Random123 distribution. The
+    // zero counter encrypted with the zero key gives the words 0x6627e8d5,
+    // 0xe169c58d, 0xbc57ac4c, and 0x9b00dbd8. Block 0 of stream 0 and
+    // substream 0 is the zero counter.
+    MCLS::Philox philox( 0 );
+    TEST_EQUALITY( philox(), 0x6627e8d5e169c58dULL );
+    TEST_EQUALITY( philox(), 0xbc57ac4c9b00dbd8ULL );
+
+    // Rekeying restarts the sequence.
+    philox.seed( 0 );
+    TEST_EQUALITY( philox(), 0x6627e8d5e169c58dULL );
+
+    // The next block uses the next counter and differs from the first.
+    philox.setStream( 0, 0 );
+    philox();
+    philox();
+    TEST_INEQUALITY( philox(), 0x6627e8d5e169c58dULL );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( Philox, offset )
+{
+    // Setting an offset in a substream gives the same numbers as drawing
+    // from the beginning of the substream for even and odd offsets.
+    MCLS::Philox philox( 2394723 );
+    philox.setStream( 3, 5 );
+    int num_random = 9;
+    Teuchos::Array<MCLS::Philox::result_type> sequence( num_random );
+    for ( int i = 0; i < num_random; ++i )
+    {
+	sequence[i] = philox();
+    }
+    for ( int offset = 0; offset < num_random; ++offset )
+    {
+	philox.setStream( 3, 5, offset );
+	for ( int i = offset; i < num_random; ++i )
+	{
+	    TEST_EQUALITY( philox(), sequence[i] );
+	}
+    }
+
+    // The traits key the same position.
+    MCLS::Philox philox_2( 0 );
+    MCLS::RNGTraits<MCLS::Philox>::setStream( philox_2, 2394723, 3, 5, 4 );
+    TEST_EQUALITY( philox_2(), sequence[4] );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST_TEMPLATE_1_DECL( PRNG, fill_test, RNG )
+{
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = getDefaultComm<int>();
+    
+    // Fill a block of random numbers with a length that is not a multiple
+    // of the internal block size.
+    std::size_t seed = 2394723;
+    MCLS::PRNG<RNG> prng_1( comm->getRank(), seed );
+    int num_random = 1001;
+    Teuchos::Array<double> rands( num_random, -1.0 );
+    prng_1.fill( rands.getRawPtr(), num_random );
+
+    // Check the bounds and the mean.
+    double mean = 0.0;
+    for ( int i = 0; i < num_random; ++i )
+    {
+	TEST_ASSERT( rands[i] >= 0.0 );
+	TEST_ASSERT( rands[i] < 1.0 );
+	mean += rands[i];
+    }
+    mean /= num_random;
+    TEST_FLOATING_EQUALITY( mean, 0.5, 0.1 );
+
+    // Check that filling in pieces gives the same sequence.
+    MCLS::PRNG<RNG> prng_2( comm->getRank(), seed );
+    Teuchos::Array<double> rands_2( num_random, -1.0 );
+    prng_2.fill( rands_2.getRawPtr(), 100 );
+    prng_2.fill( rands_2.getRawPtr() + 100, num_random - 100 );
+    TEST_COMPARE_ARRAYS( rands, rands_2 );
+
+    // Check that single uniform draws give the same sequence.
+    MCLS::PRNG<RNG> prng_3( comm->getRank(), seed );
+    for ( int i = 0; i < num_random; ++i )
+    {
+	TEST_EQUALITY( prng_3.uniform(), rands[i] );
+    }
+}
+
+//---------------------------------------------------------------------------//
 typedef std::mt19937 mt19937;
 typedef std::mt19937_64 mt1993764;
 typedef MCLS::Xorshift<> Xorshift;
+typedef MCLS::Philox Philox;
 
 TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, prng_test, mt19937 )
 TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, prng_test, mt1993764 )
 TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, prng_test, Xorshift )
+TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, prng_test, Philox )
+TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, thread_test, mt19937 )
+TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, thread_test, mt1993764 )
+TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, thread_test, Xorshift )
+TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, thread_test, Philox )
+TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, reproducible_test, mt19937 )
+TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, reproducible_test, Xorshift )
+TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, reproducible_test, Philox )
+TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, fill_test, mt19937 )
+TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, fill_test, Xorshift )
+TEUCHOS_UNIT_TEST_TEMPLATE_1_INSTANT( PRNG, fill_test, Philox )
 
 //---------------------------------------------------------------------------//
 // end tstPRNG.cpp
@@ -0,0 +1,106 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2012, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the University of Wisconsin - Madison nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   tstSampleRatioController.cpp
+ * \author Stuart Slattery
+ * \brief  SampleRatioController class unit tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <cmath>
+
+#include <MCLS_config.hpp>
+#include <MCLS_SampleRatioController.hpp>
+
+#include <Teuchos_UnitTestHarness.hpp>
+#include <Teuchos_Array.hpp>
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SampleRatioController, direction )
+{
+    MCLS::SampleRatioController controller( 1.0, 0.25, 4.0, 2.0, 1.0 );
+    TEST_EQUALITY( controller.sampleRatio(), 1.0 );
+
+    // The first step reduces the ratio.
+    TEST_EQUALITY( controller.update(0.5, 1.0), 0.5 );
+
+    // The efficiency improved so keep reducing.
+    TEST_EQUALITY( controller.update(0.125, 1.0), 0.25 );
+
+    // The efficiency dropped so reverse.
+    TEST_EQUALITY( controller.update(0.0625, 1.0), 0.5 );
+
+    // The same reduction in more time is less efficient. Reverse again.
+    TEST_EQUALITY( controller.update(0.03125, 2.0), 0.25 );
+
+    // No reduction is less efficient. Reverse again.
+    TEST_EQUALITY( controller.update(0.03125, 1.0), 0.5 );
+
+    // A zero residual cannot be measured and keeps the ratio.
+    TEST_EQUALITY( controller.update(0.0, 1.0), 0.5 );
+    TEST_EQUALITY( controller.sampleRatio(), 0.5 );
+
+    Teuchos::Array<double> trace = controller.trace();
+    TEST_EQUALITY( trace.size(), 7 );
+    TEST_EQUALITY( trace[0], 1.0 );
+    TEST_EQUALITY( trace[1], 0.5 );
+    TEST_EQUALITY( trace[2], 0.25 );
+    TEST_EQUALITY( trace[3], 0.5 );
+    TEST_EQUALITY( trace[4], 0.25 );
+    TEST_EQUALITY( trace[5], 0.5 );
+    TEST_EQUALITY( trace[6], 0.5 );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SampleRatioController, bounds )
+{
+    MCLS::SampleRatioController controller( 1.0, 0.5, 2.0, 2.0, 1.0 );
+
+    // Reduce to the lower bound and stay there while improving.
+    TEST_EQUALITY( controller.update(0.5, 1.0), 0.5 );
+    TEST_EQUALITY( controller.update(0.125, 1.0), 0.5 );
+
+    // Reverse up to the upper bound and stay there while improving.
+    TEST_EQUALITY( controller.update(0.0625, 1.0), 1.0 );
+    TEST_EQUALITY( controller.update(0.03125, 1.0), 2.0 );
+    TEST_EQUALITY( controller.update(0.015625, 1.0), 2.0 );
+}
+
+//---------------------------------------------------------------------------//
+// end tstSampleRatioController.cpp
+//---------------------------------------------------------------------------//
+
@@ -100,6 +100,69 @@ TEUCHOS_UNIT_TEST( SamplingTools, one_bin )
     TEST_EQUALITY( 0, MCLS::SamplingTools::sampleDiscreteCDF( cdf.getRawPtr(), cdf.size(), 1.00 ) );
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SamplingTools, alias_table )
+{
+    Teuchos::Array<double> pdf( 5, 0.0 );
+    pdf[0] = 0.13;
+    pdf[1] = 0.14;
+    pdf[2] = 0.17;
+    pdf[3] = 0.25;
+    pdf[4] = 0.31;
+
+    Teuchos::Array<double> probabilities( pdf.size() );
+    Teuchos::Array<int> aliases( pdf.size() );
+    MCLS::SamplingTools::buildAliasTable( pdf.getRawPtr(), pdf.size(),
+					  probabilities.getRawPtr(),
+					  aliases.getRawPtr() );
+
+    // Reconstruct the PDF from the table.
+    Teuchos::Array<double> table_pdf( pdf.size(), 0.0 );
+    for ( int i = 0; i < pdf.size(); ++i )
+    {
+	TEST_ASSERT( probabilities[i] >= 0.0 && probabilities[i] <= 1.0 );
+	TEST_ASSERT( aliases[i] >= 0 && aliases[i] < pdf.size() );
+	table_pdf[i] += probabilities[i] / pdf.size();
+	table_pdf[aliases[i]] += (1.0 - probabilities[i]) / pdf.size();
+    }
+    TEST_COMPARE_FLOATING_ARRAYS( table_pdf, pdf, 1.0e-12 );
+
+    // Sample the table.
+    int size = pdf.size();
+    for ( int i = 0; i < size; ++i )
+    {
+	TEST_EQUALITY( i, MCLS::SamplingTools::sampleAliasTable( 
+			   probabilities.getRawPtr(), aliases.getRawPtr(), size,
+			   (i + 0.5*probabilities[i]) / size ) );
+	if ( probabilities[i] < 1.0 )
+	{
+	    TEST_EQUALITY( aliases[i], MCLS::SamplingTools::sampleAliasTable( 
+			       probabilities.getRawPtr(), aliases.getRawPtr(), 
+			       size, (i + 0.5*(1.0+probabilities[i])) / size ) );
+	}
+    }
+    TEST_ASSERT( MCLS::SamplingTools::sampleAliasTable( 
+		     probabilities.getRawPtr(), aliases.getRawPtr(), 
+		     size, 1.0 ) < size );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SamplingTools, alias_one_bin )
+{
+    Teuchos::Array<double> pdf( 1, 2.5 );
+    Teuchos::Array<double> probabilities( 1 );
+    Teuchos::Array<int> aliases( 1 );
+    MCLS::SamplingTools::buildAliasTable( pdf.getRawPtr(), pdf.size(),
+					  probabilities.getRawPtr(),
+					  aliases.getRawPtr() );
+    TEST_EQUALITY( 1.0, probabilities[0] );
+    TEST_EQUALITY( 0, aliases[0] );
+    TEST_EQUALITY( 0, MCLS::SamplingTools::sampleAliasTable( 
+		       probabilities.getRawPtr(), aliases.getRawPtr(), 1, 0.13 ) );
+    TEST_EQUALITY( 0, MCLS::SamplingTools::sampleAliasTable( 
+		       probabilities.getRawPtr(), aliases.getRawPtr(), 1, 1.00 ) );
+}
+
 //---------------------------------------------------------------------------//
 // end tstSamplingTools.cpp
 //---------------------------------------------------------------------------//
@@ -0,0 +1,127 @@
+//---------------------------------------------------------------------------//
+/*
+  Copyright (c) 2012, Stuart R. Slattery
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  *: Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  *: Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  *: Neither the name of the University of Wisconsin - Madison nor the
+  names of its contributors may be used to endorse or promote products
+  derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//---------------------------------------------------------------------------//
+/*!
+ * \file   tstStateIndexer.cpp
+ * \author Stuart Slattery
+ * \brief  StateIndexer class unit tests.
+ */
+//---------------------------------------------------------------------------//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include <MCLS_config.hpp>
+#include <MCLS_StateIndexer.hpp>
+
+#include <Teuchos_UnitTestHarness.hpp>
+#include <Teuchos_Array.hpp>
+#include <Teuchos_OrdinalTraits.hpp>
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( StateIndexer, contiguous )
+{
+    int num_states = 10;
+    long offset = 4567;
+    Teuchos::Array<long> states( num_states );
+    Teuchos::Array<int> ids( num_states );
+    for ( int i = 0; i < num_states; ++i )
+    {
+	states[i] = offset + num_states - i - 1;
+	ids[i] = i;
+    }
+
+    MCLS::StateIndexer<long> indexer;
+    indexer.build( states(), ids() );
+    TEST_ASSERT( indexer.isDense() );
+    TEST_EQUALITY( num_states, indexer.size() );
+
+    for ( int i = 0; i < num_states; ++i )
+    {
+	TEST_ASSERT( indexer.contains(states[i]) );
+	TEST_EQUALITY( ids[i], indexer.find(states[i]) );
+    }
+    TEST_ASSERT( !indexer.contains(offset-1) );
+    TEST_ASSERT( !indexer.contains(offset+num_states) );
+    TEST_EQUALITY( Teuchos::OrdinalTraits<int>::invalid(),
+		   indexer.find(0) );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( StateIndexer, sparse )
+{
+    int num_states = 10;
+    Teuchos::Array<long> states( num_states );
+    Teuchos::Array<int> ids( num_states );
+    for ( int i = 0; i < num_states; ++i )
+    {
+	states[i] = 1000*(num_states - i);
+	ids[i] = 2*i;
+    }
+
+    MCLS::StateIndexer<long> indexer;
+    indexer.build( states(), ids() );
+    TEST_ASSERT( !indexer.isDense() );
+    TEST_EQUALITY( num_states, indexer.size() );
+
+    for ( int i = 0; i < num_states; ++i )
+    {
+	TEST_ASSERT( indexer.contains(states[i]) );
+	TEST_EQUALITY( ids[i], indexer.find(states[i]) );
+	TEST_ASSERT( !indexer.contains(states[i]+1) );
+    }
+    TEST_ASSERT( !indexer.contains(0) );
+    TEST_ASSERT( !indexer.contains(1000*(num_states+1)) );
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( StateIndexer, empty )
+{
+    Teuchos::Array<long> states;
+    Teuchos::Array<int> ids;
+
+    MCLS::StateIndexer<long> indexer;
+    indexer.build( states(), ids() );
+    TEST_EQUALITY( 0, indexer.size() );
+    TEST_ASSERT( !indexer.contains(0) );
+    TEST_ASSERT( !indexer.contains(1) );
+}
+
+//---------------------------------------------------------------------------//
+// end tstStateIndexer.cpp
+//---------------------------------------------------------------------------//
@@ -424,72 +424,82 @@ class MatrixTraits<Tpetra::Vector<Scalar,LO,GO>, Tpetra::CrsMatrix<Scalar,LO,GO>
     /*
      * \brief Create a reference-counted pointer to a new matrix with a
      * specified number of off-process nearest-neighbor global rows.
+     *
+     * The graph is traversed one level at a time. Only the rows new to each
+     * level are imported to find the next level and the rows already found
+     * are removed with a sorted set difference. All neighbor rows are
+     * imported together once the traversal is complete.
      */
     static Teuchos::RCP<matrix_type> copyNearestNeighbors( 
     	const matrix_type& matrix, const GO& num_neighbors )
     { 
 	MCLS_REQUIRE( num_neighbors >= 0 ); 
 
-	// Setup for neighbor construction.
-	Teuchos::RCP<const Tpetra::Map<LO,GO> > empty_map = 
-	    Tpetra::createUniformContigMap<LO,GO>( 
-		0, matrix.getComm() );
-	Teuchos::RCP<matrix_type> neighbor_matrix = 
-	    Tpetra::createCrsMatrix<Scalar,LO,GO>( empty_map );
-	neighbor_matrix->fillComplete();
+	// The sorted global rows already found. These are the local rows of
+	// the matrix and the neighbor rows.
+	Teuchos::ArrayView<const GO> local_rows = 
+	    matrix.getRowMap()->getNodeElementList();
+	Teuchos::Array<GO> found_rows( local_rows.begin(), local_rows.end() );
+	std::sort( found_rows.begin(), found_rows.end() );
 
-	Teuchos::ArrayView<const GO> global_rows;
-	typename Teuchos::ArrayView<const GO>::const_iterator global_rows_it;
-	typename Teuchos::Array<GO>::iterator ghost_global_bound;
+	// The sorted neighbor rows.
+	Teuchos::Array<GO> neighbor_rows;
 
-	// Get the initial off proc columns.
-	Teuchos::Array<GO> ghost_global_rows =
-	    TMH::getOffProcColsAsRows( matrix );
+	// Get the initial off proc columns. These are the first level.
+	Teuchos::Array<GO> level_rows = TMH::getOffProcColsAsRows( matrix );
+	Teuchos::Array<GO> work;
+	typename Teuchos::Array<GO>::iterator work_end;
 
 	// Build the neighbors by traversing the graph.
 	for ( GO i = 0; i < num_neighbors; ++i )
 	{
-	    // Get rid of the global rows that belong to the original
-	    // matrix. We don't need to store these, just the neighbors.
-	    global_rows = matrix.getRowMap()->getNodeElementList();
-	    for ( global_rows_it = global_rows.begin();
-		  global_rows_it != global_rows.end();
-		  ++global_rows_it )
-	    {
-		ghost_global_bound = std::remove( ghost_global_rows.begin(), 
-						  ghost_global_rows.end(), 
-						  *global_rows_it );
-		ghost_global_rows.resize( std::distance(ghost_global_rows.begin(),
-							ghost_global_bound) );
-	    }
-
-	    // Get the current set of global rows in the neighbor matrix. 
-	    global_rows = neighbor_matrix->getRowMap()->getNodeElementList();
-
-	    // Append the on proc neighbor columns to the off proc columns.
-	    for ( global_rows_it = global_rows.begin();
-		  global_rows_it != global_rows.end();
-		  ++global_rows_it )
+	    // Get rid of the rows that have already been found. We only need
+	    // the new rows in this level.
+	    std::sort( level_rows.begin(), level_rows.end() );
+	    work.resize( level_rows.size() );
+	    work_end = std::set_difference( level_rows.begin(), 
+					    level_rows.end(),
+					    found_rows.begin(), 
+					    found_rows.end(),
+					    work.begin() );
+	    work_end = std::unique( work.begin(), work_end );
+	    work.resize( std::distance(work.begin(),work_end) );
+	    level_rows.swap( work );
+
+	    // Add the new rows to the found rows and the neighbor rows.
+	    work.resize( found_rows.size() + level_rows.size() );
+	    std::merge( found_rows.begin(), found_rows.end(),
+			level_rows.begin(), level_rows.end(),
+			work.begin() );
+	    found_rows.swap( work );
+	    work.resize( neighbor_rows.size() + level_rows.size() );
+	    std::merge( neighbor_rows.begin(), neighbor_rows.end(),
+			level_rows.begin(), level_rows.end(),
+			work.begin() );
+	    neighbor_rows.swap( work );
+
+	    // Import only the new rows to get the next level in the graph.
+	    if ( i + 1 < num_neighbors )
 	    {
-		ghost_global_rows.push_back( *global_rows_it );
+		Teuchos::RCP<const Tpetra::Map<LO,GO> > level_map = 
+		    Tpetra::createNonContigMap<LO,GO>( 
+			level_rows(), matrix.getComm() );
+		Tpetra::Import<LO,GO> level_importer( 
+		    matrix.getRowMap(), level_map );
+		level_rows = TMH::getOffProcColsAsRows( 
+		    *TMH::importAndFillCompleteMatrix(matrix, level_importer) );
 	    }
-	
-	    // Make a new map of the combined global rows and off proc columns.
-	    Teuchos::RCP<const Tpetra::Map<LO,GO> > ghost_map = 
-		Tpetra::createNonContigMap<LO,GO>( 
-		    ghost_global_rows(), neighbor_matrix->getComm() );
-
-	    // Import the neighbor matrix with the new neighbor.
-	    Tpetra::Import<LO,GO> ghost_importer( 
-		matrix.getRowMap(), ghost_map );
-
-	    neighbor_matrix = 
-		TMH::importAndFillCompleteMatrix( matrix, ghost_importer );
-
-	    // Get the next rows in the graph.
-	    ghost_global_rows = TMH::getOffProcColsAsRows( *neighbor_matrix );
 	}
 
+	// Import all of the neighbor rows.
+	Teuchos::RCP<const Tpetra::Map<LO,GO> > neighbor_map = 
+	    Tpetra::createNonContigMap<LO,GO>( 
+		neighbor_rows(), matrix.getComm() );
+	Tpetra::Import<LO,GO> neighbor_importer( 
+	    matrix.getRowMap(), neighbor_map );
+	Teuchos::RCP<matrix_type> neighbor_matrix = 
+	    TMH::importAndFillCompleteMatrix( matrix, neighbor_importer );
+
 	MCLS_ENSURE( !neighbor_matrix.is_null() );
 	MCLS_ENSURE( neighbor_matrix->isFillComplete() );
 	return neighbor_matrix;
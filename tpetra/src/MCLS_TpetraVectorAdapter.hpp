@@ -45,12 +45,16 @@
 #include <MCLS_VectorTraits.hpp>
 
 #include <Teuchos_Comm.hpp>
+#include <Teuchos_CommHelpers.hpp>
+#include <Teuchos_Array.hpp>
 #include <Teuchos_as.hpp>
 
 #include <Tpetra_Vector.hpp>
 #include <Tpetra_MultiVector.hpp>
 #include <Tpetra_Map.hpp>
 
+#include <cmath>
+
 namespace MCLS
 {
 
@@ -371,6 +375,143 @@ class VectorTraits<Tpetra::Vector<Scalar,LO,GO> >
     { 
 	A.elementWiseMultiply( beta, B, C, alpha );
     }
+
+    /*!
+     * \brief Update vector with A = alpha*A + beta*B and return the 2-norm
+     * of the updated vector. The update and norm are computed in a single
+     * pass over the vectors.
+     */
+    static typename Teuchos::ScalarTraits<scalar_type>::magnitudeType 
+    updateNorm2( vector_type& A, const scalar_type& alpha,
+		 const vector_type& B, const scalar_type& beta )
+    {
+	MCLS_REQUIRE( A.getLocalLength() == B.getLocalLength() );
+
+	Teuchos::ArrayRCP<scalar_type> A_view = A.getDataNonConst();
+	Teuchos::ArrayRCP<const scalar_type> B_view = B.getData();
+	typename Teuchos::ScalarTraits<scalar_type>::magnitudeType 
+	    local_norm = 0.0;
+	typename Teuchos::ScalarTraits<scalar_type>::magnitudeType a = 0.0;
+	int local_length = A_view.size();
+	for ( int i = 0; i < local_length; ++i )
+	{
+	    A_view[i] = alpha*A_view[i] + beta*B_view[i];
+	    a = Teuchos::ScalarTraits<scalar_type>::magnitude( A_view[i] );
+	    local_norm += a*a;
+	}
+
+	typename Teuchos::ScalarTraits<scalar_type>::magnitudeType 
+	    global_norm = 0.0;
+	Teuchos::reduceAll( *A.getMap()->getComm(), Teuchos::REDUCE_SUM,
+			    local_norm, Teuchos::ptrFromRef(global_norm) );
+	return std::sqrt( global_norm );
+    }
+
+    /*!
+     * \brief Update two vectors with A = A + alpha*B and B = B - alpha*C in
+     * a single pass over the vectors.
+     */
+    static void updatePair( vector_type& A, vector_type& B, 
+			    const vector_type& C, const scalar_type& alpha )
+    {
+	MCLS_REQUIRE( A.getLocalLength() == B.getLocalLength() );
+	MCLS_REQUIRE( A.getLocalLength() == C.getLocalLength() );
+
+	Teuchos::ArrayRCP<scalar_type> A_view = A.getDataNonConst();
+	Teuchos::ArrayRCP<scalar_type> B_view = B.getDataNonConst();
+	Teuchos::ArrayRCP<const scalar_type> C_view = C.getData();
+	int local_length = A_view.size();
+	for ( int i = 0; i < local_length; ++i )
+	{
+	    A_view[i] += alpha*B_view[i];
+	    B_view[i] -= alpha*C_view[i];
+	}
+    }
+
+    /*!
+     * \brief Compute the dot products A \dot B and A \dot C in a single
+     * pass over the vectors with a single global reduction.
+     */
+    static void dotPair( const vector_type& A, 
+			 const vector_type& B, 
+			 const vector_type& C,
+			 scalar_type& A_dot_B, 
+			 scalar_type& A_dot_C )
+    {
+	MCLS_REQUIRE( A.getLocalLength() == B.getLocalLength() );
+	MCLS_REQUIRE( A.getLocalLength() == C.getLocalLength() );
+
+	Teuchos::ArrayRCP<const scalar_type> A_view = A.getData();
+	Teuchos::ArrayRCP<const scalar_type> B_view = B.getData();
+	Teuchos::ArrayRCP<const scalar_type> C_view = C.getData();
+	Teuchos::Array<scalar_type> local_dots( 2, 0.0 );
+	int local_length = A_view.size();
+	for ( int i = 0; i < local_length; ++i )
+	{
+	    local_dots[0] += 
+		Teuchos::ScalarTraits<scalar_type>::conjugate(B_view[i]) * 
+		A_view[i];
+	    local_dots[1] += 
+		Teuchos::ScalarTraits<scalar_type>::conjugate(C_view[i]) * 
+		A_view[i];
+	}
+
+	Teuchos::Array<scalar_type> global_dots( 2, 0.0 );
+	Teuchos::reduceAll( *A.getMap()->getComm(), Teuchos::REDUCE_SUM, 2,
+			    local_dots.getRawPtr(), global_dots.getRawPtr() );
+	A_dot_B = global_dots[0];
+	A_dot_C = global_dots[1];
+    }
+
+    /*!
+     * \brief Compute the squared 2-norm of the local components of the
+     * vector without a global reduction.
+     */
+    static typename Teuchos::ScalarTraits<scalar_type>::magnitudeType 
+    localNorm2Squared( const vector_type& vector )
+    {
+	Teuchos::ArrayRCP<const scalar_type> view = vector.getData();
+	typename Teuchos::ScalarTraits<scalar_type>::magnitudeType 
+	    local_norm = 0.0;
+	typename Teuchos::ScalarTraits<scalar_type>::magnitudeType a = 0.0;
+	int local_length = view.size();
+	for ( int i = 0; i < local_length; ++i )
+	{
+	    a = Teuchos::ScalarTraits<scalar_type>::magnitude( view[i] );
+	    local_norm += a*a;
+	}
+	return local_norm;
+    }
+
+    /*!
+     * \brief Compute the sum of the components of A and the squared 2-norm
+     * of B in a single pass over the vectors with a single global reduction.
+     */
+    static void sumAndNorm2Squared( const vector_type& A, 
+				    const vector_type& B,
+				    scalar_type& A_sum, 
+				    scalar_type& B_norm2_squared )
+    {
+	MCLS_REQUIRE( A.getLocalLength() == B.getLocalLength() );
+
+	Teuchos::ArrayRCP<const scalar_type> A_view = A.getData();
+	Teuchos::ArrayRCP<const scalar_type> B_view = B.getData();
+	Teuchos::Array<scalar_type> local_sums( 2, 0.0 );
+	typename Teuchos::ScalarTraits<scalar_type>::magnitudeType b = 0.0;
+	int local_length = A_view.size();
+	for ( int i = 0; i < local_length; ++i )
+	{
+	    local_sums[0] += A_view[i];
+	    b = Teuchos::ScalarTraits<scalar_type>::magnitude( B_view[i] );
+	    local_sums[1] += b*b;
+	}
+
+	Teuchos::Array<scalar_type> global_sums( 2, 0.0 );
+	Teuchos::reduceAll( *A.getMap()->getComm(), Teuchos::REDUCE_SUM, 2,
+			    local_sums.getRawPtr(), global_sums.getRawPtr() );
+	A_sum = global_sums[0];
+	B_norm2_squared = global_sums[1];
+    }
 };
 
 //---------------------------------------------------------------------------//
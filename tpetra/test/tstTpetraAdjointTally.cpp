@@ -47,7 +47,9 @@
 #include <string>
 #include <cassert>
 
+#include <MCLS_config.hpp>
 #include <MCLS_AdjointTally.hpp>
+#include <MCLS_ThreadTools.hpp>
 #include <MCLS_VectorTraits.hpp>
 #include <MCLS_TpetraAdapter.hpp>
 #include <MCLS_AdjointHistory.hpp>
@@ -125,6 +127,63 @@ TEUCHOS_UNIT_TEST( AdjointTally, TallyHistory )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AdjointTally, ThreadFinalize )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef MCLS::AdjointHistory<long> HistoryType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map_a = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    Teuchos::ArrayView<const long> tally_rows = map_a->getNodeElementList();
+    int num_threads = MCLS::ThreadTools::maxThreads();
+    double a_val = 2;
+
+    // Check both a buffer that is converted to dense and a buffer that
+    // remains sparse.
+    Teuchos::Array<double> fill_ratios( 2 );
+    fill_ratios[0] = 0.5;
+    fill_ratios[1] = 2.0;
+    for ( int r = 0; r < fill_ratios.size(); ++r )
+    {
+	Teuchos::RCP<VectorType> A = 
+	    Tpetra::createVector<double,int,long>( map_a );
+	MCLS::AdjointTally<VectorType> tally( A, fill_ratios[r] );
+
+	// Every thread tallies every state.
+#if HAVE_MCLS_OPENMP
+#pragma omp parallel num_threads(num_threads)
+#endif
+	{
+	    for ( int i = 0; i < tally_rows.size(); ++i )
+	    {
+		HistoryType history( tally_rows[i], i, a_val );
+		history.live();
+		tally.tallyHistory( history );
+	    }
+	}
+	tally.finalize();
+
+	Teuchos::ArrayRCP<const double> A_view = VT::view( *A );
+	typename Teuchos::ArrayRCP<const double>::const_iterator 
+	    a_view_iterator;
+	for ( a_view_iterator = A_view.begin();
+	      a_view_iterator != A_view.end();
+	      ++a_view_iterator )
+	{
+	    TEST_EQUALITY( *a_view_iterator, num_threads*a_val );
+	}
+    }
+}
+
 //---------------------------------------------------------------------------//
 TEUCHOS_UNIT_TEST( AdjointTally, Normalize )
 {
@@ -166,6 +225,78 @@ TEUCHOS_UNIT_TEST( AdjointTally, Normalize )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AdjointTally, VarianceBatches )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef MCLS::AdjointHistory<long> HistoryType;
+    typedef MCLS::TallyTraits<MCLS::AdjointTally<VectorType> > TT;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map_a = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+    Teuchos::RCP<VectorType> A = Tpetra::createVector<double,int,long>( map_a );
+    Teuchos::RCP<VectorType> variance = VT::clone( *A );
+
+    Teuchos::ArrayView<const long> tally_rows = map_a->getNodeElementList();
+
+    // Without batches the variance cannot be estimated.
+    MCLS::AdjointTally<VectorType> tally( A );
+    TEST_EQUALITY( tally.numVarianceBatches(), 0 );
+    TEST_ASSERT( !TT::estimateVariance(tally,*variance) );
+
+    // The batches are divided evenly over the threads.
+    int num_threads = MCLS::ThreadTools::maxThreads();
+    tally.setVarianceBatches( 4 );
+    int num_batches = tally.numVarianceBatches();
+    int thread_batches = num_batches / num_threads;
+    TEST_ASSERT( num_batches >= 4 );
+    TEST_EQUALITY( num_batches % num_threads, 0 );
+
+    // Tally two histories of each master thread batch into each state. The
+    // entering histories are assigned to the master thread batches in turn.
+    int nh = 2*thread_batches;
+    for ( int i = 0; i < tally_rows.size(); ++i )
+    {
+	for ( int j = 0; j < nh; ++j )
+	{
+	    HistoryType history( tally_rows[i], i, (i+1.0)*(j+1.0) );
+	    history.live();
+	    tally.tallyHistory( history );
+	    TEST_EQUALITY( history.batch(), num_threads*(j % thread_batches) );
+	}
+    }
+    tally.finalize();
+    tally.normalize( nh );
+    TEST_ASSERT( TT::estimateVariance(tally,*variance) );
+
+    // Check the batch means variance of each state.
+    Teuchos::ArrayRCP<const double> A_view = VT::view( *A );
+    Teuchos::ArrayRCP<const double> var_view = VT::view( *variance );
+    for ( int i = 0; i < tally_rows.size(); ++i )
+    {
+	double sum_squares = 0.0;
+	for ( int k = 0; k < thread_batches; ++k )
+	{
+	    double batch_tally = 
+		(i+1.0)*(k+1.0) + (i+1.0)*(k+thread_batches+1.0);
+	    sum_squares += batch_tally*batch_tally;
+	}
+	double mean = (i+1.0)*(nh+1.0)/2.0;
+	TEST_FLOATING_EQUALITY( A_view[i], mean, 1.0e-14 );
+	double expected = 
+	    std::max( num_batches*sum_squares/(nh*nh) - mean*mean, 0.0 ) /
+	    (num_batches - 1.0);
+	TEST_FLOATING_EQUALITY( var_view[i], expected, 1.0e-12 );
+    }
+}
+
 //---------------------------------------------------------------------------//
 // end tstTpetraAdjointTally.cpp
 //---------------------------------------------------------------------------//
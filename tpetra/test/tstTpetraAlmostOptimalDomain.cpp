@@ -66,6 +66,7 @@
 #include <Teuchos_ArrayView.hpp>
 #include <Teuchos_TypeTraits.hpp>
 #include <Teuchos_ParameterList.hpp>
+#include <Teuchos_as.hpp>
 
 #include <Tpetra_Map.hpp>
 #include <Tpetra_Vector.hpp>
@@ -258,6 +259,459 @@ TEUCHOS_UNIT_TEST( AlmostOptimalDomain, Diagonal )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AlmostOptimalDomain, DiagonalAlias )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::AdjointHistory<long> HistoryType;
+    typedef std::mt19937 rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build the linear operator and solution vector.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> global_columns( 1 );
+    Teuchos::Array<double> values( 1 );
+    for ( int i = 0; i < global_num_rows; ++i )
+    {
+	global_columns[0] = i;
+	values[0] = 3.0;
+	A->insertGlobalValues( i, global_columns(), values() );
+    }
+    A->fillComplete();
+
+    Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+
+    // Build the adjoint domain.
+    Teuchos::ParameterList plist;
+    plist.set<std::string>( "Transition Sampler", "Alias" );
+    plist.set<int>( "Alias Table Minimum Row Size", 1 );
+    MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType> domain( A, x, plist );
+
+    // Process a history transition in the domain.
+    Teuchos::RCP<MCLS::PRNG<rng_type> > rng = Teuchos::rcp(
+	new MCLS::PRNG<rng_type>( comm->getRank() ) );
+    domain.setRNG( rng );
+    double weight = 3.0; 
+    for ( int i = 0; i < global_num_rows; ++i )
+    {
+	if ( i >= local_num_rows*comm_rank && i < local_num_rows*(comm_rank+1) )
+	{
+	    HistoryType history( i, i-comm_rank*local_num_rows, weight );
+	    history.live();
+	    history.setEvent( MCLS::Event::TRANSITION );
+	    domain.processTransition( history );
+
+	    TEST_EQUALITY( history.globalState(), i );
+	    TEST_EQUALITY( history.weight(), -weight*(comm_size*3-1) );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AlmostOptimalDomain, AliasFrequencies )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::AdjointHistory<long> HistoryType;
+    typedef std::mt19937 rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+    typedef MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType>
+	DomainType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    int row_begin = local_num_rows*comm_rank;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build a block diagonal operator such that each local row of the
+    // iteration matrix has 4 local entries with absolute values of 0.1, 0.2,
+    // 0.3, and 0.4 and transitions never leave the domain.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> global_columns( 4 );
+    Teuchos::Array<double> values( 4 );
+    for ( int i = 0; i < local_num_rows; ++i )
+    {
+	global_columns[0] = row_begin + i;
+	values[0] = 0.9;
+	for ( int j = 1; j < 4; ++j )
+	{
+	    global_columns[j] = row_begin + (i+j) % local_num_rows;
+	    values[j] = -0.1*(j+1);
+	}
+	A->insertGlobalValues( row_begin + i, global_columns(), values() );
+    }
+    A->fillComplete();
+
+    Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+
+    // Sample the first local row with the alias and CDF samplers. Both must
+    // reproduce the transition probabilities.
+    Teuchos::Array<std::string> samplers( 2 );
+    samplers[0] = "Alias";
+    samplers[1] = "CDF";
+    int num_samples = 100000;
+    double weight = 3.0;
+    for ( int s = 0; s < samplers.size(); ++s )
+    {
+	Teuchos::ParameterList plist;
+	plist.set<std::string>( "Transition Sampler", samplers[s] );
+	plist.set<int>( "Alias Table Minimum Row Size", 1 );
+	DomainType domain( A, x, plist );
+	Teuchos::RCP<MCLS::PRNG<rng_type> > rng = Teuchos::rcp(
+	    new MCLS::PRNG<rng_type>( comm_rank, 433494437 ) );
+	domain.setRNG( rng );
+
+	Teuchos::Array<int> counts( 4, 0 );
+	for ( int n = 0; n < num_samples; ++n )
+	{
+	    HistoryType history( row_begin, 0, weight );
+	    history.live();
+	    history.setEvent( MCLS::Event::TRANSITION );
+	    domain.processTransition( history );
+
+	    // The row weight is 1 and every entry of the iteration matrix is
+	    // positive.
+	    TEST_FLOATING_EQUALITY( history.weight(), weight, 1.0e-12 );
+	    int j = ( history.globalState() - row_begin + local_num_rows ) 
+		    % local_num_rows;
+	    TEST_ASSERT( j < 4 );
+	    if ( j < 4 )
+	    {
+		++counts[j];
+	    }
+	}
+
+	for ( int j = 0; j < 4; ++j )
+	{
+	    double frequency = Teuchos::as<double>(counts[j]) / num_samples;
+	    TEST_ASSERT( std::abs(frequency - 0.1*(j+1)) < 0.01 );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AlmostOptimalDomain, WeightCutoff )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::AdjointHistory<long> HistoryType;
+    typedef std::mt19937 rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build the linear operator and solution vector. The iteration matrix is
+    // H = 0.5 I.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> global_columns( 1 );
+    Teuchos::Array<double> values( 1 );
+    for ( int i = local_num_rows*comm_rank; 
+	  i < local_num_rows*(comm_rank+1); 
+	  ++i )
+    {
+	global_columns[0] = i;
+	values[0] = 0.5;
+	A->insertGlobalValues( i, global_columns(), values() );
+    }
+    A->fillComplete();
+
+    Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+    Teuchos::RCP<MCLS::PRNG<rng_type> > rng = Teuchos::rcp(
+	new MCLS::PRNG<rng_type>( comm->getRank() ) );
+
+    // Build a domain with a weight cutoff and check that histories are
+    // terminated when they fall below the cutoff.
+    {
+	Teuchos::ParameterList plist;
+	plist.set<int>( "History Length", 100 );
+	plist.set<double>( "Weight Cutoff", 0.2 );
+	MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType> 
+	    domain( A, x, plist );
+	domain.setRNG( rng );
+	domain.setSourceWeight( 2.0 );
+
+	for ( int i = 0; i < local_num_rows; ++i )
+	{
+	    HistoryType history( i+comm_rank*local_num_rows, i, 2.0 );
+	    history.live();
+	    history.setEvent( MCLS::Event::TRANSITION );
+	    TEST_ASSERT( !domain.terminateHistory(history) );
+	    domain.processTransition( history );
+	    TEST_EQUALITY( history.weight(), 1.0 );
+	    TEST_ASSERT( !domain.terminateHistory(history) );
+	    domain.processTransition( history );
+	    TEST_EQUALITY( history.weight(), 0.5 );
+	    TEST_ASSERT( !domain.terminateHistory(history) );
+	    domain.processTransition( history );
+	    TEST_EQUALITY( history.weight(), 0.25 );
+	    TEST_ASSERT( domain.terminateHistory(history) );
+	    TEST_EQUALITY( history.numSteps(), 3 );
+	}
+    }
+
+    // Build a domain with Russian roulette and check that histories below the
+    // cutoff either survive at the cutoff weight or are terminated.
+    {
+	Teuchos::ParameterList plist;
+	plist.set<int>( "History Length", 100 );
+	plist.set<double>( "Weight Cutoff", 0.2 );
+	plist.set<bool>( "Russian Roulette", true );
+	MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType> 
+	    domain( A, x, plist );
+	domain.setRNG( rng );
+	domain.setSourceWeight( 2.0 );
+
+	for ( int i = 0; i < local_num_rows; ++i )
+	{
+	    HistoryType history( i+comm_rank*local_num_rows, i, 2.0 );
+	    history.live();
+	    history.setEvent( MCLS::Event::TRANSITION );
+	    for ( int n = 0; n < 3; ++n )
+	    {
+		domain.processTransition( history );
+	    }
+	    if ( domain.terminateHistory(history) )
+	    {
+		TEST_EQUALITY( history.weight(), 0.0 );
+	    }
+	    else
+	    {
+		TEST_EQUALITY( history.weight(), 0.4 );
+	    }
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AlmostOptimalDomain, RefillValues )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::AdjointHistory<long> HistoryType;
+    typedef std::mt19937 rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+    typedef MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType>
+	DomainType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build two linear operators with the same sparsity pattern.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::RCP<MatrixType> B = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> first_columns( 1, 0 );
+    Teuchos::Array<double> first_values( 1, 2.0 );
+    A->insertGlobalValues( 0, first_columns(), first_values() );
+    first_values[0] = 0.5;
+    B->insertGlobalValues( 0, first_columns(), first_values() );
+    Teuchos::Array<long> global_columns( 2 );
+    Teuchos::Array<double> values( 2 );
+    for ( int i = 1; i < global_num_rows; ++i )
+    {
+	global_columns[0] = i-1;
+	global_columns[1] = i;
+	values[0] = 2;
+	values[1] = 3;
+	A->insertGlobalValues( i, global_columns(), values() );
+	values[0] = -0.25;
+	values[1] = 0.5;
+	B->insertGlobalValues( i, global_columns(), values() );
+    }
+    A->fillComplete();
+    B->fillComplete();
+
+    Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+    Teuchos::RCP<MatrixType> A_T = MT::copyTranspose(*A);
+    Teuchos::RCP<MatrixType> B_T = MT::copyTranspose(*B);
+
+    // Build a domain with the first operator and refill it with the
+    // second. Compare it to a domain built directly from the second. Do
+    // this without overlap and with overlap rows imported from the cached
+    // overlap row set.
+    for ( int overlap = 0; overlap < 3; overlap += 2 )
+    {
+	Teuchos::ParameterList plist;
+	plist.set<int>( "Overlap Size", overlap );
+	DomainType refill_domain( A_T, x, plist );
+	Teuchos::RCP<TallyType> tally = refill_domain.domainTally();
+	refill_domain.refillValues( B_T, x, plist );
+	DomainType domain( B_T, x, plist );
+
+	// The tally is kept for the same solution vector.
+	TEST_EQUALITY( refill_domain.domainTally().getRawPtr(), 
+		       tally.getRawPtr() );
+
+	// Check the cached structure.
+	TEST_EQUALITY( refill_domain.numSendNeighbors(), 
+		       domain.numSendNeighbors() );
+	TEST_EQUALITY( refill_domain.numReceiveNeighbors(), 
+		       domain.numReceiveNeighbors() );
+	for ( int n = 0; n < domain.numSendNeighbors(); ++n )
+	{
+	    TEST_EQUALITY( refill_domain.sendNeighborRank(n), 
+			   domain.sendNeighborRank(n) );
+	}
+	for ( int n = 0; n < domain.numReceiveNeighbors(); ++n )
+	{
+	    TEST_EQUALITY( refill_domain.receiveNeighborRank(n), 
+			   domain.receiveNeighborRank(n) );
+	}
+	Teuchos::Array<long> refill_states = refill_domain.localStates();
+	Teuchos::Array<long> states = domain.localStates();
+	TEST_ASSERT( refill_states == states );
+
+	// Transitions with the same random numbers must be identical. Both
+	// domains get a generator with the same fixed seed.
+	int seed = 433494437;
+	refill_domain.setRNG( 
+	    Teuchos::rcp(new MCLS::PRNG<rng_type>(comm_rank,seed)) );
+	domain.setRNG( 
+	    Teuchos::rcp(new MCLS::PRNG<rng_type>(comm_rank,seed)) );
+	for ( int i = 0; i < states.size(); ++i )
+	{
+	    HistoryType refill_history( states[i], i, 1.0 );
+	    refill_history.live();
+	    refill_history.setEvent( MCLS::Event::TRANSITION );
+	    refill_domain.processTransition( refill_history );
+
+	    HistoryType history( states[i], i, 1.0 );
+	    history.live();
+	    history.setEvent( MCLS::Event::TRANSITION );
+	    domain.processTransition( history );
+
+	    TEST_EQUALITY( refill_history.globalState(), 
+			   history.globalState() );
+	    TEST_EQUALITY( refill_history.localState(), history.localState() );
+	    TEST_EQUALITY( refill_history.weight(), history.weight() );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( AlmostOptimalDomain, Overlap )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::AdjointHistory<long> HistoryType;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+    typedef std::mt19937 rng_type;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build the linear operator and solution vector.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> first_columns( 1, 0 );
+    Teuchos::Array<double> first_values( 1, 2.0 );
+    A->insertGlobalValues( 0, first_columns(), first_values() );
+    Teuchos::Array<long> global_columns( 2 );
+    Teuchos::Array<double> values( 2 );
+    for ( int i = 1; i < global_num_rows; ++i )
+    {
+	global_columns[0] = i-1;
+	global_columns[1] = i;
+	values[0] = 2;
+	values[1] = 3;
+	A->insertGlobalValues( i, global_columns(), values() );
+    }
+    A->fillComplete();
+
+    Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+    Teuchos::RCP<MatrixType> A_T = MT::copyTranspose(*A);
+
+    // Build the adjoint domain with one level of overlap.
+    Teuchos::ParameterList plist;
+    plist.set<int>( "Overlap Size", 1 );
+    MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType> domain( A_T, x, plist );
+
+    // The first row of the next process is in the overlap and the boundary
+    // is the row after it.
+    int overlap_row = local_num_rows*(comm_rank+1);
+    if ( comm_rank < comm_size - 1 )
+    {
+	TEST_ASSERT( domain.isGlobalState(overlap_row) );
+	TEST_ASSERT( !domain.isBoundaryState(overlap_row) );
+	TEST_ASSERT( domain.isBoundaryState(overlap_row+1) );
+	TEST_EQUALITY( domain.numSendNeighbors(), 1 );
+	TEST_EQUALITY( domain.sendNeighborRank(0), comm_rank+1 );
+	TEST_EQUALITY( domain.owningNeighbor(overlap_row+1), 0 );
+    }
+    else
+    {
+	TEST_EQUALITY( domain.numSendNeighbors(), 0 );
+    }
+
+    // Tally a history in the overlap. It is returned to the owning process
+    // when the tally is finalized.
+    double x_val = 2.0;
+    Teuchos::RCP<TallyType> tally = domain.domainTally();
+    if ( comm_rank < comm_size - 1 )
+    {
+	HistoryType history( overlap_row, local_num_rows, x_val );
+	history.live();
+	tally->tallyHistory( history );
+    }
+    tally->finalize();
+
+    Teuchos::ArrayRCP<const double> x_view = VT::view( *x );
+    for ( int i = 0; i < local_num_rows; ++i )
+    {
+	if ( 0 == i && comm_rank > 0 )
+	{
+	    TEST_EQUALITY( x_view[i], x_val );
+	}
+	else
+	{
+	    TEST_EQUALITY( x_view[i], 0.0 );
+	}
+    }
+}
+
 //---------------------------------------------------------------------------//
 // end tstTpetraAlmostOptimalDomain.cpp
 //---------------------------------------------------------------------------//
@@ -896,6 +896,64 @@ TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MatrixTraits, copy_neighbor, LO, GO, Scalar )
 
 UNIT_TEST_INSTANTIATION( MatrixTraits, copy_neighbor )
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MatrixTraits, copy_neighbor_depth, LO, GO, Scalar )
+{
+    typedef Tpetra::CrsMatrix<Scalar,LO,GO> MatrixType;
+    typedef Tpetra::Vector<Scalar,LO,GO> VectorType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+
+    int local_num_rows = 3;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<LO,GO> > map = 
+	Tpetra::createUniformContigMap<LO,GO>( global_num_rows, comm );
+
+    // Build a tridiagonal matrix such that the neighbors at a given depth
+    // are the rows within that distance of the local rows.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<Scalar,LO,GO>( map );
+    Teuchos::Array<GO> global_columns;
+    Teuchos::Array<Scalar> values;
+    for ( int i = local_num_rows*comm_rank; 
+	  i < local_num_rows*(comm_rank+1); 
+	  ++i )
+    {
+	global_columns.clear();
+	for ( int j = std::max(i-1,0); j < std::min(i+2,global_num_rows); ++j )
+	{
+	    global_columns.push_back( j );
+	}
+	values.assign( global_columns.size(), 1 );
+	A->insertGlobalValues( i, global_columns(), values() );
+    }
+    A->fillComplete();
+
+    int row_begin = local_num_rows*comm_rank;
+    int row_end = local_num_rows*(comm_rank+1);
+    for ( int i = 0; i < 5; ++i )
+    {
+	Teuchos::RCP<MatrixType> B =  MT::copyNearestNeighbors( *A, i );
+
+	int local_num_neighbor = std::min(i,row_begin) + 
+				 std::min(i,global_num_rows-row_end);
+	TEST_EQUALITY( local_num_neighbor, MT::getLocalNumRows( *B ) );
+
+	GO global_row = 0;
+	for ( int j = 0; j < local_num_neighbor; ++j )
+	{
+	    global_row = MT::getGlobalRow( *B, j );
+	    TEST_ASSERT( (global_row >= row_begin - i && global_row < row_begin) ||
+			 (global_row >= row_end && global_row < row_end + i) );
+	}
+    }
+}
+
+UNIT_TEST_INSTANTIATION( MatrixTraits, copy_neighbor_depth )
+
 //---------------------------------------------------------------------------//
 TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MatrixTraits, multiply, LO, GO, Scalar )
 {
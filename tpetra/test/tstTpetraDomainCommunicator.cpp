@@ -142,10 +142,16 @@ TEUCHOS_UNIT_TEST( DomainCommunicator, Communicate )
 	typename MCLS::DomainCommunicator<DomainType>::BankType bank;
 	int buffer_size = 3;
 	plist.set<int>( "MC Buffer Size", buffer_size );
+
+	// Unset adaptive buffer size bounds default to the buffer size.
+	plist.set<int>( "MC Min Buffer Size", 0 );
+	plist.set<int>( "MC Max Buffer Size", 0 );
 	MCLS::DomainCommunicator<DomainType> communicator( domain, comm, plist );
 
 	// Test initialization.
 	TEST_EQUALITY( Teuchos::as<int>(communicator.maxBufferSize()), buffer_size );
+	TEST_EQUALITY( communicator.numSendBuffersPerNeighbor(), 2 );
+	TEST_EQUALITY( communicator.minBufferSize(), buffer_size );
 	TEST_ASSERT( !communicator.sendStatus() );
 	TEST_ASSERT( !communicator.receiveStatus() );
 
@@ -325,6 +331,253 @@ TEUCHOS_UNIT_TEST( DomainCommunicator, Communicate )
     comm->barrier();
 }
 
+TEUCHOS_UNIT_TEST( DomainCommunicator, AdaptiveBufferSize )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::AdjointHistory<long> HistoryType;
+    typedef std::mt19937 rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+    typedef MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType>
+	DomainType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+
+    // This test is parallel.
+    if ( comm_size > 1 )
+    {
+	int local_num_rows = 10;
+	int global_num_rows = local_num_rows*comm_size;
+	Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	    Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+	// Build the linear operator and solution vector.
+	Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+	Teuchos::Array<long> global_columns( 1 );
+	Teuchos::Array<double> values( 1 );
+	for ( int i = 1; i < global_num_rows; ++i )
+	{
+	    global_columns[0] = i-1;
+	    values[0] = -0.5/comm_size;
+	    A->insertGlobalValues( i, global_columns(), values() );
+	}
+	global_columns[0] = global_num_rows-1;
+	values[0] = -0.5/comm_size;
+	A->insertGlobalValues( global_num_rows-1, global_columns(), values() );
+	A->fillComplete();
+
+	Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+        Teuchos::RCP<MatrixType> A_T = MT::copyTranspose(*A);
+
+	// Build the adjoint domain.
+	Teuchos::ParameterList plist;
+	plist.set<int>( "Overlap Size", 0 );
+	Teuchos::RCP<DomainType> domain = 
+            Teuchos::rcp( new DomainType( A_T, x, plist ) );
+	Teuchos::RCP<MCLS::PRNG<rng_type> > rng = Teuchos::rcp(
+	    new MCLS::PRNG<rng_type>( comm->getRank() ) );
+	domain->setRNG( rng );
+
+	// History setup.
+	HistoryType::setByteSize();
+
+	// Build the domain communicator with adaptive buffer sizes.
+	typename MCLS::DomainCommunicator<DomainType>::BankType bank;
+	plist.set<int>( "MC Buffer Size", 2 );
+	plist.set<int>( "MC Min Buffer Size", 1 );
+	plist.set<int>( "MC Max Buffer Size", 8 );
+	MCLS::DomainCommunicator<DomainType> communicator( domain, comm, plist );
+	TEST_EQUALITY( Teuchos::as<int>(communicator.maxBufferSize()), 8 );
+	TEST_EQUALITY( communicator.minBufferSize(), 1 );
+	communicator.post();
+
+	// Every proc but the last sends to proc comm_rank+1.
+	if ( comm_rank < comm_size - 1 )
+	{
+	    TEST_EQUALITY( communicator.bufferSizes().size(), 1 );
+	    TEST_EQUALITY( communicator.bufferSize(0), 2 );
+
+	    // Filling the buffer doubles its size.
+	    long state = (comm_rank+1)*10;
+	    TEST_ASSERT( !communicator.communicate(
+			     makeHistory(state,1.1,0) ).sent );
+	    TEST_ASSERT( communicator.communicate(
+			     makeHistory(state,2.1,0) ).sent );
+	    TEST_EQUALITY( communicator.bufferSize(0), 4 );
+	    TEST_EQUALITY( communicator.sendBuffer(0).capacity(), 4 );
+
+	    // Sending a buffer less than half full halves its size.
+	    TEST_ASSERT( !communicator.communicate(
+			     makeHistory(state,3.1,0) ).sent );
+	    TEST_EQUALITY( communicator.send(), 1 );
+	    TEST_EQUALITY( communicator.bufferSize(0), 2 );
+	    TEST_EQUALITY( communicator.sendBuffer(0).capacity(), 2 );
+	}
+
+	// Every proc but the first receives from proc comm_rank-1.
+	if ( comm_rank > 0 )
+	{
+	    while ( bank.size() < 3 )
+	    {
+		communicator.checkAndPost( bank );
+	    }
+	    TEST_EQUALITY( bank.size(), 3 );
+	    TEST_EQUALITY( bank.top().weight(), 3.1 );
+	    TEST_EQUALITY( bank.top().globalState(), comm_rank*10 );
+	}
+
+	// End communication.
+	communicator.end();
+	TEST_ASSERT( !communicator.receiveStatus() );
+    }
+
+    // Barrier before exiting to make sure memory deallocation happened
+    // correctly. 
+    comm->barrier();
+}
+
+TEUCHOS_UNIT_TEST( DomainCommunicator, SendBufferPool )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::AdjointHistory<long> HistoryType;
+    typedef std::mt19937 rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+    typedef MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType>
+	DomainType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+
+    // This test is parallel.
+    if ( comm_size > 1 )
+    {
+	int local_num_rows = 10;
+	int global_num_rows = local_num_rows*comm_size;
+	Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	    Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+	// Build the linear operator and solution vector.
+	Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+	Teuchos::Array<long> global_columns( 1 );
+	Teuchos::Array<double> values( 1 );
+	for ( int i = 1; i < global_num_rows; ++i )
+	{
+	    global_columns[0] = i-1;
+	    values[0] = -0.5/comm_size;
+	    A->insertGlobalValues( i, global_columns(), values() );
+	}
+	global_columns[0] = global_num_rows-1;
+	values[0] = -0.5/comm_size;
+	A->insertGlobalValues( global_num_rows-1, global_columns(), values() );
+	A->fillComplete();
+
+	Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+        Teuchos::RCP<MatrixType> A_T = MT::copyTranspose(*A);
+
+	// Build the adjoint domain.
+	Teuchos::ParameterList plist;
+	plist.set<int>( "Overlap Size", 0 );
+	Teuchos::RCP<DomainType> domain = 
+            Teuchos::rcp( new DomainType( A_T, x, plist ) );
+	Teuchos::RCP<MCLS::PRNG<rng_type> > rng = Teuchos::rcp(
+	    new MCLS::PRNG<rng_type>( comm->getRank() ) );
+	domain->setRNG( rng );
+
+	// History setup.
+	HistoryType::setByteSize();
+
+	// Build the domain communicator with a pool of 3 fixed size buffers
+	// per neighbor.
+	typename MCLS::DomainCommunicator<DomainType>::BankType bank;
+	int buffer_size = 2;
+	int num_buffers = 3;
+	plist.set<int>( "MC Buffer Size", buffer_size );
+	plist.set<int>( "MC Min Buffer Size", buffer_size );
+	plist.set<int>( "MC Max Buffer Size", buffer_size );
+	plist.set<int>( "MC Send Buffers Per Neighbor", num_buffers );
+	MCLS::DomainCommunicator<DomainType> communicator( domain, comm, plist );
+	TEST_EQUALITY( communicator.numSendBuffersPerNeighbor(), num_buffers );
+
+	// Every proc but the last fills more buffers to proc comm_rank+1
+	// than it has in its pool before any receives are posted. Posting the
+	// last buffer rotates back to the first buffer in the pool which must
+	// be checked or waited on before it is reused. The last history is
+	// sent in a partially full buffer.
+	int num_full = num_buffers + 1;
+	int num_histories = num_full*buffer_size + 1;
+	if ( comm_rank < comm_size - 1 )
+	{
+	    long state = (comm_rank+1)*10;
+	    for ( int i = 0; i < num_full*buffer_size; ++i )
+	    {
+		const typename MCLS::DomainCommunicator<DomainType>::Result
+		    result = communicator.communicate( 
+			makeHistory(state, i+1.0, 0) );
+		TEST_EQUALITY( result.sent, (i+1) % buffer_size == 0 );
+		TEST_EQUALITY( result.destination, comm_rank+1 );
+		TEST_EQUALITY( communicator.bufferSize(0), buffer_size );
+	    }
+	    TEST_EQUALITY( communicator.sendBufferSize(), 0 );
+
+	    communicator.communicate( 
+		makeHistory(state, num_histories, 0) );
+	    TEST_EQUALITY( communicator.sendBufferSize(), 1 );
+	    TEST_EQUALITY( communicator.send(), 1 );
+	    TEST_EQUALITY( communicator.sendBufferSize(), 0 );
+	}
+
+	// Post receives only after all sends are in flight.
+	comm->barrier();
+	communicator.post();
+
+	// Flushing waits on every buffer in the pool.
+	TEST_EQUALITY( communicator.flush(), 0 );
+	TEST_ASSERT( !communicator.sendStatus() );
+
+	// Every proc but the first receives every history from proc
+	// comm_rank-1 followed by the empty flushed buffer.
+	if ( comm_rank > 0 )
+	{
+	    while ( Teuchos::as<int>(bank.size()) < num_histories )
+	    {
+		communicator.checkAndPost( bank );
+	    }
+	    TEST_EQUALITY( communicator.wait(bank), 0 );
+	    TEST_EQUALITY( Teuchos::as<int>(bank.size()), num_histories );
+
+	    Teuchos::Array<double> weights;
+	    while ( !bank.empty() )
+	    {
+		TEST_EQUALITY( bank.top().globalState(), comm_rank*10 );
+		weights.push_back( bank.top().weight() );
+		bank.pop();
+	    }
+	    std::sort( weights.begin(), weights.end() );
+	    for ( int i = 0; i < num_histories; ++i )
+	    {
+		TEST_EQUALITY( weights[i], i+1.0 );
+	    }
+	}
+
+	// End communication.
+	communicator.post();
+	communicator.end();
+	TEST_ASSERT( !communicator.receiveStatus() );
+    }
+
+    // Barrier before exiting to make sure memory deallocation happened
+    // correctly. 
+    comm->barrier();
+}
+
 //---------------------------------------------------------------------------//
 // end tstTpetraDomainCommunicator.cpp
 //---------------------------------------------------------------------------//
@@ -171,6 +171,168 @@ TEUCHOS_UNIT_TEST( DomainTransporter, Cutoff )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( DomainTransporter, BatchCutoff )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::AdjointHistory<long> HistoryType;
+    typedef std::mt19937 rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+    typedef MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType>
+	DomainType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build the linear operator and solution vector.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> global_columns( 1 );
+    Teuchos::Array<double> values( 1, 0.5 );
+    for ( int i = 0; i < global_num_rows; ++i )
+    {
+	if ( i >= local_num_rows*comm_rank && i < local_num_rows*(comm_rank+1) )
+	{
+	    global_columns[0] = i;
+	    A->insertGlobalValues( i, global_columns(), values() );
+	}
+    }
+    A->fillComplete();
+
+    Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+    Teuchos::RCP<MatrixType> A_T = MT::copyTranspose(*A);
+
+    // Build the adjoint domain.
+    Teuchos::ParameterList plist;
+    plist.set<int>( "History Length", 1 );
+    Teuchos::RCP<DomainType> domain = Teuchos::rcp( new DomainType( A_T, x, plist ) );
+    Teuchos::RCP<MCLS::PRNG<rng_type> > rng = Teuchos::rcp(
+	new MCLS::PRNG<rng_type>( comm->getRank() ) );
+    domain->setRNG( rng );
+
+    // Build the domain transporter.
+    double weight = 3.0; 
+    MCLS::DomainTransporter<DomainType> transporter( domain );
+
+    // Transport the histories through the domain as a batch.
+    Teuchos::Array<HistoryType> histories;
+    for ( int i = 0; i < global_num_rows; ++i )
+    {
+	if ( i >= local_num_rows*comm_rank && i < local_num_rows*(comm_rank+1) )
+	{
+	    histories.push_back( HistoryType(i, i, weight) );
+	    histories.back().live();
+	}
+    }
+    transporter.transport( histories() );
+
+    for ( int i = 0; i < local_num_rows; ++i )
+    {
+	TEST_EQUALITY( histories[i].globalState(), i + local_num_rows*comm_rank );
+	TEST_EQUALITY( histories[i].localState(), i );
+	TEST_EQUALITY( histories[i].weight(), weight / 2 );
+	TEST_EQUALITY( histories[i].event(), MCLS::Event::CUTOFF );
+	TEST_ASSERT( !histories[i].alive() );
+    }
+
+    // Check the tally.
+    Teuchos::ArrayRCP<const double> x_view = VT::view( *x );
+    double x_val = weight;
+    for ( int i = 0; i < local_num_rows; ++i )
+    {
+	TEST_EQUALITY( x_view[i], x_val );
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( DomainTransporter, ExpectedValue )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::AdjointHistory<long> HistoryType;
+    typedef std::mt19937 rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+    typedef MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType>
+	DomainType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build the linear operator and solution vector.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> global_columns( 1 );
+    Teuchos::Array<double> values( 1, 0.5 );
+    for ( int i = 0; i < global_num_rows; ++i )
+    {
+	if ( i >= local_num_rows*comm_rank && i < local_num_rows*(comm_rank+1) )
+	{
+	    global_columns[0] = i;
+	    A->insertGlobalValues( i, global_columns(), values() );
+	}
+    }
+    A->fillComplete();
+
+    Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+    Teuchos::RCP<MatrixType> A_T = MT::copyTranspose(*A);
+
+    // Build the adjoint domain.
+    Teuchos::ParameterList plist;
+    plist.set<int>( "History Length", 3 );
+    plist.set<std::string>( "Estimator Type", "Expected Value" );
+    Teuchos::RCP<DomainType> domain = Teuchos::rcp( new DomainType( A_T, x, plist ) );
+    Teuchos::RCP<MCLS::PRNG<rng_type> > rng = Teuchos::rcp(
+	new MCLS::PRNG<rng_type>( comm->getRank() ) );
+    domain->setRNG( rng );
+
+    // Build the domain transporter.
+    double weight = 3.0; 
+    MCLS::DomainTransporter<DomainType> transporter( domain );
+
+    // Transport histories through the domain.
+    for ( int i = 0; i < global_num_rows; ++i )
+    {
+	if ( i >= local_num_rows*comm_rank && i < local_num_rows*(comm_rank+1) )
+	{
+	    HistoryType history( i, i, weight );
+	    history.live();
+	    transporter.transport( history );
+
+	    TEST_EQUALITY( history.globalState(), i );
+	    TEST_EQUALITY( history.localState(), i - local_num_rows*comm_rank );
+	    TEST_EQUALITY( history.weight(), weight / 8 );
+	    TEST_EQUALITY( history.event(), MCLS::Event::CUTOFF );
+	    TEST_ASSERT( !history.alive() );
+	}
+    }
+
+    // Check the tally. The expected value estimator gives the same result as
+    // the collision estimator for a diagonal operator.
+    Teuchos::ArrayRCP<const double> x_view = VT::view( *x );
+    double x_val = weight + weight / 2 + weight / 4;
+    for ( int i = 0; i < local_num_rows; ++i )
+    {
+	TEST_EQUALITY( x_view[i], x_val );
+    }
+}
+
 //---------------------------------------------------------------------------//
 TEUCHOS_UNIT_TEST( DomainTransporter, Boundary )
 {
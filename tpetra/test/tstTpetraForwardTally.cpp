@@ -232,6 +232,80 @@ TEUCHOS_UNIT_TEST( ForwardTally, Normalize )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( ForwardTally, Variance )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef MCLS::ForwardHistory<long> HistoryType;
+    typedef MCLS::TallyTraits<MCLS::ForwardTally<VectorType> > TT;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map_a = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+    Teuchos::RCP<VectorType> A = Tpetra::createVector<double,int,long>( map_a );
+    Teuchos::RCP<VectorType> B = Tpetra::createVector<double,int,long>( map_a );
+    Teuchos::RCP<VectorType> V = Tpetra::createVector<double,int,long>( map_a );
+
+    MCLS::ForwardTally<VectorType> tally( A );
+    VT::putScalar( *B, 1.0 );
+    tally.setSource( B );
+
+    // Tally two histories with scores of 1 and 3 in each state.
+    Teuchos::Array<double> weights( 2 );
+    weights[0] = 1.0;
+    weights[1] = 3.0;
+    for ( int i = 0; i < local_num_rows; ++i )
+    {
+	for ( int n = 0; n < weights.size(); ++n )
+	{
+	    HistoryType history( i + local_num_rows*comm_rank, i, weights[n] );
+	    history.live();
+	    tally.tallyHistory( history );
+	    history.kill();
+	    history.setEvent( MCLS::Event::CUTOFF );
+	    tally.postProcessHistory( history );
+	}
+    }
+
+    tally.finalize();
+    TEST_ASSERT( TT::estimateVariance(tally, *V) );
+
+    // The mean of each state is 2 and the variance of the mean is
+    // ((1+9)/2 - 2^2) / (2-1) = 1.
+    Teuchos::ArrayRCP<const double> A_view = VT::view( *A );
+    Teuchos::ArrayRCP<const double> V_view = VT::view( *V );
+    for ( int i = 0; i < local_num_rows; ++i )
+    {
+	TEST_FLOATING_EQUALITY( A_view[i], 2.0, 1.0e-14 );
+	TEST_FLOATING_EQUALITY( V_view[i], 1.0, 1.0e-14 );
+    }
+
+    // A single history per state has no variance estimate.
+    tally.zeroOut();
+    for ( int i = 0; i < local_num_rows; ++i )
+    {
+	HistoryType history( i + local_num_rows*comm_rank, i, 2.0 );
+	history.live();
+	tally.tallyHistory( history );
+	history.kill();
+	history.setEvent( MCLS::Event::CUTOFF );
+	tally.postProcessHistory( history );
+    }
+    tally.finalize();
+    TT::estimateVariance( tally, *V );
+    for ( int i = 0; i < local_num_rows; ++i )
+    {
+	TEST_EQUALITY( V_view[i], 0.0 );
+    }
+}
+
 //---------------------------------------------------------------------------//
 // end tstTpetraForwardTally.cpp
 //---------------------------------------------------------------------------//
@@ -48,12 +48,14 @@
 #include <cassert>
 
 #include <MCLS_LinearProblem.hpp>
+#include <MCLS_MultiSetLinearProblem.hpp>
 #include <MCLS_MatrixTraits.hpp>
 #include <MCLS_VectorTraits.hpp>
 #include <MCLS_TpetraAdapter.hpp>
 
 #include <Teuchos_UnitTestHarness.hpp>
 #include <Teuchos_DefaultComm.hpp>
+#include <Teuchos_DefaultSerialComm.hpp>
 #include <Teuchos_CommHelpers.hpp>
 #include <Teuchos_RCP.hpp>
 #include <Teuchos_ArrayRCP.hpp>
@@ -330,6 +332,16 @@ TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( LinearProblem, ResidualUpdate, LO, GO, Scalar
 	TEST_EQUALITY( *pview_iterator, 0.0 );
     }
 
+    Scalar residual_norm = (b_val - x_val) * std::sqrt( global_num_rows );
+    TEST_FLOATING_EQUALITY( linear_problem.updatePrecResidualNorm(),
+			    residual_norm, 1.0e-14 );
+    for ( pview_iterator = RP_view.begin();
+	  pview_iterator != RP_view.end();
+	  ++pview_iterator )
+    {
+	TEST_EQUALITY( *pview_iterator, b_val - x_val );
+    }
+
     linear_problem.setLeftPrec( A );
     linear_problem.updateResidual();
     for ( view_iterator = R_view.begin();
@@ -346,6 +358,14 @@ TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( LinearProblem, ResidualUpdate, LO, GO, Scalar
     {
 	TEST_EQUALITY( *pview_iterator, b_val - x_val );
     }
+
+    TEST_FLOATING_EQUALITY( linear_problem.updatePrecResidualNorm(),
+			    residual_norm, 1.0e-14 );
+
+    Teuchos::RCP<Teuchos::CommRequest<int> > norm_request =
+	linear_problem.startPrecResidualNorm();
+    TEST_FLOATING_EQUALITY( linear_problem.finishPrecResidualNorm(norm_request),
+			    residual_norm, 1.0e-14 );
 }
 
 UNIT_TEST_INSTANTIATION( LinearProblem, ResidualUpdate )
@@ -409,6 +429,63 @@ TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( LinearProblem, CompositeOperator, LO, GO, Sca
 
 UNIT_TEST_INSTANTIATION( LinearProblem, CompositeOperator )
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( MultiSetLinearProblem, BalanceSampleRatio, LO, GO, Scalar )
+{
+    typedef Tpetra::Vector<Scalar,LO,GO> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef Tpetra::CrsMatrix<Scalar,LO,GO> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+
+    // Make each process its own set.
+    Teuchos::RCP<const Teuchos::Comm<int> > set_comm = 
+	Teuchos::rcp( new Teuchos::SerialComm<int>() );
+    int local_num_rows = 10;
+    Teuchos::RCP<const Tpetra::Map<LO,GO> > map = 
+	Tpetra::createUniformContigMap<LO,GO>( local_num_rows, set_comm );
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<Scalar,LO,GO>( map );
+    Teuchos::Array<GO> global_columns( 1 );
+    Teuchos::Array<Scalar> values( 1, 1.0 );
+    for ( int i = 0; i < local_num_rows; ++i )
+    {
+	global_columns[0] = i;
+	A->insertGlobalValues( i, global_columns(), values() );
+    }
+    A->fillComplete();
+    Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+    Teuchos::RCP<VectorType> b = MT::cloneVectorFromMatrixRows( *A );
+    MCLS::MultiSetLinearProblem<VectorType,MatrixType> multiset_problem( 
+	comm, comm_size, comm_rank, A, x, b );
+
+    // Higher ranks are slower and should get smaller sample ratios. The
+    // total sample ratio is kept.
+    double sample_ratio = 2.0;
+    double transport_time = comm_rank + 1.0;
+    double balanced_ratio = 
+	multiset_problem.balanceSampleRatio( sample_ratio, transport_time );
+    double rate_sum = 0.0;
+    for ( int i = 0; i < comm_size; ++i )
+    {
+	rate_sum += 1.0 / (i + 1.0);
+    }
+    TEST_FLOATING_EQUALITY( balanced_ratio, 
+			    comm_size * sample_ratio / (transport_time*rate_sum),
+			    1.0e-12 );
+
+    double total_ratio = 0.0;
+    Teuchos::reduceAll<int,double>( *comm, Teuchos::REDUCE_SUM, 
+				    balanced_ratio, 
+				    Teuchos::outArg(total_ratio) );
+    TEST_FLOATING_EQUALITY( total_ratio, comm_size * sample_ratio, 1.0e-12 );
+}
+
+UNIT_TEST_INSTANTIATION( MultiSetLinearProblem, BalanceSampleRatio )
+
 //---------------------------------------------------------------------------//
 // end tstTpetraLinearProblem.cpp
 //---------------------------------------------------------------------------//
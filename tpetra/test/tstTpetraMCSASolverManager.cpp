@@ -641,6 +641,208 @@ TEUCHOS_UNIT_TEST( MCSASolverManager, prec_forward )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( MCSASolverManager, pipelined_adjoint )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build the linear system. 
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> global_columns( 3 );
+    Teuchos::Array<double> values( 3 );
+    global_columns[0] = 0;
+    global_columns[1] = 1;
+    global_columns[2] = 2;
+    values[0] = 1.0/comm_size;
+    values[1] = -0.14/comm_size;
+    values[2] = 0.0/comm_size;
+    A->insertGlobalValues( 0, global_columns(), values() );
+    for ( int i = 1; i < global_num_rows-1; ++i )
+    {
+	global_columns[0] = i-1;
+	global_columns[1] = i;
+	global_columns[2] = i+1;
+	values[0] = -0.14/comm_size;
+	values[1] = 1.0/comm_size;
+	values[2] = -0.14/comm_size;
+	A->insertGlobalValues( i, global_columns(), values() );
+    }
+    global_columns[0] = global_num_rows-3;
+    global_columns[1] = global_num_rows-2;
+    global_columns[2] = global_num_rows-1;
+    values[0] = 0.0/comm_size;
+    values[1] = -0.14/comm_size;
+    values[2] = 1.0/comm_size;
+    A->insertGlobalValues( global_num_rows-1, global_columns(), values() );
+    A->fillComplete();
+
+    // Build the LHS. 
+    Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+    VT::putScalar( *x, 0.0 );
+
+    // Build the RHS.
+    Teuchos::RCP<VectorType> b = MT::cloneVectorFromMatrixRows( *A );
+    VT::putScalar( *b, -1.0 );
+
+    // Solver parameters. Check the residual every other iteration with the
+    // norm reduction pipelined.
+    Teuchos::RCP<Teuchos::ParameterList> plist = 
+	Teuchos::rcp( new Teuchos::ParameterList() );
+    plist->set<double>("Convergence Tolerance", 1.0e-8);
+    plist->set<int>("Maximum Iterations", 20);
+    plist->set<int>("Iteration Check Frequency", 2);
+    plist->set<bool>("Pipelined Residual Norm", true);
+    plist->set<int>("MC Check Frequency", 50);
+    plist->set<double>("Sample Ratio",1.0);
+    plist->set<std::string>("Transport Type", "Global" );
+
+    // Create the linear problem.
+    Teuchos::RCP<MCLS::LinearProblem<VectorType,MatrixType> > linear_problem =
+	Teuchos::rcp( new MCLS::LinearProblem<VectorType,MatrixType>(
+			  A, x, b ) );
+    // Create the solver.
+    Teuchos::RCP<MCLS::MultiSetLinearProblem<VectorType,MatrixType> > multiset_problem =
+	Teuchos::rcp( new MCLS::MultiSetLinearProblem<VectorType,MatrixType>(
+			  comm, 1, 0, linear_problem) );
+    MCLS::MCSASolverManager<VectorType,MatrixType,MCLS::AdjointTag> 
+	solver_manager( multiset_problem, plist );
+
+    // Solve the problem. The speculative iteration after convergence is
+    // rolled back so the solution and residual are those of a checked
+    // iteration.
+    bool converged_status = solver_manager.solve();
+    TEST_ASSERT( converged_status );
+    TEST_ASSERT( solver_manager.getConvergedStatus() );
+    TEST_ASSERT( solver_manager.getNumIters() < 20 );
+    TEST_EQUALITY( solver_manager.getNumIters() % 2, 0 );
+    TEST_ASSERT( solver_manager.achievedTol() <= 1.0e-8 );
+
+    Teuchos::ArrayRCP<const double> x_view = VT::view(*x);
+    typename Teuchos::ArrayRCP<const double>::const_iterator x_view_it;
+    for ( x_view_it = x_view.begin(); x_view_it != x_view.end(); ++x_view_it )
+    {
+	TEST_ASSERT( *x_view_it < Teuchos::ScalarTraits<double>::zero() );
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( MCSASolverManager, adaptive_adjoint )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build the linear system. 
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> global_columns( 3 );
+    Teuchos::Array<double> values( 3 );
+    global_columns[0] = 0;
+    global_columns[1] = 1;
+    global_columns[2] = 2;
+    values[0] = 1.0/comm_size;
+    values[1] = -0.14/comm_size;
+    values[2] = 0.0/comm_size;
+    A->insertGlobalValues( 0, global_columns(), values() );
+    for ( int i = 1; i < global_num_rows-1; ++i )
+    {
+	global_columns[0] = i-1;
+	global_columns[1] = i;
+	global_columns[2] = i+1;
+	values[0] = -0.14/comm_size;
+	values[1] = 1.0/comm_size;
+	values[2] = -0.14/comm_size;
+	A->insertGlobalValues( i, global_columns(), values() );
+    }
+    global_columns[0] = global_num_rows-3;
+    global_columns[1] = global_num_rows-2;
+    global_columns[2] = global_num_rows-1;
+    values[0] = 0.0/comm_size;
+    values[1] = -0.14/comm_size;
+    values[2] = 1.0/comm_size;
+    A->insertGlobalValues( global_num_rows-1, global_columns(), values() );
+    A->fillComplete();
+
+    // Build the LHS. 
+    Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+    VT::putScalar( *x, 0.0 );
+
+    // Build the RHS.
+    Teuchos::RCP<VectorType> b = MT::cloneVectorFromMatrixRows( *A );
+    VT::putScalar( *b, -1.0 );
+
+    // Solver parameters. Adapt the sample ratio each iteration.
+    Teuchos::RCP<Teuchos::ParameterList> plist = 
+	Teuchos::rcp( new Teuchos::ParameterList() );
+    plist->set<double>("Convergence Tolerance", 1.0e-8);
+    plist->set<int>("Maximum Iterations", 20);
+    plist->set<bool>("Adaptive Sample Ratio", true);
+    plist->set<double>("Minimum Sample Ratio", 0.25);
+    plist->set<double>("Maximum Sample Ratio", 4.0);
+    plist->set<int>("MC Check Frequency", 50);
+    plist->set<double>("Sample Ratio",1.0);
+    plist->set<std::string>("Transport Type", "Global" );
+
+    // Create the linear problem.
+    Teuchos::RCP<MCLS::LinearProblem<VectorType,MatrixType> > linear_problem =
+	Teuchos::rcp( new MCLS::LinearProblem<VectorType,MatrixType>(
+			  A, x, b ) );
+    // Create the solver.
+    Teuchos::RCP<MCLS::MultiSetLinearProblem<VectorType,MatrixType> > multiset_problem =
+	Teuchos::rcp( new MCLS::MultiSetLinearProblem<VectorType,MatrixType>(
+			  comm, 1, 0, linear_problem) );
+    MCLS::MCSASolverManager<VectorType,MatrixType,MCLS::AdjointTag> 
+	solver_manager( multiset_problem, plist );
+
+    // Solve the problem.
+    bool converged_status = solver_manager.solve();
+    TEST_ASSERT( converged_status );
+    TEST_ASSERT( solver_manager.getConvergedStatus() );
+    TEST_ASSERT( solver_manager.getNumIters() < 20 );
+
+    // Check the ratio trace. A ratio is chosen after each iteration but the
+    // last.
+    Teuchos::Array<double> trace = solver_manager.getSampleRatioTrace();
+    TEST_EQUALITY( trace.size(), solver_manager.getNumIters() );
+    TEST_EQUALITY( trace[0], 1.0 );
+    for ( int i = 0; i < trace.size(); ++i )
+    {
+	TEST_ASSERT( trace[i] >= 0.25 );
+	TEST_ASSERT( trace[i] <= 4.0 );
+    }
+
+    // The input sample ratio is restored after the solve.
+    TEST_EQUALITY( plist->get<double>("Sample Ratio"), 1.0 );
+
+    Teuchos::ArrayRCP<const double> x_view = VT::view(*x);
+    typename Teuchos::ArrayRCP<const double>::const_iterator x_view_it;
+    for ( x_view_it = x_view.begin(); x_view_it != x_view.end(); ++x_view_it )
+    {
+	TEST_ASSERT( *x_view_it < Teuchos::ScalarTraits<double>::zero() );
+    }
+}
+
 //---------------------------------------------------------------------------//
 // end tstTpetraMCSASolverManager.cpp
 //---------------------------------------------------------------------------//
@@ -49,6 +49,7 @@
 #include <cassert>
 #include <random>
 
+#include <MCLS_config.hpp>
 #include <MCLS_MCSolver.hpp>
 #include <MCLS_UniformAdjointSource.hpp>
 #include <MCLS_AdjointTally.hpp>
@@ -56,6 +57,8 @@
 #include <MCLS_VectorTraits.hpp>
 #include <MCLS_MatrixTraits.hpp>
 #include <MCLS_TpetraAdapter.hpp>
+#include <MCLS_Philox.hpp>
+#include <MCLS_ThreadTools.hpp>
 
 #include <Teuchos_UnitTestHarness.hpp>
 #include <Teuchos_DefaultComm.hpp>
@@ -200,6 +203,365 @@ TEUCHOS_UNIT_TEST( MCSolver, solve )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( MCSolver, solve_bulk_synchronous )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::Philox rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+    typedef MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType> DomainType;
+    typedef MCLS::UniformAdjointSource<DomainType> SourceType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build the linear system. This operator is symmetric with a spectral
+    // radius less than 1.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> global_columns( 3 );
+    Teuchos::Array<double> values( 3 );
+    global_columns[0] = 0;
+    global_columns[1] = 1;
+    global_columns[2] = 2;
+    values[0] = 1.0/comm_size;
+    values[1] = -0.14/comm_size;
+    values[2] = 0.0/comm_size;
+    A->insertGlobalValues( 0, global_columns(), values() );
+    for ( int i = 1; i < global_num_rows-1; ++i )
+    {
+	global_columns[0] = i-1;
+	global_columns[1] = i;
+	global_columns[2] = i+1;
+	values[0] = -0.14/comm_size;
+	values[1] = 1.0/comm_size;
+	values[2] = -0.14/comm_size;
+	A->insertGlobalValues( i, global_columns(), values() );
+    }
+    global_columns[0] = global_num_rows-3;
+    global_columns[1] = global_num_rows-2;
+    global_columns[2] = global_num_rows-1;
+    values[0] = 0.0/comm_size;
+    values[1] = -0.14/comm_size;
+    values[2] = 1.0/comm_size;
+    A->insertGlobalValues( global_num_rows-1, global_columns(), values() );
+    A->fillComplete();
+
+    // Build the RHS with negative numbers. this gives us a negative
+    // solution. 
+    Teuchos::RCP<VectorType> b = MT::cloneVectorFromMatrixRows( *A );
+    VT::putScalar( *b, -2.0 );
+
+    // Solve the problem in reproducible mode with the default transporter,
+    // the bulk synchronous transporter, and the default transporter with
+    // lockstep batches. There is no domain overlap such that histories cross
+    // domain boundaries. A history carries its id and step count when it is
+    // communicated and draws each step from its own substream, so with the
+    // same seed all transports must sample the same random walks regardless
+    // of the transport order or the batching.
+    int history_length = 5;
+    int mult = 100;
+    int num_transports = 3;
+    Teuchos::Array<Teuchos::RCP<VectorType> > x( num_transports );
+    Teuchos::Array<std::string> transport_types( num_transports );
+    transport_types[0] = "Global";
+    transport_types[1] = "Bulk Synchronous";
+    transport_types[2] = "Global";
+    Teuchos::Array<int> batch_sizes( num_transports, 1 );
+    batch_sizes[2] = 8;
+    for ( int t = 0; t < num_transports; ++t )
+    {
+	// Build the LHS. Put a large positive number here to be sure we are
+	// clear the vector before solving.
+	x[t] = MT::cloneVectorFromMatrixRows( *A );
+	VT::putScalar( *x[t], 100.0 );
+
+	// Create the solver.
+	Teuchos::RCP<Teuchos::ParameterList> plist = 
+	    Teuchos::rcp( new Teuchos::ParameterList() );
+	plist->set<int>("MC Check Frequency", 10);
+	plist->set<bool>("Reproducible MC Mode",true);
+	plist->set<int>("Random Number Seed", 433494437);
+	plist->set<std::string>("Transport Type", transport_types[t] );
+	plist->set<int>("History Batch Size", batch_sizes[t] );
+	MCLS::MCSolver<SourceType> solver( comm, comm->getRank(), plist );
+
+	// Build the adjoint domain.
+	plist->set<int>( "History Length", history_length );
+	plist->set<int>( "Overlap Size", 0 );
+	Teuchos::RCP<DomainType> domain = 
+	    Teuchos::rcp( new DomainType( A, x[t], *plist ) );
+
+	// Create the adjoint source with a set number of histories.
+	plist->set<double>("Sample Ratio",mult);
+	Teuchos::RCP<SourceType> source = Teuchos::rcp(
+	    new SourceType( b, domain, *plist ) );
+
+	// Set the Domain.
+	solver.setDomain( domain );
+
+	// Set the Source.
+	solver.setSource( source );
+
+	// Do solve the problem.
+	solver.solve();
+    }
+
+    // Check that we got negative solutions that match the default
+    // transporter. The tallies may be summed in a different order.
+    Teuchos::ArrayRCP<const double> x_default_view = VT::view( *x[0] );
+    for ( int t = 1; t < num_transports; ++t )
+    {
+	Teuchos::ArrayRCP<const double> x_view = VT::view( *x[t] );
+	TEST_EQUALITY( x_view.size(), x_default_view.size() );
+	for ( int i = 0; i < x_view.size(); ++i )
+	{
+	    TEST_ASSERT( x_view[i] < Teuchos::ScalarTraits<double>::zero() );
+	    TEST_FLOATING_EQUALITY( x_view[i], x_default_view[i], 1.0e-12 );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( MCSolver, solve_sequence )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::Philox rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+    typedef MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType> DomainType;
+    typedef MCLS::UniformAdjointSource<DomainType> SourceType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build the linear system. This operator is symmetric with a spectral
+    // radius less than 1.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> global_columns( 3 );
+    Teuchos::Array<double> values( 3 );
+    global_columns[0] = 0;
+    global_columns[1] = 1;
+    global_columns[2] = 2;
+    values[0] = 1.0/comm_size;
+    values[1] = -0.14/comm_size;
+    values[2] = 0.0/comm_size;
+    A->insertGlobalValues( 0, global_columns(), values() );
+    for ( int i = 1; i < global_num_rows-1; ++i )
+    {
+	global_columns[0] = i-1;
+	global_columns[1] = i;
+	global_columns[2] = i+1;
+	values[0] = -0.14/comm_size;
+	values[1] = 1.0/comm_size;
+	values[2] = -0.14/comm_size;
+	A->insertGlobalValues( i, global_columns(), values() );
+    }
+    global_columns[0] = global_num_rows-3;
+    global_columns[1] = global_num_rows-2;
+    global_columns[2] = global_num_rows-1;
+    values[0] = 0.0/comm_size;
+    values[1] = -0.14/comm_size;
+    values[2] = 1.0/comm_size;
+    A->insertGlobalValues( global_num_rows-1, global_columns(), values() );
+    A->fillComplete();
+
+    Teuchos::RCP<VectorType> b = MT::cloneVectorFromMatrixRows( *A );
+    VT::putScalar( *b, -2.0 );
+
+    // Solve twice with one solver and once with a second solver with the
+    // same seed. The stratified source gives the same history ids in every
+    // solve, so only the solve in the substream key separates the solves.
+    int history_length = 5;
+    Teuchos::Array<Teuchos::RCP<VectorType> > x( 3 );
+    Teuchos::Array<Teuchos::RCP<MCLS::MCSolver<SourceType> > > solvers( 2 );
+    for ( int s = 0; s < 2; ++s )
+    {
+	Teuchos::RCP<Teuchos::ParameterList> plist = 
+	    Teuchos::rcp( new Teuchos::ParameterList() );
+	plist->set<bool>("Reproducible MC Mode",true);
+	plist->set<int>("Random Number Seed", 433494437);
+	plist->set<std::string>("Source Sampling Type", "Stratified");
+	plist->set<double>("Sample Ratio", 10);
+	plist->set<int>( "History Length", history_length );
+	plist->set<int>( "Overlap Size", history_length + 1 );
+	solvers[s] = Teuchos::rcp( 
+	    new MCLS::MCSolver<SourceType>(comm, comm->getRank(), plist) );
+
+	x[s] = MT::cloneVectorFromMatrixRows( *A );
+	Teuchos::RCP<DomainType> domain = 
+	    Teuchos::rcp( new DomainType( A, x[s], *plist ) );
+	Teuchos::RCP<SourceType> source = Teuchos::rcp(
+	    new SourceType( b, domain, *plist ) );
+	solvers[s]->setDomain( domain );
+	solvers[s]->setSource( source );
+	solvers[s]->solve();
+	TEST_ASSERT( 1 == solvers[s]->numSolves() );
+
+	// Keep the first solution and solve again with the first solver.
+	if ( 0 == s )
+	{
+	    x[2] = VT::clone( *x[0] );
+	    VT::update( *x[2], 0.0, *x[0], 1.0 );
+	    solvers[s]->setSource( source );
+	    solvers[s]->solve();
+	    TEST_ASSERT( 2 == solvers[s]->numSolves() );
+	}
+    }
+
+    // The first solve of both solvers matches and the second solve of the
+    // first solver draws different random walks.
+    Teuchos::ArrayRCP<const double> first_view = VT::view( *x[2] );
+    Teuchos::ArrayRCP<const double> second_view = VT::view( *x[0] );
+    Teuchos::ArrayRCP<const double> repeat_view = VT::view( *x[1] );
+    int local_num_diff = 0;
+    for ( int i = 0; i < first_view.size(); ++i )
+    {
+	TEST_FLOATING_EQUALITY( repeat_view[i], first_view[i], 1.0e-12 );
+	if ( first_view[i] != second_view[i] )
+	{
+	    ++local_num_diff;
+	}
+    }
+    int global_num_diff = 0;
+    Teuchos::reduceAll<int,int>( *comm, Teuchos::REDUCE_SUM, local_num_diff,
+				 Teuchos::outArg(global_num_diff) );
+    TEST_ASSERT( global_num_diff > 0 );
+}
+
+//---------------------------------------------------------------------------//
+#if HAVE_MCLS_OPENMP
+TEUCHOS_UNIT_TEST( MCSolver, solve_threaded )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::Philox rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+    typedef MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType> DomainType;
+    typedef MCLS::UniformAdjointSource<DomainType> SourceType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build the linear system. This operator is symmetric with a spectral
+    // radius less than 1.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> global_columns( 3 );
+    Teuchos::Array<double> values( 3 );
+    global_columns[0] = 0;
+    global_columns[1] = 1;
+    global_columns[2] = 2;
+    values[0] = 1.0/comm_size;
+    values[1] = -0.14/comm_size;
+    values[2] = 0.0/comm_size;
+    A->insertGlobalValues( 0, global_columns(), values() );
+    for ( int i = 1; i < global_num_rows-1; ++i )
+    {
+	global_columns[0] = i-1;
+	global_columns[1] = i;
+	global_columns[2] = i+1;
+	values[0] = -0.14/comm_size;
+	values[1] = 1.0/comm_size;
+	values[2] = -0.14/comm_size;
+	A->insertGlobalValues( i, global_columns(), values() );
+    }
+    global_columns[0] = global_num_rows-3;
+    global_columns[1] = global_num_rows-2;
+    global_columns[2] = global_num_rows-1;
+    values[0] = 0.0/comm_size;
+    values[1] = -0.14/comm_size;
+    values[2] = 1.0/comm_size;
+    A->insertGlobalValues( global_num_rows-1, global_columns(), values() );
+    A->fillComplete();
+
+    Teuchos::RCP<VectorType> b = MT::cloneVectorFromMatrixRows( *A );
+    VT::putScalar( *b, -2.0 );
+
+    // Solve with a single thread and then with several threads pulling
+    // batches of histories from the source and the bank. The thread count
+    // is set before the solver, domain, and source are built as they size
+    // their thread streams and tally buffers with the maximum thread count.
+    // In reproducible mode every history draws the same random walk on any
+    // thread such that the threaded solution matches the serial solution to
+    // round-off. Otherwise the random walks differ and the solutions must
+    // match within statistical tolerance.
+    int max_threads = MCLS::ThreadTools::maxThreads();
+    Teuchos::Array<int> num_threads( 2 );
+    num_threads[0] = 1;
+    num_threads[1] = 4;
+    Teuchos::Array<int> batch_sizes( 2 );
+    batch_sizes[0] = 1;
+    batch_sizes[1] = 8;
+    Teuchos::Array<double> tolerances( 2 );
+    tolerances[0] = 1.0e-12;
+    tolerances[1] = 0.05;
+    for ( int r = 0; r < 2; ++r )
+    {
+	Teuchos::Array<Teuchos::RCP<VectorType> > x( 2 );
+	for ( int t = 0; t < 2; ++t )
+	{
+	    omp_set_num_threads( num_threads[t] );
+	    TEST_EQUALITY( MCLS::ThreadTools::maxThreads(), num_threads[t] );
+
+	    Teuchos::RCP<Teuchos::ParameterList> plist = 
+		Teuchos::rcp( new Teuchos::ParameterList() );
+	    plist->set<int>("MC Check Frequency", 10);
+	    plist->set<bool>("Reproducible MC Mode", (0 == r) );
+	    plist->set<int>("Random Number Seed", 433494437);
+	    plist->set<std::string>("Source Sampling Type", "Stratified");
+	    plist->set<double>("Sample Ratio", 1000);
+	    plist->set<int>("History Length", 10);
+	    plist->set<int>("History Batch Size", batch_sizes[t]);
+	    MCLS::MCSolver<SourceType> solver( comm, comm->getRank(), plist );
+
+	    x[t] = MT::cloneVectorFromMatrixRows( *A );
+	    Teuchos::RCP<DomainType> domain = 
+		Teuchos::rcp( new DomainType( A, x[t], *plist ) );
+	    Teuchos::RCP<SourceType> source = Teuchos::rcp(
+		new SourceType( b, domain, *plist ) );
+	    solver.setDomain( domain );
+	    solver.setSource( source );
+	    solver.solve();
+	}
+	omp_set_num_threads( max_threads );
+
+	Teuchos::ArrayRCP<const double> serial_view = VT::view( *x[0] );
+	Teuchos::ArrayRCP<const double> threaded_view = VT::view( *x[1] );
+	TEST_EQUALITY( threaded_view.size(), serial_view.size() );
+	for ( int i = 0; i < serial_view.size(); ++i )
+	{
+	    TEST_ASSERT( threaded_view[i] < Teuchos::ScalarTraits<double>::zero() );
+	    TEST_FLOATING_EQUALITY( threaded_view[i], serial_view[i], 
+				    tolerances[r] );
+	}
+    }
+}
+#endif
+
 //---------------------------------------------------------------------------//
 // end tstTpetraMCSolver.cpp
 //---------------------------------------------------------------------------//
@@ -608,6 +608,115 @@ TEUCHOS_UNIT_TEST( MonteCarloSolverManager, forward_prec )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( MonteCarloSolverManager, relative_error )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+    
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build the linear system. This operator is symmetric with a spectral
+    // radius less than 1.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> global_columns( 3 );
+    Teuchos::Array<double> values( 3 );
+    global_columns[0] = 0;
+    global_columns[1] = 1;
+    global_columns[2] = 2;
+    values[0] = 1.0/comm_size;
+    values[1] = -0.14/comm_size;
+    values[2] = 0.0/comm_size;
+    A->insertGlobalValues( 0, global_columns(), values() );
+    for ( int i = 1; i < global_num_rows-1; ++i )
+    {
+	global_columns[0] = i-1;
+	global_columns[1] = i;
+	global_columns[2] = i+1;
+	values[0] = -0.14/comm_size;
+	values[1] = 1.0/comm_size;
+	values[2] = -0.14/comm_size;
+	A->insertGlobalValues( i, global_columns(), values() );
+    }
+    global_columns[0] = global_num_rows-3;
+    global_columns[1] = global_num_rows-2;
+    global_columns[2] = global_num_rows-1;
+    values[0] = 0.0/comm_size;
+    values[1] = -0.14/comm_size;
+    values[2] = 1.0/comm_size;
+    A->insertGlobalValues( global_num_rows-1, global_columns(), values() );
+    A->fillComplete();
+
+    // Build the LHS. Put a large positive number here to be sure we are
+    // clear the vector before solving.
+    Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+    VT::putScalar( *x, 100.0 );
+
+    // Build the RHS with negative numbers. this gives us a negative
+    // solution. 
+    Teuchos::RCP<VectorType> b = MT::cloneVectorFromMatrixRows( *A );
+    VT::putScalar( *b, -1.0 );
+
+    // Solver parameters. Estimate the relative error of each solve.
+    Teuchos::RCP<Teuchos::ParameterList> plist = 
+	Teuchos::rcp( new Teuchos::ParameterList() );
+    plist->set<int>("MC Check Frequency", 10);
+    plist->set<double>("Sample Ratio",10.0);
+    plist->set<std::string>("Transport Type", "Global" );
+    plist->set<bool>("Estimate Relative Error", true);
+
+    // Create the linear problem.
+    Teuchos::RCP<MCLS::LinearProblem<VectorType,MatrixType> > linear_problem =
+	Teuchos::rcp( new MCLS::LinearProblem<VectorType,MatrixType>(
+			  A, x, b ) );
+
+    // The forward tally estimates its variance from the history scores.
+    MCLS::MonteCarloSolverManager<VectorType,MatrixType,MCLS::ForwardTag,std::mt19937> 
+	forward_manager( linear_problem, plist, comm_rank );
+    TEST_EQUALITY( forward_manager.relativeErrorNorm(), -1.0 );
+    TEST_ASSERT( forward_manager.solve() );
+    double forward_error = forward_manager.relativeErrorNorm();
+    TEST_ASSERT( forward_error > 0.0 );
+    TEST_ASSERT( forward_error < 1.0 );
+
+    // More histories give a smaller error.
+    plist->set<double>("Sample Ratio",40.0);
+    TEST_ASSERT( forward_manager.solve() );
+    TEST_ASSERT( forward_manager.relativeErrorNorm() > 0.0 );
+    TEST_ASSERT( forward_manager.relativeErrorNorm() < forward_error );
+
+    // The adjoint tally estimates its variance by batch means.
+    plist->set<double>("Sample Ratio",10.0);
+    plist->set<int>("Variance Batches", 8);
+    MCLS::MonteCarloSolverManager<VectorType,MatrixType,MCLS::AdjointTag,std::mt19937> 
+	adjoint_manager( linear_problem, plist, comm_rank );
+    TEST_ASSERT( adjoint_manager.solve() );
+    double adjoint_error = adjoint_manager.relativeErrorNorm();
+    TEST_ASSERT( adjoint_error > 0.0 );
+    TEST_ASSERT( adjoint_error < 1.0 );
+
+    // More histories give a smaller error.
+    plist->set<double>("Sample Ratio",40.0);
+    TEST_ASSERT( adjoint_manager.solve() );
+    TEST_ASSERT( adjoint_manager.relativeErrorNorm() > 0.0 );
+    TEST_ASSERT( adjoint_manager.relativeErrorNorm() < adjoint_error );
+
+    // Without batches the adjoint tally cannot estimate its variance.
+    plist->set<bool>("Estimate Relative Error", false);
+    TEST_ASSERT( adjoint_manager.solve() );
+    TEST_ASSERT( adjoint_manager.relativeErrorNorm() < 0.0 );
+}
+
 //---------------------------------------------------------------------------//
 // end tstTpetraMonteCarloSolverManager.cpp
 //---------------------------------------------------------------------------//
@@ -69,6 +69,8 @@
 #include <Teuchos_ArrayView.hpp>
 #include <Teuchos_TypeTraits.hpp>
 #include <Teuchos_ParameterList.hpp>
+#include <Teuchos_OrdinalTraits.hpp>
+#include <Teuchos_as.hpp>
 
 #include <Tpetra_Map.hpp>
 #include <Tpetra_Vector.hpp>
@@ -168,6 +170,196 @@ TEUCHOS_UNIT_TEST( SourceTransporter, transport )
     }
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SourceTransporter, termination_tree )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef std::mt19937 rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+    typedef MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType>
+	DomainType;
+    typedef MCLS::UniformAdjointSource<DomainType> SourceType;
+    typedef MCLS::SourceTransporter<SourceType> TransporterType;
+
+    // Check the tree for several widths and communicator sizes. Every rank
+    // but the master must be the child of its parent, the children of a rank
+    // must have that rank as their parent, and every rank must reach the
+    // master through its parents.
+    int invalid = Teuchos::OrdinalTraits<int>::invalid();
+    for ( int width = 1; width <= 5; ++width )
+    {
+	for ( int size = 1; size <= 17; ++size )
+	{
+	    int num_children = 0;
+	    for ( int rank = 0; rank < size; ++rank )
+	    {
+		int parent = TransporterType::treeParent( rank, width );
+		if ( 0 == rank )
+		{
+		    TEST_EQUALITY( parent, invalid );
+		}
+		else
+		{
+		    TEST_ASSERT( parent >= 0 && parent < rank );
+		    Teuchos::Array<int> siblings = 
+			TransporterType::treeChildren( parent, size, width );
+		    TEST_EQUALITY( std::count(siblings.begin(), 
+					      siblings.end(), rank), 1 );
+		}
+
+		Teuchos::Array<int> children = 
+		    TransporterType::treeChildren( rank, size, width );
+		TEST_ASSERT( Teuchos::as<int>(children.size()) <= width );
+		for ( int c = 0; c < children.size(); ++c )
+		{
+		    TEST_ASSERT( children[c] < size );
+		    TEST_EQUALITY( 
+			TransporterType::treeParent(children[c],width), rank );
+		}
+		num_children += children.size();
+
+		int ancestor = rank;
+		int depth = 0;
+		while ( ancestor != 0 && depth < size )
+		{
+		    ancestor = TransporterType::treeParent( ancestor, width );
+		    ++depth;
+		}
+		TEST_EQUALITY( ancestor, 0 );
+	    }
+	    TEST_EQUALITY( num_children, size - 1 );
+	}
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( SourceTransporter, uneven_termination )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::AdjointHistory<long> HistoryType;
+    typedef std::mt19937 rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+    typedef MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType>
+	DomainType;
+    typedef MCLS::UniformAdjointSource<DomainType> SourceType;
+    typedef MCLS::SourceTransporter<SourceType> TransporterType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+    int comm_rank = comm->getRank();
+
+    // Give each proc a different number of rows such that each proc starts
+    // a different number of histories.
+    int local_num_rows = 2 + 4*comm_rank;
+    int global_num_rows = 0;
+    Teuchos::reduceAll<int,int>( *comm, Teuchos::REDUCE_SUM, local_num_rows,
+				 Teuchos::outArg(global_num_rows) );
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createContigMap<int,long>( 
+	    global_num_rows, local_num_rows, comm );
+
+    // Build the linear system. This operator is symmetric with a spectral
+    // radius less than 1.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> global_columns( 3 );
+    Teuchos::Array<double> values( 3 );
+    values[0] = -0.12;
+    values[1] = 1.0;
+    values[2] = -0.12;
+    long row_begin = map->getMinGlobalIndex();
+    for ( long i = row_begin; i < row_begin + local_num_rows; ++i )
+    {
+	global_columns[0] = i-1;
+	global_columns[1] = i;
+	global_columns[2] = i+1;
+	if ( 0 == i )
+	{
+	    A->insertGlobalValues( i, global_columns(1,2), values(1,2) );
+	}
+	else if ( global_num_rows - 1 == i )
+	{
+	    A->insertGlobalValues( i, global_columns(0,2), values(0,2) );
+	}
+	else
+	{
+	    A->insertGlobalValues( i, global_columns(), values() );
+	}
+    }
+    A->fillComplete();
+    Teuchos::RCP<MatrixType> A_T = MT::copyTranspose(*A);
+
+    Teuchos::RCP<VectorType> b = MT::cloneVectorFromMatrixRows( *A );
+    VT::putScalar( *b, -1.0 );
+
+    // History setup.
+    HistoryType::setByteSize();
+
+    // Transport with several tree widths. The widest tree is flat.
+    Teuchos::Array<int> widths( 4 );
+    widths[0] = 1;
+    widths[1] = 2;
+    widths[2] = 3;
+    widths[3] = std::max( comm_size - 1, 1 );
+    for ( int w = 0; w < widths.size(); ++w )
+    {
+	Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+	VT::putScalar( *x, 0.0 );
+
+	// Build the adjoint domain.
+	Teuchos::ParameterList plist;
+	Teuchos::RCP<DomainType> domain = 
+	    Teuchos::rcp( new DomainType( A_T, x, plist ) );
+	Teuchos::RCP<MCLS::PRNG<rng_type> > rng = Teuchos::rcp(
+	    new MCLS::PRNG<rng_type>( comm->getRank() ) );
+	domain->setRNG( rng );
+
+	// Create the adjoint source with a set number of histories.
+	plist.set<double>("Sample Ratio",100);
+	Teuchos::RCP<SourceType> source = Teuchos::rcp(
+	    new SourceType( b, domain, plist ) );
+	source->setRNG( rng );
+	source->buildSource();
+	int num_in_set = source->numToTransportInSet();
+
+	// Create the source transporter.
+	plist.set<int>("MC Check Frequency", 3);
+	plist.set<int>("MC Termination Tree Width", widths[w]);
+	TransporterType source_transporter( comm, domain, plist );
+	source_transporter.assignSource( source );
+	TEST_EQUALITY( source_transporter.parent(),
+		       TransporterType::treeParent(comm_rank, widths[w]) );
+	TEST_ASSERT( source_transporter.children() == 
+		     TransporterType::treeChildren(
+			 comm_rank, comm_size, widths[w]) );
+
+	// Do transport.
+	source_transporter.transport();
+
+	// Check that every history in the set was completed.
+	long local_completed = source_transporter.numCompletedHistories();
+	long global_completed = 0;
+	Teuchos::reduceAll<int,long>( *comm, Teuchos::REDUCE_SUM, 
+				      local_completed,
+				      Teuchos::outArg(global_completed) );
+	TEST_EQUALITY( global_completed, num_in_set );
+
+	// Check that we got a negative solution.
+	Teuchos::ArrayRCP<const double> x_view = VT::view( *x );
+	typename Teuchos::ArrayRCP<const double>::const_iterator x_view_it;
+	for ( x_view_it = x_view.begin(); 
+	      x_view_it != x_view.end(); 
+	      ++x_view_it )
+	{
+	    TEST_ASSERT( *x_view_it < Teuchos::ScalarTraits<double>::zero() );
+	}
+    }
+}
+
 //---------------------------------------------------------------------------//
 // end tstTpetraSourceTransporter.cpp
 //---------------------------------------------------------------------------//
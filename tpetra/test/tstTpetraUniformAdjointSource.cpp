@@ -250,6 +250,85 @@ TEUCHOS_UNIT_TEST( UniformAdjointSource, nh_set )
     TEST_EQUALITY( source.numEmitted(), mult*local_num_rows );
 }
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST( UniformAdjointSource, rebuild )
+{
+    typedef Tpetra::Vector<double,int,long> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+    typedef Tpetra::CrsMatrix<double,int,long> MatrixType;
+    typedef MCLS::MatrixTraits<VectorType,MatrixType> MT;
+    typedef MCLS::AdjointHistory<long> HistoryType;
+    typedef std::mt19937 rng_type;
+    typedef MCLS::AdjointTally<VectorType> TallyType;
+    typedef MCLS::AlmostOptimalDomain<VectorType,MatrixType,rng_type,TallyType>
+	DomainType;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<int,long> > map = 
+	Tpetra::createUniformContigMap<int,long>( global_num_rows, comm );
+
+    // Build the linear system.
+    Teuchos::RCP<MatrixType> A = Tpetra::createCrsMatrix<double,int,long>( map );
+    Teuchos::Array<long> global_columns( 1 );
+    Teuchos::Array<double> values( 1 );
+    for ( int i = 1; i < global_num_rows; ++i )
+    {
+	global_columns[0] = i-1;
+	values[0] = -0.5/comm_size;
+	A->insertGlobalValues( i, global_columns(), values() );
+    }
+    global_columns[0] = global_num_rows-1;
+    values[0] = -0.5/comm_size;
+    A->insertGlobalValues( global_num_rows-1, global_columns(), values() );
+    A->fillComplete();
+
+    Teuchos::RCP<MatrixType> A_T = MT::copyTranspose(*A);
+    Teuchos::RCP<VectorType> x = MT::cloneVectorFromMatrixRows( *A );
+    Teuchos::RCP<VectorType> b = MT::cloneVectorFromMatrixRows( *A );
+    VT::putScalar( *b, -1.0 );
+
+    // Build the adjoint domain.
+    Teuchos::ParameterList plist;
+    plist.set<std::string>( "Source Sampling Type", "Stratified" );
+    Teuchos::RCP<DomainType> domain = Teuchos::rcp( new DomainType( A_T, x, plist ) );
+
+    // History setup.
+    HistoryType::setByteSize();
+
+    // Create the adjoint source.
+    MCLS::UniformAdjointSource<DomainType> source( b, domain, plist );
+    Teuchos::RCP<MCLS::PRNG<rng_type> > rng = Teuchos::rcp(
+	new MCLS::PRNG<rng_type>(comm->getRank()) );
+    source.setRNG( rng );
+
+    // Build and sample the source twice, changing the source values in
+    // between. The second build must use the new values.
+    for ( int n = 1; n < 3; ++n )
+    {
+	source.buildSource();
+	TEST_EQUALITY( source.numToTransport(), local_num_rows );
+	TEST_EQUALITY( source.numToTransportInSet(), global_num_rows );
+	TEST_EQUALITY( source.numLeft(), local_num_rows );
+	TEST_EQUALITY( source.numEmitted(), 0 );
+	TEST_EQUALITY( source.sourceWeight(), VT::norm1(*b) );
+
+	for ( int i = 0; i < local_num_rows; ++i )
+	{
+	    HistoryType history = source.getHistory();
+	    TEST_EQUALITY( history.weight(), -n*global_num_rows );
+	    TEST_ASSERT( VT::isGlobalRow( *x, history.globalState() ) );
+	}
+	TEST_ASSERT( source.empty() );
+
+	VT::putScalar( *b, -(n+1.0) );
+    }
+}
+
 //---------------------------------------------------------------------------//
 // end tstTpetraUniformAdjointSource.cpp
 //---------------------------------------------------------------------------//
@@ -661,6 +661,73 @@ TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( VectorTraits, ElementWiseMultiply, LO, GO, Sc
 
 UNIT_TEST_INSTANTIATION( VectorTraits, ElementWiseMultiply )
 
+//---------------------------------------------------------------------------//
+TEUCHOS_UNIT_TEST_TEMPLATE_3_DECL( VectorTraits, FusedUpdates, LO, GO, Scalar )
+{
+    typedef Tpetra::Vector<Scalar,LO,GO> VectorType;
+    typedef MCLS::VectorTraits<VectorType> VT;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = 
+	Teuchos::DefaultComm<int>::getComm();
+    int comm_size = comm->getSize();
+
+    int local_num_rows = 10;
+    int global_num_rows = local_num_rows*comm_size;
+    Teuchos::RCP<const Tpetra::Map<LO,GO> > map = 
+	Tpetra::createUniformContigMap<LO,GO>( global_num_rows, comm );
+
+    Teuchos::RCP<VectorType> A = Tpetra::createVector<Scalar,LO,GO>( map );
+    VT::putScalar( *A, 1.0 );
+
+    Teuchos::RCP<VectorType> B = VT::clone( *A );
+    VT::putScalar( *B, 2.0 );
+
+    Teuchos::RCP<VectorType> C = VT::clone( *A );
+    VT::putScalar( *C, 3.0 );
+
+    // Dot products.
+    Scalar A_dot_B = 0.0;
+    Scalar A_dot_C = 0.0;
+    VT::dotPair( *A, *B, *C, A_dot_B, A_dot_C );
+    TEST_EQUALITY( A_dot_B, VT::dot(*A,*B) );
+    TEST_EQUALITY( A_dot_C, VT::dot(*A,*C) );
+
+    // Paired update.
+    Scalar alpha = 4.0;
+    VT::updatePair( *A, *B, *C, alpha );
+    Teuchos::ArrayRCP<const Scalar> A_view = VT::view( *A );
+    Teuchos::ArrayRCP<const Scalar> B_view = VT::view( *B );
+    for ( int i = 0; i < local_num_rows; ++i )
+    {
+	TEST_EQUALITY( A_view[i], 1.0 + alpha*2.0 );
+	TEST_EQUALITY( B_view[i], 2.0 - alpha*3.0 );
+    }
+
+    // Update with norm.
+    Scalar beta = 5.0;
+    Scalar update_val = alpha*(1.0 + alpha*2.0) + beta*(2.0 - alpha*3.0);
+    Scalar norm = VT::updateNorm2( *A, alpha, *B, beta );
+    for ( int i = 0; i < local_num_rows; ++i )
+    {
+	TEST_EQUALITY( A_view[i], update_val );
+    }
+    TEST_FLOATING_EQUALITY( norm, VT::norm2(*A), 1.0e-14 );
+
+    // Local squared norm.
+    TEST_FLOATING_EQUALITY( VT::localNorm2Squared(*A), 
+			    local_num_rows * update_val * update_val, 1.0e-14 );
+
+    // Sum and squared norm.
+    Scalar C_sum = 0.0;
+    Scalar B_norm_squared = 0.0;
+    VT::sumAndNorm2Squared( *C, *B, C_sum, B_norm_squared );
+    TEST_FLOATING_EQUALITY( C_sum, 3.0*global_num_rows, 1.0e-14 );
+    TEST_FLOATING_EQUALITY( B_norm_squared, 
+			    VT::norm2(*B)*VT::norm2(*B), 1.0e-14 );
+}
+
+UNIT_TEST_INSTANTIATION( VectorTraits, FusedUpdates )
+
 //---------------------------------------------------------------------------//
 // end tstTpetraVector.cpp
 //---------------------------------------------------------------------------//